@@ -4,6 +4,8 @@
 #include "window-basic-main.hpp"
 #include "window-basic-main-outputs.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 
 using namespace std;
@@ -583,6 +585,23 @@ struct OBSStudioAPI : obs_frontend_callbacks {
 
 	char *obs_frontend_get_last_replay(void) override { return bstrdup(main->lastReplay.c_str()); }
 
+	bool obs_frontend_get_stats(struct obs_frontend_stats *stats) override
+	{
+		if (!main->statsCollector)
+			return false;
+
+		std::shared_ptr<const obs_frontend_stats> snapshot = main->statsCollector->GetSnapshot();
+		if (!snapshot)
+			return false;
+
+		/* only fill in the fields the caller's version of the struct has,
+		 * and tell it which ones those are */
+		size_t size = std::min(stats->size, snapshot->size);
+		memcpy(stats, snapshot.get(), size);
+		stats->size = size;
+		return true;
+	}
+
 	void obs_frontend_add_undo_redo_action(const char *name, const undo_redo_cb undo, const undo_redo_cb redo,
 					       const char *undo_data, const char *redo_data, bool repeatable) override
 	{
@@ -48,6 +48,8 @@ target_sources(
     hotkey-edit.hpp
     item-widget-helpers.cpp
     item-widget-helpers.hpp
+    log-file-view.cpp
+    log-file-view.hpp
     log-viewer.cpp
     log-viewer.hpp
     media-controls.cpp
@@ -60,6 +62,8 @@ target_sources(
     preview-controls.hpp
     remote-text.cpp
     remote-text.hpp
+    saved-source-cache.cpp
+    saved-source-cache.hpp
     scene-tree.cpp
     scene-tree.hpp
     screenshot-obj.hpp
@@ -67,6 +71,10 @@ target_sources(
     source-label.hpp
     source-tree.cpp
     source-tree.hpp
+    stats-collector.cpp
+    stats-collector.hpp
+    undo-data-diff.cpp
+    undo-data-diff.hpp
     undo-stack-obs.cpp
     undo-stack-obs.hpp
     url-push-button.cpp
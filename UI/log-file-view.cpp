@@ -0,0 +1,334 @@
+#include <QClipboard>
+#include <QContextMenuEvent>
+#include <QFontDatabase>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <algorithm>
+#include <climits>
+#include <string.h>
+
+#include "obs-app.hpp"
+#include "moc_log-file-view.cpp"
+
+/* amount of the file indexed per event loop iteration */
+static constexpr qint64 indexChunkSize = 8 * 1024 * 1024;
+static constexpr int textMargin = 4;
+
+LogFileView::LogFileView(QWidget *parent) : QAbstractScrollArea(parent)
+{
+	const QFont fixedFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+
+	setStyleSheet(QString("font-family: %1; font-size: %2pt;")
+			      .arg(fixedFont.family(), QString::number(fixedFont.pointSize())));
+	setFocusPolicy(Qt::StrongFocus);
+
+	indexTimer.setSingleShot(true);
+	indexTimer.setInterval(0);
+	connect(&indexTimer, &QTimer::timeout, this, &LogFileView::IndexChunk);
+}
+
+LogFileView::~LogFileView()
+{
+	if (data)
+		file.unmap((uchar *)data);
+}
+
+bool LogFileView::Open(const QString &path)
+{
+	indexTimer.stop();
+	if (data)
+		file.unmap((uchar *)data);
+	file.close();
+
+	data = nullptr;
+	mappedSize = 0;
+	indexedSize = 0;
+	lineEnds.clear();
+	firstLine = 0;
+	longestLine = 0;
+	levels.clear();
+	ClearSelection();
+
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	Update();
+	return true;
+}
+
+void LogFileView::Remap()
+{
+	qint64 size = file.size();
+	if (size <= mappedSize)
+		return;
+
+	/* mapping the file again is cheap regardless of its size, only the
+	 * pages that are actually read get loaded */
+	uchar *newData = file.map(0, size);
+	if (!newData)
+		return;
+
+	if (data)
+		file.unmap((uchar *)data);
+	data = (const char *)newData;
+	mappedSize = size;
+}
+
+void LogFileView::Update()
+{
+	if (!file.isOpen())
+		return;
+
+	Remap();
+	if (indexedSize < mappedSize && !indexTimer.isActive())
+		IndexChunk();
+}
+
+void LogFileView::IndexChunk()
+{
+	const qint64 end = std::min(mappedSize, indexedSize + indexChunkSize);
+	const char *pos = data + indexedSize;
+	const char *chunkEnd = data + end;
+	qint64 lineStart = LineStart(lineEnds.size());
+
+	/* a line that isn't complete yet is left for the next chunk or
+	 * update, which continues scanning where this one stopped */
+	while (pos < chunkEnd) {
+		const char *newline = (const char *)memchr(pos, '\n', chunkEnd - pos);
+		if (!newline)
+			break;
+
+		qint64 offset = newline - data;
+		longestLine = std::max(longestLine, offset - lineStart);
+		lineEnds.push_back(offset);
+
+		lineStart = offset + 1;
+		pos = newline + 1;
+	}
+
+	indexedSize = end;
+
+	UpdateScrollBars();
+	viewport()->update();
+
+	if (indexedSize < mappedSize)
+		indexTimer.start();
+}
+
+QString LogFileView::LineText(size_t line) const
+{
+	qint64 start = LineStart(line);
+	qint64 end = lineEnds[line];
+
+	if (end > start && data[end - 1] == '\r')
+		end--;
+
+	return QString::fromUtf8(data + start, end - start);
+}
+
+int LogFileView::LineHeight() const
+{
+	return std::max(fontMetrics().lineSpacing(), 1);
+}
+
+int LogFileView::VisibleLines() const
+{
+	return std::max(viewport()->height() / LineHeight(), 1);
+}
+
+int LogFileView::LineAt(int y) const
+{
+	int row = verticalScrollBar()->value() + (y < 0 ? -1 : y / LineHeight());
+	return std::clamp(row, 0, std::max(LineCount() - 1, 0));
+}
+
+void LogFileView::UpdateScrollBars()
+{
+	QScrollBar *vbar = verticalScrollBar();
+	QScrollBar *hbar = horizontalScrollBar();
+	bool atBottom = vbar->value() == vbar->maximum();
+	int visible = VisibleLines();
+
+	vbar->setRange(0, std::max(LineCount() - visible, 0));
+	vbar->setPageStep(visible);
+	if (atBottom)
+		vbar->setValue(vbar->maximum());
+
+	/* lines are measured in bytes, which is exact enough for a fixed
+	 * width font and saves measuring every line */
+	int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('0'));
+	qint64 width = longestLine * charWidth + textMargin * 2;
+
+	hbar->setRange(0, (int)std::clamp<qint64>(width - viewport()->width(), 0, INT_MAX / 2));
+	hbar->setPageStep(viewport()->width());
+	hbar->setSingleStep(charWidth);
+}
+
+void LogFileView::paintEvent(QPaintEvent *)
+{
+	QPainter painter(viewport());
+	const QPalette &pal = palette();
+	const int lineHeight = LineHeight();
+	const int count = LineCount();
+	const int x = textMargin - horizontalScrollBar()->value();
+	const int width = viewport()->width() - x;
+	const qint64 selStart = std::min(selAnchor, selCursor);
+	const qint64 selEnd = std::max(selAnchor, selCursor);
+
+	int row = verticalScrollBar()->value();
+	for (int y = 0; row < count && y < viewport()->height(); row++, y += lineHeight) {
+		size_t line = firstLine + row;
+
+		if (selAnchor != -1 && (qint64)line >= selStart && (qint64)line <= selEnd) {
+			painter.fillRect(0, y, viewport()->width(), lineHeight, pal.highlight());
+			painter.setPen(pal.highlightedText().color());
+		} else {
+			switch (levels.value(LineStart(line), LOG_INFO)) {
+			case LOG_WARNING:
+				painter.setPen(QColor(0xc0, 0x80, 0x00));
+				break;
+			case LOG_ERROR:
+				painter.setPen(QColor(0xc0, 0x00, 0x00));
+				break;
+			default:
+				painter.setPen(pal.text().color());
+				break;
+			}
+		}
+
+		painter.drawText(QRect(x, y, width, lineHeight),
+				 Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine | Qt::TextExpandTabs,
+				 LineText(line));
+	}
+}
+
+void LogFileView::resizeEvent(QResizeEvent *event)
+{
+	QAbstractScrollArea::resizeEvent(event);
+	UpdateScrollBars();
+}
+
+void LogFileView::ClearSelection()
+{
+	selAnchor = -1;
+	selCursor = -1;
+}
+
+void LogFileView::SetCursorLine(int row, bool extend)
+{
+	if (!LineCount())
+		return;
+
+	selCursor = (qint64)(firstLine + row);
+	if (!extend || selAnchor == -1)
+		selAnchor = selCursor;
+
+	viewport()->update();
+}
+
+void LogFileView::mousePressEvent(QMouseEvent *event)
+{
+	if (event->button() == Qt::LeftButton) {
+		SetCursorLine(LineAt((int)event->position().y()), event->modifiers() & Qt::ShiftModifier);
+		return;
+	}
+
+	QAbstractScrollArea::mousePressEvent(event);
+}
+
+void LogFileView::mouseMoveEvent(QMouseEvent *event)
+{
+	if (!(event->buttons() & Qt::LeftButton)) {
+		QAbstractScrollArea::mouseMoveEvent(event);
+		return;
+	}
+
+	int y = (int)event->position().y();
+	if (y < 0)
+		verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+	else if (y >= viewport()->height())
+		verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+
+	SetCursorLine(LineAt(y), true);
+}
+
+void LogFileView::keyPressEvent(QKeyEvent *event)
+{
+	if (event->matches(QKeySequence::Copy))
+		Copy();
+	else if (event->matches(QKeySequence::SelectAll))
+		SelectAll();
+	else
+		QAbstractScrollArea::keyPressEvent(event);
+}
+
+void LogFileView::contextMenuEvent(QContextMenuEvent *event)
+{
+	QMenu menu(this);
+
+	QAction *copy = menu.addAction(QTStr("Copy"));
+	copy->setEnabled(selAnchor != -1);
+	connect(copy, &QAction::triggered, this, &LogFileView::Copy);
+
+	menu.exec(event->globalPos());
+}
+
+void LogFileView::Copy()
+{
+	if (selAnchor == -1)
+		return;
+
+	qint64 end = std::max(selAnchor, selCursor);
+	QString text;
+
+	for (qint64 line = std::min(selAnchor, selCursor); line <= end; line++) {
+		text += LineText((size_t)line);
+		text += '\n';
+	}
+
+	QGuiApplication::clipboard()->setText(text);
+}
+
+void LogFileView::SelectAll()
+{
+	if (!LineCount())
+		return;
+
+	selAnchor = (qint64)firstLine;
+	selCursor = (qint64)lineEnds.size() - 1;
+	viewport()->update();
+}
+
+void LogFileView::SetLineLevel(qint64 offset, int level)
+{
+	if (level > LOG_WARNING)
+		return;
+
+	levels.insert(offset, level);
+
+	/* the line may have been indexed before its level arrived */
+	if (offset < indexedSize)
+		viewport()->update();
+}
+
+void LogFileView::Clear()
+{
+	firstLine = lineEnds.size();
+
+	qint64 start = LineStart(firstLine);
+	for (auto it = levels.begin(); it != levels.end();) {
+		if (it.key() < start)
+			it = levels.erase(it);
+		else
+			++it;
+	}
+
+	ClearSelection();
+	UpdateScrollBars();
+	viewport()->update();
+}
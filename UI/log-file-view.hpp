@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QHash>
+#include <QTimer>
+
+#include <vector>
+
+/* Read-only view of a log file that may be hundreds of MB large.  The file is
+ * memory mapped and only the lines currently visible are ever converted and
+ * drawn.  The line index is built in chunks from the event loop, so opening
+ * a large log doesn't block the UI, and lines appended to the file later are
+ * picked up by Update without reloading anything. */
+class LogFileView : public QAbstractScrollArea {
+	Q_OBJECT
+
+	QFile file;
+	const char *data = nullptr;
+	qint64 mappedSize = 0;
+	qint64 indexedSize = 0;
+
+	/* offset of the newline ending each complete line */
+	std::vector<qint64> lineEnds;
+	size_t firstLine = 0;
+	qint64 longestLine = 0;
+
+	/* log levels of lines other than LOG_INFO, by line start offset */
+	QHash<qint64, int> levels;
+
+	QTimer indexTimer;
+
+	qint64 selAnchor = -1;
+	qint64 selCursor = -1;
+
+	qint64 LineStart(size_t line) const { return line ? lineEnds[line - 1] + 1 : 0; }
+	QString LineText(size_t line) const;
+	int LineCount() const { return (int)(lineEnds.size() - firstLine); }
+	int LineHeight() const;
+	int VisibleLines() const;
+	int LineAt(int y) const;
+
+	void Remap();
+	void IndexChunk();
+	void UpdateScrollBars();
+	void ClearSelection();
+	void SetCursorLine(int line, bool extend);
+
+private slots:
+	void Copy();
+	void SelectAll();
+
+protected:
+	virtual void paintEvent(QPaintEvent *event) override;
+	virtual void resizeEvent(QResizeEvent *event) override;
+	virtual void mousePressEvent(QMouseEvent *event) override;
+	virtual void mouseMoveEvent(QMouseEvent *event) override;
+	virtual void keyPressEvent(QKeyEvent *event) override;
+	virtual void contextMenuEvent(QContextMenuEvent *event) override;
+
+public:
+	explicit LogFileView(QWidget *parent = nullptr);
+	~LogFileView();
+
+	bool Open(const QString &path);
+
+	/* indexes anything appended to the file since the last update */
+	void Update();
+
+	void SetLineLevel(qint64 offset, int level);
+
+	/* hides all lines currently in the file */
+	void Clear();
+};
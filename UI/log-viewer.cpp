@@ -1,8 +1,3 @@
-#include <QFile>
-#include <QTextStream>
-#include <QScrollBar>
-#include <QFont>
-#include <QFontDatabase>
 #include <QPushButton>
 #include <QCheckBox>
 #include <QLayout>
@@ -19,6 +14,10 @@ OBSLogViewer::OBSLogViewer(QWidget *parent) : QDialog(parent), ui(new Ui::OBSLog
 
 	ui->setupUi(this);
 
+	updateTimer.setSingleShot(true);
+	updateTimer.setInterval(100);
+	connect(&updateTimer, &QTimer::timeout, ui->logView, &LogFileView::Update);
+
 	bool showLogViewerOnStartup = config_get_bool(App()->GetUserConfig(), "LogViewer", "ShowLogStartup");
 
 	ui->showStartup->setChecked(showLogViewerOnStartup);
@@ -56,62 +55,25 @@ void OBSLogViewer::InitLog()
 		path += App()->GetCurrentLog();
 	}
 
-	QFile file(QT_UTF8(path.c_str()));
-
-	if (file.open(QIODevice::ReadOnly)) {
-		QTextStream in(&file);
-
-		QTextDocument *doc = ui->textArea->document();
-		QTextCursor cursor(doc);
-		cursor.movePosition(QTextCursor::End);
-		cursor.beginEditBlock();
-		while (!in.atEnd()) {
-			QString line = in.readLine();
-			cursor.insertText(line);
-			cursor.insertBlock();
-		}
-		cursor.endEditBlock();
-
-		file.close();
-	}
-	QScrollBar *scroll = ui->textArea->verticalScrollBar();
-	scroll->setValue(scroll->maximum());
+	ui->logView->Open(QT_UTF8(path.c_str()));
 
 	obsLogViewer = this;
 }
 
-void OBSLogViewer::AddLine(int type, const QString &str)
+/* called for every line written to the log, with the offset it was written
+ * at.  new lines are read from the file itself, at most every 100ms. */
+void OBSLogViewer::AddLine(int type, qint64 offset)
 {
-	QString msg = str.toHtmlEscaped();
-
-	switch (type) {
-	case LOG_WARNING:
-		msg = QString("<font color=\"#c08000\">%1</font>").arg(msg);
-		break;
-	case LOG_ERROR:
-		msg = QString("<font color=\"#c00000\">%1</font>").arg(msg);
-		break;
-	default:
-		msg = QString("<font>%1</font>").arg(msg);
-		break;
-	}
-
-	QScrollBar *scroll = ui->textArea->verticalScrollBar();
-	bool bottomScrolled = scroll->value() >= scroll->maximum() - 10;
-
-	if (bottomScrolled)
-		scroll->setValue(scroll->maximum());
+	ui->logView->SetLineLevel(offset, type);
 
-	QTextDocument *doc = ui->textArea->document();
-	QTextCursor cursor(doc);
-	cursor.movePosition(QTextCursor::End);
-	cursor.beginEditBlock();
-	cursor.insertHtml(msg);
-	cursor.insertBlock();
-	cursor.endEditBlock();
+	if (!updateTimer.isActive())
+		updateTimer.start();
+}
 
-	if (bottomScrolled)
-		scroll->setValue(scroll->maximum());
+void OBSLogViewer::on_clearButton_clicked()
+{
+	ui->logView->Update();
+	ui->logView->Clear();
 }
 
 void OBSLogViewer::on_openButton_clicked()
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <QDialog>
-#include <QPlainTextEdit>
+#include <QTimer>
 #include "obs-app.hpp"
 
 #include "ui_OBSLogViewer.h"
@@ -10,12 +10,14 @@ class OBSLogViewer : public QDialog {
 	Q_OBJECT
 
 	std::unique_ptr<Ui::OBSLogViewer> ui;
+	QTimer updateTimer;
 
 	void InitLog();
 
 private slots:
-	void AddLine(int type, const QString &text);
+	void AddLine(int type, qint64 offset);
 	void on_openButton_clicked();
+	void on_clearButton_clicked();
 	void on_showStartup_clicked(bool checked);
 
 public:
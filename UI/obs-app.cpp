@@ -292,12 +292,15 @@ static void LogString(fstream &logFile, const char *timeString, char *str, int l
 	msg += str;
 
 	logfile_mutex.lock();
+	qint64 offset = logFile.tellp();
 	logFile << msg << endl;
 	logfile_mutex.unlock();
 
+	/* the log viewer reads new lines from the file, it only needs to know
+	 * where each line starts to color warnings and errors */
 	if (!!obsLogViewer)
 		QMetaObject::invokeMethod(obsLogViewer.data(), "AddLine", Qt::QueuedConnection, Q_ARG(int, log_level),
-					  Q_ARG(QString, QString(msg.c_str())));
+					  Q_ARG(qint64, offset));
 }
 
 static inline void LogStringChunk(fstream &logFile, char *str, int log_level)
@@ -431,6 +434,8 @@ bool OBSApp::InitGlobalConfigDefaults()
 	config_set_default_int(appConfig, "General", "InfoIncrement", -1);
 	config_set_default_string(appConfig, "General", "ProcessPriority", "Normal");
 	config_set_default_bool(appConfig, "General", "EnableAutoUpdates", true);
+	config_set_default_bool(appConfig, "General", "LazySourceCreation", false);
+	config_set_default_int(appConfig, "General", "StatsInterval", 2000);
 
 #if _WIN32
 	config_set_default_string(appConfig, "Video", "Renderer", "Direct3D 11");
@@ -1179,6 +1184,9 @@ static bool StartupOBS(const char *locale, profiler_name_store_t *store)
 {
 	char path[512];
 
+	if (GetAppConfigPath(path, sizeof(path), "obs-studio/effect_cache") > 0)
+		gs_effect_set_cache_path(path);
+
 	if (GetAppConfigPath(path, sizeof(path), "obs-studio/plugin_config") <= 0)
 		return false;
 
@@ -591,6 +591,14 @@ char *obs_frontend_get_last_replay(void)
 	return !!callbacks_valid() ? c->obs_frontend_get_last_replay() : nullptr;
 }
 
+bool obs_frontend_get_stats(struct obs_frontend_stats *stats)
+{
+	if (!stats || stats->size < offsetof(struct obs_frontend_stats, timestamp) + sizeof(stats->timestamp))
+		return false;
+
+	return !!callbacks_valid() ? c->obs_frontend_get_stats(stats) : false;
+}
+
 void obs_frontend_add_undo_redo_action(const char *name, const undo_redo_cb undo, const undo_redo_cb redo,
 				       const char *undo_data, const char *redo_data, bool repeatable)
 {
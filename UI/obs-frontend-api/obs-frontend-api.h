@@ -82,6 +82,34 @@ static inline void obs_frontend_source_list_free(struct obs_frontend_source_list
 
 #endif //!SWIG
 
+struct obs_frontend_output_stats {
+	bool active;
+	bool reconnecting;
+	uint64_t total_bytes;
+	int total_frames;
+	int dropped_frames;
+	double kbps;
+};
+
+/* set size to sizeof(struct obs_frontend_stats) before calling
+ * obs_frontend_get_stats, fields may be added to the end in later versions */
+struct obs_frontend_stats {
+	size_t size;
+	uint64_t timestamp;
+	double active_fps;
+	double target_fps;
+	double cpu_usage;
+	uint64_t memory_usage;
+	uint64_t free_disk_space;
+	uint64_t average_frame_time_ns;
+	uint32_t encoded_frames;
+	uint32_t skipped_frames;
+	uint32_t rendered_frames;
+	uint32_t lagged_frames;
+	struct obs_frontend_output_stats streaming;
+	struct obs_frontend_output_stats recording;
+};
+
 /* ------------------------------------------------------------------------- */
 
 /* NOTE: Functions that return char** string lists are a single allocation of
@@ -234,6 +262,8 @@ EXPORT char *obs_frontend_get_last_recording(void);
 EXPORT char *obs_frontend_get_last_screenshot(void);
 EXPORT char *obs_frontend_get_last_replay(void);
 
+EXPORT bool obs_frontend_get_stats(struct obs_frontend_stats *stats);
+
 typedef void (*undo_redo_cb)(const char *data);
 EXPORT void obs_frontend_add_undo_redo_action(const char *name, const undo_redo_cb undo, const undo_redo_cb redo,
 					      const char *undo_data, const char *redo_data, bool repeatable);
@@ -0,0 +1,60 @@
+#include "saved-source-cache.hpp"
+
+#include <vector>
+
+obs_data_array_t *SavedSourceCache::SaveSources(const filter_cb &filter)
+{
+	std::vector<std::string> order;
+	size_t reused = 0;
+
+	/* only let obs_save_sources_filtered save sources that changed */
+	auto check = [&](obs_source_t *source) {
+		if (!filter(source))
+			return false;
+
+		std::string uuid = obs_source_get_uuid(source);
+		long revision = obs_source_get_save_revision(source);
+		order.push_back(uuid);
+
+		auto it = entries.find(uuid);
+		if (it != entries.end() && it->second.revision == revision && it->second.data &&
+		    obs_weak_source_references_source(it->second.source, source)) {
+			reused++;
+			return false;
+		}
+
+		entries[uuid] = {OBSGetWeakRef(source), revision, nullptr};
+		return true;
+	};
+	using check_t = decltype(check);
+
+	OBSDataArrayAutoRelease saved = obs_save_sources_filtered(
+		[](void *data, obs_source_t *source) { return (*static_cast<check_t *>(data))(source); },
+		static_cast<void *>(&check));
+
+	const size_t count = obs_data_array_count(saved);
+	for (size_t i = 0; i < count; i++) {
+		OBSDataAutoRelease data = obs_data_array_item(saved, i);
+		auto it = entries.find(obs_data_get_string(data, "uuid"));
+		if (it != entries.end())
+			it->second.data = data.Get();
+	}
+
+	obs_data_array_t *array = obs_data_array_create();
+	for (const std::string &uuid : order) {
+		auto it = entries.find(uuid);
+		if (it != entries.end() && it->second.data)
+			obs_data_array_push_back(array, it->second.data);
+	}
+
+	for (auto it = entries.begin(); it != entries.end();) {
+		OBSSource source = OBSGetStrongRef(it->second.source);
+		if (!source || obs_source_removed(source))
+			it = entries.erase(it);
+		else
+			++it;
+	}
+
+	blog(LOG_DEBUG, "Saved %zu sources, reused saved data of %zu unchanged sources", count, reused);
+	return array;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <obs.hpp>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+/* Keeps the data of the last save of each source, so saving the scene
+ * collection only has to save sources whose save revision changed since
+ * (see obs_source_get_save_revision). */
+class SavedSourceCache {
+	struct Entry {
+		OBSWeakSource source;
+		long revision;
+		OBSData data;
+	};
+
+	std::unordered_map<std::string, Entry> entries;
+
+public:
+	typedef std::function<bool(obs_source_t *source)> filter_cb;
+
+	/* same as obs_save_sources_filtered, but reuses the saved data of
+	 * sources that haven't changed since the last call */
+	obs_data_array_t *SaveSources(const filter_cb &filter);
+
+	void Clear() { entries.clear(); }
+};
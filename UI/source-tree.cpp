@@ -168,111 +168,6 @@ void SourceTreeItem::paintEvent(QPaintEvent *event)
 	QWidget::paintEvent(event);
 }
 
-void SourceTreeItem::DisconnectSignals()
-{
-	sigs.clear();
-}
-
-void SourceTreeItem::Clear()
-{
-	DisconnectSignals();
-	sceneitem = nullptr;
-}
-
-void SourceTreeItem::ReconnectSignals()
-{
-	if (!sceneitem)
-		return;
-
-	DisconnectSignals();
-
-	/* --------------------------------------------------------- */
-
-	auto removeItem = [](void *data, calldata_t *cd) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-		obs_scene_t *curScene = (obs_scene_t *)calldata_ptr(cd, "scene");
-
-		if (curItem == this_->sceneitem) {
-			QMetaObject::invokeMethod(this_->tree, "Remove", Q_ARG(OBSSceneItem, curItem),
-						  Q_ARG(OBSScene, curScene));
-			curItem = nullptr;
-		}
-		if (!curItem)
-			QMetaObject::invokeMethod(this_, "Clear");
-	};
-
-	auto itemVisible = [](void *data, calldata_t *cd) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-		bool visible = calldata_bool(cd, "visible");
-
-		if (curItem == this_->sceneitem)
-			QMetaObject::invokeMethod(this_, "VisibilityChanged", Q_ARG(bool, visible));
-	};
-
-	auto itemLocked = [](void *data, calldata_t *cd) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-		bool locked = calldata_bool(cd, "locked");
-
-		if (curItem == this_->sceneitem)
-			QMetaObject::invokeMethod(this_, "LockedChanged", Q_ARG(bool, locked));
-	};
-
-	auto itemSelect = [](void *data, calldata_t *cd) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-
-		if (curItem == this_->sceneitem)
-			QMetaObject::invokeMethod(this_, "Select");
-	};
-
-	auto itemDeselect = [](void *data, calldata_t *cd) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		obs_sceneitem_t *curItem = (obs_sceneitem_t *)calldata_ptr(cd, "item");
-
-		if (curItem == this_->sceneitem)
-			QMetaObject::invokeMethod(this_, "Deselect");
-	};
-
-	auto reorderGroup = [](void *data, calldata_t *) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		QMetaObject::invokeMethod(this_->tree, "ReorderItems");
-	};
-
-	obs_scene_t *scene = obs_sceneitem_get_scene(sceneitem);
-	obs_source_t *sceneSource = obs_scene_get_source(scene);
-	signal_handler_t *signal = obs_source_get_signal_handler(sceneSource);
-
-	sigs.emplace_back(signal, "remove", removeItem, this);
-	sigs.emplace_back(signal, "item_remove", removeItem, this);
-	sigs.emplace_back(signal, "item_visible", itemVisible, this);
-	sigs.emplace_back(signal, "item_locked", itemLocked, this);
-	sigs.emplace_back(signal, "item_select", itemSelect, this);
-	sigs.emplace_back(signal, "item_deselect", itemDeselect, this);
-
-	if (obs_sceneitem_is_group(sceneitem)) {
-		obs_source_t *source = obs_sceneitem_get_source(sceneitem);
-		signal = obs_source_get_signal_handler(source);
-
-		sigs.emplace_back(signal, "reorder", reorderGroup, this);
-	}
-
-	/* --------------------------------------------------------- */
-
-	auto removeSource = [](void *data, calldata_t *) {
-		SourceTreeItem *this_ = reinterpret_cast<SourceTreeItem *>(data);
-		this_->DisconnectSignals();
-		this_->sceneitem = nullptr;
-		QMetaObject::invokeMethod(this_->tree, "RefreshItems");
-	};
-
-	obs_source_t *source = obs_sceneitem_get_source(sceneitem);
-	signal = obs_source_get_signal_handler(source);
-	sigs.emplace_back(signal, "remove", removeSource, this);
-}
-
 void SourceTreeItem::mouseDoubleClickEvent(QMouseEvent *event)
 {
 	QWidget::mouseDoubleClickEvent(event);
@@ -452,7 +347,6 @@ void SourceTreeItem::VisibilityChanged(bool visible)
 void SourceTreeItem::LockedChanged(bool locked)
 {
 	lock->setChecked(locked);
-	OBSBasic::Get()->UpdateEditMenu();
 }
 
 void SourceTreeItem::Update(bool force)
@@ -489,8 +383,6 @@ void SourceTreeItem::Update(bool force)
 
 	/* ------------------------------------------------- */
 
-	ReconnectSignals();
-
 	if (spacer) {
 		boxLayout->removeItem(spacer);
 		delete spacer;
@@ -542,20 +434,6 @@ void SourceTreeItem::ExpandClicked(bool checked)
 		tree->GetStm()->CollapseGroup(sceneitem);
 }
 
-void SourceTreeItem::Select()
-{
-	tree->SelectItem(sceneitem, true);
-	OBSBasic::Get()->UpdateContextBarDeferred();
-	OBSBasic::Get()->UpdateEditMenu();
-}
-
-void SourceTreeItem::Deselect()
-{
-	tree->SelectItem(sceneitem, false);
-	OBSBasic::Get()->UpdateContextBarDeferred();
-	OBSBasic::Get()->UpdateEditMenu();
-}
-
 /* ========================================================================= */
 
 void SourceTreeModel::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
@@ -568,6 +446,7 @@ void SourceTreeModel::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
 		break;
 	case OBS_FRONTEND_EVENT_EXIT:
 		stm->Clear();
+		stm->sourceRemoveSignal.Disconnect();
 		obs_frontend_remove_event_callback(OBSFrontendEvent, stm);
 		break;
 	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
@@ -584,9 +463,125 @@ void SourceTreeModel::Clear()
 	items.clear();
 	endResetModel();
 
+	sceneSignals.clear();
 	hasGroups = false;
 }
 
+void SourceTreeModel::ConnectSignals()
+{
+	sceneSignals.clear();
+
+	OBSScene scene = GetCurrentScene();
+	if (!scene)
+		return;
+
+	auto removeItem = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+		obs_scene_t *scene = (obs_scene_t *)calldata_ptr(cd, "scene");
+
+		QMetaObject::invokeMethod(stm->st, "Remove", Q_ARG(OBSSceneItem, item), Q_ARG(OBSScene, scene));
+	};
+
+	auto itemVisible = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+		bool visible = calldata_bool(cd, "visible");
+
+		QMetaObject::invokeMethod(stm, "ItemVisibilityChanged", Q_ARG(OBSSceneItem, item),
+					  Q_ARG(bool, visible));
+	};
+
+	auto itemLocked = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+		bool locked = calldata_bool(cd, "locked");
+
+		QMetaObject::invokeMethod(stm, "ItemLockedChanged", Q_ARG(OBSSceneItem, item), Q_ARG(bool, locked));
+	};
+
+	auto itemSelect = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+
+		QMetaObject::invokeMethod(stm, "ItemSelected", Q_ARG(OBSSceneItem, item), Q_ARG(bool, true));
+	};
+
+	auto itemDeselect = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_sceneitem_t *item = (obs_sceneitem_t *)calldata_ptr(cd, "item");
+
+		QMetaObject::invokeMethod(stm, "ItemSelected", Q_ARG(OBSSceneItem, item), Q_ARG(bool, false));
+	};
+
+	auto reorderGroup = [](void *data, calldata_t *) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		QMetaObject::invokeMethod(stm->st, "ReorderItems");
+	};
+
+	auto connectScene = [&](obs_source_t *source) {
+		signal_handler_t *signal = obs_source_get_signal_handler(source);
+
+		sceneSignals.emplace_back(signal, "item_remove", removeItem, this);
+		sceneSignals.emplace_back(signal, "item_visible", itemVisible, this);
+		sceneSignals.emplace_back(signal, "item_locked", itemLocked, this);
+		sceneSignals.emplace_back(signal, "item_select", itemSelect, this);
+		sceneSignals.emplace_back(signal, "item_deselect", itemDeselect, this);
+	};
+
+	connectScene(obs_scene_get_source(scene));
+
+	/* sub-items signal through the scene of their group */
+	for (auto &item : items) {
+		if (!obs_sceneitem_is_group(item))
+			continue;
+
+		obs_source_t *source = obs_sceneitem_get_source(item);
+		connectScene(source);
+		sceneSignals.emplace_back(obs_source_get_signal_handler(source), "reorder", reorderGroup, this);
+	}
+}
+
+void SourceTreeModel::ItemVisibilityChanged(OBSSceneItem item, bool visible)
+{
+	SourceTreeItem *widget = st->GetItemWidget(items.indexOf(item));
+	if (widget)
+		widget->VisibilityChanged(visible);
+}
+
+void SourceTreeModel::ItemLockedChanged(OBSSceneItem item, bool locked)
+{
+	int idx = items.indexOf(item);
+	if (idx == -1)
+		return;
+
+	SourceTreeItem *widget = st->GetItemWidget(idx);
+	if (widget)
+		widget->LockedChanged(locked);
+
+	OBSBasic::Get()->UpdateEditMenu();
+}
+
+void SourceTreeModel::ItemSelected(OBSSceneItem item, bool select)
+{
+	if (!items.contains(item))
+		return;
+
+	st->SelectItem(item, select);
+	OBSBasic::Get()->UpdateContextBarDeferred();
+	OBSBasic::Get()->UpdateEditMenu();
+}
+
+void SourceTreeModel::SourceRemoved(OBSSource source)
+{
+	for (auto &item : items) {
+		if (obs_sceneitem_get_source(item) == source) {
+			SceneChanged();
+			return;
+		}
+	}
+}
+
 static bool enumItem(obs_scene_t *, obs_sceneitem_t *item, void *ptr)
 {
 	QVector<OBSSceneItem> &items = *reinterpret_cast<QVector<OBSSceneItem> *>(ptr);
@@ -621,15 +616,25 @@ void SourceTreeModel::SceneChanged()
 	endResetModel();
 
 	UpdateGroupState(false);
+	ConnectSignals();
 	st->ResetWidgets();
 
-	for (int i = 0; i < items.count(); i++) {
-		bool select = obs_sceneitem_selected(items[i]);
-		QModelIndex index = createIndex(i, 0);
+	/* select runs of selected items at once, rather than item by item */
+	QItemSelection selection;
+	int start = -1;
 
-		st->selectionModel()->select(index,
-					     select ? QItemSelectionModel::Select : QItemSelectionModel::Deselect);
+	for (int i = 0; i <= items.count(); i++) {
+		bool select = i < items.count() && obs_sceneitem_selected(items[i]);
+
+		if (select && start == -1) {
+			start = i;
+		} else if (!select && start != -1) {
+			selection.select(createIndex(start, 0), createIndex(i - 1, 0));
+			start = -1;
+		}
 	}
+
+	st->selectionModel()->select(selection, QItemSelectionModel::Select);
 }
 
 /* moves a scene item index (blame linux distros for using older Qt builds) */
@@ -725,8 +730,6 @@ void SourceTreeModel::Add(obs_sceneitem_t *item)
 		beginInsertRows(QModelIndex(), 0, 0);
 		items.insert(0, item);
 		endInsertRows();
-
-		st->UpdateWidget(createIndex(0, 0, nullptr), item);
 	}
 }
 
@@ -765,8 +768,10 @@ void SourceTreeModel::Remove(obs_sceneitem_t *item)
 	items.remove(idx, endIdx - startIdx + 1);
 	endRemoveRows();
 
-	if (is_group)
+	if (is_group) {
 		UpdateGroupState(true);
+		ConnectSignals();
+	}
 
 	OBSBasic::Get()->UpdateContextBarDeferred();
 }
@@ -781,6 +786,15 @@ OBSSceneItem SourceTreeModel::Get(int idx)
 SourceTreeModel::SourceTreeModel(SourceTree *st_) : QAbstractListModel(st_), st(st_)
 {
 	obs_frontend_add_event_callback(OBSFrontendEvent, this);
+
+	auto removeSource = [](void *data, calldata_t *cd) {
+		SourceTreeModel *stm = reinterpret_cast<SourceTreeModel *>(data);
+		obs_source_t *source = (obs_source_t *)calldata_ptr(cd, "source");
+
+		QMetaObject::invokeMethod(stm, "SourceRemoved", Q_ARG(OBSSource, OBSSource(source)));
+	};
+
+	sourceRemoveSignal.Connect(obs_get_signal_handler(), "source_remove", removeSource, this);
 }
 
 int SourceTreeModel::rowCount(const QModelIndex &parent) const
@@ -843,8 +857,8 @@ void SourceTreeModel::AddGroup()
 	items.insert(0, group);
 	endInsertRows();
 
-	st->UpdateWidget(createIndex(0, 0, nullptr), group);
 	UpdateGroupState(true);
+	ConnectSignals();
 
 	QMetaObject::invokeMethod(st, "Edit", Qt::QueuedConnection, Q_ARG(int, 0));
 }
@@ -999,11 +1013,14 @@ SourceTree::SourceTree(QWidget *parent_) : QListView(parent_)
 	connect(App(), &OBSApp::StyleChanged, this, &SourceTree::UpdateIcons);
 
 	setItemDelegate(new SourceTreeDelegate(this));
+	setUniformItemSizes(true);
 }
 
 void SourceTree::UpdateIcons()
 {
 	SourceTreeModel *stm = GetStm();
+
+	rowHeight = 0;
 	stm->SceneChanged();
 }
 
@@ -1012,41 +1029,105 @@ void SourceTree::SetIconsVisible(bool visible)
 	SourceTreeModel *stm = GetStm();
 
 	iconsVisible = visible;
+	rowHeight = 0;
 	stm->SceneChanged();
 }
 
 void SourceTree::ResetWidgets()
 {
-	OBSScene scene = GetCurrentScene();
-
 	SourceTreeModel *stm = GetStm();
 	stm->UpdateGroupState(false);
 
-	for (int i = 0; i < stm->items.count(); i++) {
-		QModelIndex index = stm->createIndex(i, 0, nullptr);
-		setIndexWidget(index, new SourceTreeItem(this, stm->items[i]));
-	}
+	/* resetting the model already destroyed the widgets */
+	widgetIndices.clear();
+	doItemsLayout();
 }
 
 void SourceTree::UpdateWidget(const QModelIndex &idx, obs_sceneitem_t *item)
 {
 	setIndexWidget(idx, new SourceTreeItem(this, item));
+	widgetIndices.append(idx);
 }
 
 void SourceTree::UpdateWidgets(bool force)
+{
+	for (auto &index : widgetIndices) {
+		SourceTreeItem *widget = reinterpret_cast<SourceTreeItem *>(indexWidget(index));
+		if (widget)
+			widget->Update(force);
+	}
+}
+
+/* rows kept around the visible ones, so scrolling by a few rows doesn't
+ * always have to create new widgets */
+static constexpr int widgetOverscan = 8;
+
+void SourceTree::UpdateVisibleWidgets()
 {
 	SourceTreeModel *stm = GetStm();
+	int count = stm->items.count();
+	int first = 0;
+	int last = 0;
+
+	/* all rows have the height of the first item widget, which has to
+	 * exist before the visible rows can be known */
+	if (rowHeight) {
+		QModelIndex top = indexAt(QPoint(0, 0));
+		QModelIndex bottom = indexAt(QPoint(0, viewport()->height() - 1));
+
+		first = top.isValid() ? top.row() : 0;
+		last = bottom.isValid() ? bottom.row() : count - 1;
+	}
 
-	for (int i = 0; i < stm->items.size(); i++) {
-		obs_sceneitem_t *item = stm->items[i];
-		SourceTreeItem *widget = GetItemWidget(i);
+	first = std::max(first - widgetOverscan, 0);
+	last = std::min(last + widgetOverscan, count - 1);
 
-		if (!widget) {
-			UpdateWidget(stm->createIndex(i, 0), item);
-		} else {
-			widget->Update(force);
+	for (int i = widgetIndices.size() - 1; i >= 0; i--) {
+		const QPersistentModelIndex &index = widgetIndices[i];
+		int row = index.row();
+
+		if (index.isValid() && row >= first && row <= last)
+			continue;
+
+		if (index.isValid()) {
+			SourceTreeItem *widget = GetItemWidget(row);
+			if (widget && widget->IsEditing())
+				continue;
+
+			setIndexWidget(index, nullptr);
 		}
+
+		widgetIndices.removeAt(i);
 	}
+
+	for (int i = first; i <= last; i++) {
+		QModelIndex index = stm->createIndex(i, 0);
+		if (!indexWidget(index))
+			UpdateWidget(index, stm->items[i]);
+	}
+
+	if (!rowHeight && count) {
+		rowHeight = GetItemWidget(0)->sizeHint().height();
+		scheduleDelayedItemsLayout();
+	}
+}
+
+void SourceTree::doItemsLayout()
+{
+	QListView::doItemsLayout();
+	UpdateVisibleWidgets();
+}
+
+void SourceTree::resizeEvent(QResizeEvent *event)
+{
+	QListView::resizeEvent(event);
+	UpdateVisibleWidgets();
+}
+
+void SourceTree::scrollContentsBy(int dx, int dy)
+{
+	QListView::scrollContentsBy(dx, dy);
+	UpdateVisibleWidgets();
 }
 
 void SourceTree::SelectItem(obs_sceneitem_t *sceneitem, bool select)
@@ -1437,8 +1518,14 @@ bool SourceTree::Edit(int row)
 		return false;
 
 	QModelIndex index = stm->createIndex(row, 0);
-	QWidget *widget = indexWidget(index);
-	SourceTreeItem *itemWidget = reinterpret_cast<SourceTreeItem *>(widget);
+	scrollTo(index);
+
+	SourceTreeItem *itemWidget = GetItemWidget(row);
+	if (!itemWidget) {
+		UpdateWidget(index, stm->items[row]);
+		itemWidget = GetItemWidget(row);
+	}
+
 	if (itemWidget->IsEditing()) {
 #ifdef __APPLE__
 		itemWidget->ExitEditMode(true);
@@ -1523,6 +1610,9 @@ bool SourceTree::GroupedItemsSelected() const
 void SourceTree::Remove(OBSSceneItem item, OBSScene scene)
 {
 	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
+	if (!GetStm()->items.contains(item))
+		return;
+
 	GetStm()->Remove(item);
 	main->SaveProject();
 
@@ -1601,13 +1691,9 @@ void SourceTree::paintEvent(QPaintEvent *event)
 
 SourceTreeDelegate::SourceTreeDelegate(QObject *parent) : QStyledItemDelegate(parent) {}
 
-QSize SourceTreeDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+QSize SourceTreeDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
 {
 	SourceTree *tree = qobject_cast<SourceTree *>(parent());
-	QWidget *item = tree->indexWidget(index);
-
-	if (!item)
-		return (QSize(0, 0));
 
-	return (QSize(option.widget->minimumWidth(), item->height()));
+	return (QSize(option.widget->minimumWidth(), tree->rowHeight));
 }
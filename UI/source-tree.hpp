@@ -42,9 +42,6 @@ class SourceTreeItem : public QFrame {
 		SubItem,
 	};
 
-	void DisconnectSignals();
-	void ReconnectSignals();
-
 	Type type = Type::Unknown;
 
 public:
@@ -66,25 +63,19 @@ private:
 
 	SourceTree *tree;
 	OBSSceneItem sceneitem;
-	std::vector<OBSSignal> sigs;
 
 	virtual void paintEvent(QPaintEvent *event) override;
 
 	void ExitEditModeInternal(bool save);
 
-private slots:
-	void Clear();
+	void VisibilityChanged(bool visible);
+	void LockedChanged(bool locked);
 
+private slots:
 	void EnterEditMode();
 	void ExitEditMode(bool save);
 
-	void VisibilityChanged(bool visible);
-	void LockedChanged(bool locked);
-
 	void ExpandClicked(bool checked);
-
-	void Select();
-	void Deselect();
 };
 
 class SourceTreeModel : public QAbstractListModel {
@@ -97,10 +88,16 @@ class SourceTreeModel : public QAbstractListModel {
 	QVector<OBSSceneItem> items;
 	bool hasGroups = false;
 
+	/* the scene item signals of the current scene and its groups, shared
+	 * by all rows instead of being connected for every item */
+	std::vector<OBSSignal> sceneSignals;
+	OBSSignal sourceRemoveSignal;
+
 	static void OBSFrontendEvent(enum obs_frontend_event event, void *ptr);
 	void Clear();
 	void SceneChanged();
 	void ReorderItems();
+	void ConnectSignals();
 
 	void Add(obs_sceneitem_t *item);
 	void Remove(obs_sceneitem_t *item);
@@ -116,6 +113,12 @@ class SourceTreeModel : public QAbstractListModel {
 
 	void UpdateGroupState(bool update);
 
+private slots:
+	void ItemVisibilityChanged(OBSSceneItem item, bool visible);
+	void ItemLockedChanged(OBSSceneItem item, bool locked);
+	void ItemSelected(OBSSceneItem item, bool select);
+	void SourceRemoved(OBSSource source);
+
 public:
 	explicit SourceTreeModel(SourceTree *st);
 
@@ -133,6 +136,7 @@ class SourceTree : public QListView {
 
 	friend class SourceTreeModel;
 	friend class SourceTreeItem;
+	friend class SourceTreeDelegate;
 
 	bool textPrepared = false;
 	QStaticText textNoSources;
@@ -142,15 +146,22 @@ class SourceTree : public QListView {
 
 	bool iconsVisible = true;
 
+	/* item widgets only exist for the rows that are currently visible,
+	 * and are created and destroyed as the list scrolls */
+	QList<QPersistentModelIndex> widgetIndices;
+	int rowHeight = 0;
+
 	void UpdateNoSourcesMessage();
 
 	void ResetWidgets();
 	void UpdateWidget(const QModelIndex &idx, obs_sceneitem_t *item);
 	void UpdateWidgets(bool force = false);
+	void UpdateVisibleWidgets();
 
 	inline SourceTreeModel *GetStm() const { return reinterpret_cast<SourceTreeModel *>(model()); }
 
 public:
+	/* returns nullptr if the row isn't visible */
 	inline SourceTreeItem *GetItemWidget(int idx)
 	{
 		QWidget *widget = indexWidget(GetStm()->createIndex(idx, 0));
@@ -185,10 +196,15 @@ public slots:
 	bool Edit(int idx);
 	void NewGroupEdit(int idx);
 
+public:
+	virtual void doItemsLayout() override;
+
 protected:
 	virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
 	virtual void dropEvent(QDropEvent *event) override;
 	virtual void paintEvent(QPaintEvent *event) override;
+	virtual void resizeEvent(QResizeEvent *event) override;
+	virtual void scrollContentsBy(int dx, int dy) override;
 
 	virtual void selectionChanged(const QItemSelection &selected, const QItemSelection &deselected) override;
 };
@@ -0,0 +1,159 @@
+#include "moc_stats-collector.cpp"
+
+#include <util/threading.h>
+
+#include <algorithm>
+#include <chrono>
+
+#define MIN_INTERVAL 100
+
+StatsCollector::StatsCollector(int interval_) : interval(std::max(interval_, MIN_INTERVAL)) {}
+
+StatsCollector::~StatsCollector()
+{
+	Stop();
+}
+
+void StatsCollector::Start()
+{
+	if (thread.joinable())
+		return;
+
+	stopping = false;
+	thread = std::thread(&StatsCollector::Run, this);
+}
+
+void StatsCollector::Stop()
+{
+	if (!thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+
+	cv.notify_one();
+	thread.join();
+}
+
+void StatsCollector::SetInterval(int interval_)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		interval = std::max(interval_, MIN_INTERVAL);
+	}
+
+	cv.notify_one();
+}
+
+void StatsCollector::SetSources(const char *path, obs_output_t *stream, obs_output_t *record)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	outputPath = path ? path : "";
+	streamOutput = OBSGetWeakRef(stream);
+	recordOutput = OBSGetWeakRef(record);
+}
+
+void StatsCollector::Refresh()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		refresh = true;
+	}
+
+	cv.notify_one();
+}
+
+std::shared_ptr<const obs_frontend_stats> StatsCollector::GetSnapshot()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return snapshot;
+}
+
+void StatsCollector::Run()
+{
+	os_set_thread_name("stats collector");
+
+	cpuInfo = os_cpu_usage_info_start();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopping) {
+		lock.unlock();
+		Collect();
+		emit Updated();
+		lock.lock();
+
+		cv.wait_for(lock, std::chrono::milliseconds(interval), [this]() { return stopping || refresh; });
+		refresh = false;
+	}
+	lock.unlock();
+
+	os_cpu_usage_info_destroy(cpuInfo);
+	cpuInfo = nullptr;
+}
+
+static void CollectOutput(obs_output_t *output, obs_frontend_output_stats &stats, uint64_t time, uint64_t &lastBytes,
+			  uint64_t &lastTime)
+{
+	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
+	uint64_t bytesSent = totalBytes;
+
+	if (bytesSent < lastBytes)
+		bytesSent = 0;
+	if (bytesSent == 0)
+		lastBytes = 0;
+
+	uint64_t bitsBetween = (bytesSent - lastBytes) * 8;
+	double timePassed = (double)(time - lastTime) / 1000000000.0;
+
+	stats.kbps = timePassed < 0.01 ? 0.0 : (double)bitsBetween / timePassed / 1000.0;
+	stats.total_bytes = totalBytes;
+	stats.active = output ? obs_output_active(output) : false;
+	stats.reconnecting = output ? obs_output_reconnecting(output) : false;
+	stats.total_frames = output ? obs_output_get_total_frames(output) : 0;
+	stats.dropped_frames = output ? obs_output_get_frames_dropped(output) : 0;
+
+	lastBytes = bytesSent;
+	lastTime = time;
+}
+
+void StatsCollector::Collect()
+{
+	std::string path;
+	OBSOutput stream;
+	OBSOutput record;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		path = outputPath;
+		stream = OBSGetStrongRef(streamOutput);
+		record = OBSGetStrongRef(recordOutput);
+	}
+
+	auto stats = std::make_shared<obs_frontend_stats>();
+	struct obs_video_info ovi = {};
+	video_t *video = obs_get_video();
+
+	stats->size = sizeof(*stats);
+	stats->timestamp = os_gettime_ns();
+	stats->active_fps = obs_get_active_fps();
+	if (obs_get_video_info(&ovi) && ovi.fps_den)
+		stats->target_fps = (double)ovi.fps_num / (double)ovi.fps_den;
+
+	stats->cpu_usage = os_cpu_usage_info_query(cpuInfo);
+	stats->memory_usage = os_get_proc_resident_size();
+	stats->free_disk_space = path.empty() ? 0 : os_get_free_disk_space(path.c_str());
+	stats->average_frame_time_ns = obs_get_average_frame_time_ns();
+
+	stats->encoded_frames = video_output_get_total_frames(video);
+	stats->skipped_frames = video_output_get_skipped_frames(video);
+	stats->rendered_frames = obs_get_total_frames();
+	stats->lagged_frames = obs_get_lagged_frames();
+
+	CollectOutput(stream, stats->streaming, stats->timestamp, streamState.lastBytes, streamState.lastTime);
+	CollectOutput(record, stats->recording, stats->timestamp, recordState.lastBytes, recordState.lastTime);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	snapshot = std::move(stats);
+}
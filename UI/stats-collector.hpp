@@ -0,0 +1,69 @@
+#pragma once
+
+#include <obs.hpp>
+#include <obs-frontend-api.h>
+#include <util/platform.h>
+#include <QObject>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/* Gathers obs_frontend_stats snapshots on a thread of its own, because some
+ * of the queries (free disk space, output counters taking output locks) can
+ * block for a while, e.g. while an output is reconnecting.  Snapshots are
+ * never modified once published, so the UI and frontend plugins can keep
+ * using one for as long as they like. */
+class StatsCollector : public QObject {
+	Q_OBJECT
+
+	struct OutputState {
+		uint64_t lastBytes = 0;
+		uint64_t lastTime = 0;
+	};
+
+	std::thread thread;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool stopping = false;
+	bool refresh = false;
+	int interval;
+
+	/* set from the UI thread, the outputs are only referenced weakly so
+	 * the collector never keeps them alive */
+	std::string outputPath;
+	OBSWeakOutput streamOutput;
+	OBSWeakOutput recordOutput;
+
+	std::shared_ptr<const obs_frontend_stats> snapshot;
+
+	/* only used by the collector thread */
+	os_cpu_usage_info_t *cpuInfo = nullptr;
+	OutputState streamState;
+	OutputState recordState;
+
+	void Run();
+	void Collect();
+
+public:
+	StatsCollector(int interval);
+	~StatsCollector();
+
+	void Start();
+	void Stop();
+
+	void SetInterval(int interval);
+	void SetSources(const char *path, obs_output_t *stream, obs_output_t *record);
+
+	/* collects a new snapshot right away */
+	void Refresh();
+
+	/* returns nullptr until the first snapshot has been collected */
+	std::shared_ptr<const obs_frontend_stats> GetSnapshot();
+
+signals:
+	/* emitted from the collector thread */
+	void Updated();
+};
@@ -0,0 +1,413 @@
+#include "undo-data-diff.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+static inline bool HasUserValue(obs_data_item_t *item)
+{
+	return item && obs_data_item_has_user_value(item);
+}
+
+static void CopyItem(obs_data_t *data, const char *name, obs_data_item_t *item)
+{
+	switch (obs_data_item_gettype(item)) {
+	case OBS_DATA_STRING:
+		obs_data_set_string(data, name, obs_data_item_get_string(item));
+		break;
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT)
+			obs_data_set_int(data, name, obs_data_item_get_int(item));
+		else
+			obs_data_set_double(data, name, obs_data_item_get_double(item));
+		break;
+	case OBS_DATA_BOOLEAN:
+		obs_data_set_bool(data, name, obs_data_item_get_bool(item));
+		break;
+	case OBS_DATA_OBJECT: {
+		OBSDataAutoRelease obj = obs_data_item_get_obj(item);
+		obs_data_set_obj(data, name, obj);
+		break;
+	}
+	case OBS_DATA_ARRAY: {
+		OBSDataArrayAutoRelease array = obs_data_item_get_array(item);
+		obs_data_set_array(data, name, array);
+		break;
+	}
+	case OBS_DATA_NULL:
+		break;
+	}
+}
+
+static bool ScalarsEqual(obs_data_item_t *a, obs_data_item_t *b)
+{
+	switch (obs_data_item_gettype(a)) {
+	case OBS_DATA_STRING:
+		return strcmp(obs_data_item_get_string(a), obs_data_item_get_string(b)) == 0;
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(a) != obs_data_item_numtype(b))
+			return false;
+		if (obs_data_item_numtype(a) == OBS_DATA_NUM_INT)
+			return obs_data_item_get_int(a) == obs_data_item_get_int(b);
+		return obs_data_item_get_double(a) == obs_data_item_get_double(b);
+	case OBS_DATA_BOOLEAN:
+		return obs_data_item_get_bool(a) == obs_data_item_get_bool(b);
+	default:
+		return true;
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* arrays                                                                    */
+
+static bool GetElementKey(obs_data_t *element, const char *match, std::string &key)
+{
+	obs_data_item_t *item = obs_data_item_byname(element, match);
+	bool valid = HasUserValue(item);
+
+	if (valid) {
+		enum obs_data_type type = obs_data_item_gettype(item);
+		if (type == OBS_DATA_STRING)
+			key = obs_data_item_get_string(item);
+		else if (type == OBS_DATA_NUMBER)
+			key = std::to_string(obs_data_item_get_int(item));
+		else
+			valid = false;
+	}
+
+	obs_data_item_release(&item);
+	return valid;
+}
+
+static bool HasUniqueKeys(obs_data_array_t *array, const char *match)
+{
+	std::unordered_set<std::string> keys;
+	size_t count = obs_data_array_count(array);
+
+	for (size_t i = 0; i < count; i++) {
+		OBSDataAutoRelease element = obs_data_array_item(array, i);
+		std::string key;
+
+		if (!element || !GetElementKey(element, match, key) || !keys.insert(key).second)
+			return false;
+	}
+
+	return true;
+}
+
+static const char *GetMatchKey(obs_data_array_t *from, obs_data_array_t *to)
+{
+	for (const char *match : {"uuid", "id", "scene_name"}) {
+		if (HasUniqueKeys(from, match) && HasUniqueKeys(to, match))
+			return match;
+	}
+
+	return nullptr;
+}
+
+static OBSDataAutoRelease DiffKeyedArrays(obs_data_array_t *from, obs_data_array_t *to, const char *match)
+{
+	std::unordered_map<std::string, size_t> from_idx;
+	std::vector<std::string> from_keys;
+	std::vector<std::string> to_keys;
+	size_t from_count = obs_data_array_count(from);
+	size_t to_count = obs_data_array_count(to);
+
+	OBSDataArrayAutoRelease changed = obs_data_array_create();
+	OBSDataArrayAutoRelease added = obs_data_array_create();
+
+	for (size_t i = 0; i < from_count; i++) {
+		OBSDataAutoRelease element = obs_data_array_item(from, i);
+		std::string key;
+		GetElementKey(element, match, key);
+
+		from_idx[key] = i;
+		from_keys.push_back(std::move(key));
+	}
+
+	for (size_t i = 0; i < to_count; i++) {
+		OBSDataAutoRelease element = obs_data_array_item(to, i);
+		OBSDataAutoRelease entry = obs_data_create();
+		std::string key;
+		GetElementKey(element, match, key);
+
+		obs_data_set_string(entry, "key", key.c_str());
+
+		auto it = from_idx.find(key);
+		if (it == from_idx.end()) {
+			obs_data_set_obj(entry, "value", element);
+			obs_data_array_push_back(added, entry);
+		} else {
+			OBSDataAutoRelease old = obs_data_array_item(from, it->second);
+			OBSDataAutoRelease patch = CreateDataPatch(old, element);
+			if (patch) {
+				obs_data_set_obj(entry, "patch", patch);
+				obs_data_array_push_back(changed, entry);
+			}
+		}
+
+		to_keys.push_back(std::move(key));
+	}
+
+	bool reordered = from_keys != to_keys;
+	if (!reordered && !obs_data_array_count(changed))
+		return nullptr;
+
+	OBSDataAutoRelease patch = obs_data_create();
+	obs_data_set_string(patch, "match", match);
+
+	/* the order is only stored when items were added, removed or moved,
+	 * otherwise the patch just changes items in place */
+	if (reordered) {
+		OBSDataArrayAutoRelease order = obs_data_array_create();
+		for (const std::string &key : to_keys) {
+			OBSDataAutoRelease entry = obs_data_create();
+			obs_data_set_string(entry, "key", key.c_str());
+			obs_data_array_push_back(order, entry);
+		}
+
+		obs_data_set_array(patch, "order", order);
+		obs_data_set_array(patch, "added", added);
+	}
+	if (obs_data_array_count(changed))
+		obs_data_set_array(patch, "changed", changed);
+
+	return patch;
+}
+
+static OBSDataAutoRelease DiffIndexedArrays(obs_data_array_t *from, obs_data_array_t *to)
+{
+	OBSDataArrayAutoRelease changed = obs_data_array_create();
+	size_t count = obs_data_array_count(to);
+
+	for (size_t i = 0; i < count; i++) {
+		OBSDataAutoRelease old = obs_data_array_item(from, i);
+		OBSDataAutoRelease element = obs_data_array_item(to, i);
+		OBSDataAutoRelease patch = CreateDataPatch(old, element);
+
+		if (patch) {
+			OBSDataAutoRelease entry = obs_data_create();
+			obs_data_set_int(entry, "index", (long long)i);
+			obs_data_set_obj(entry, "patch", patch);
+			obs_data_array_push_back(changed, entry);
+		}
+	}
+
+	if (!obs_data_array_count(changed))
+		return nullptr;
+
+	OBSDataAutoRelease patch = obs_data_create();
+	obs_data_set_array(patch, "changed", changed);
+	return patch;
+}
+
+/* sets replace if the array has to be stored whole */
+static OBSDataAutoRelease DiffArrays(obs_data_array_t *from, obs_data_array_t *to, bool &replace)
+{
+	const char *match = GetMatchKey(from, to);
+
+	replace = false;
+	if (match)
+		return DiffKeyedArrays(from, to, match);
+
+	if (obs_data_array_count(from) == obs_data_array_count(to))
+		return DiffIndexedArrays(from, to);
+
+	replace = true;
+	return nullptr;
+}
+
+static void ApplyArrayPatch(obs_data_t *data, const char *name, obs_data_t *patch)
+{
+	OBSDataArrayAutoRelease array = obs_data_get_array(data, name);
+	OBSDataArrayAutoRelease changed = obs_data_get_array(patch, "changed");
+	const char *match = obs_data_get_string(patch, "match");
+	size_t changed_count = obs_data_array_count(changed);
+
+	if (!*match) {
+		for (size_t i = 0; i < changed_count; i++) {
+			OBSDataAutoRelease entry = obs_data_array_item(changed, i);
+			OBSDataAutoRelease element_patch = obs_data_get_obj(entry, "patch");
+			OBSDataAutoRelease element =
+				obs_data_array_item(array, (size_t)obs_data_get_int(entry, "index"));
+
+			if (element)
+				ApplyDataPatch(element, element_patch);
+		}
+		return;
+	}
+
+	std::unordered_map<std::string, OBSData> elements;
+	size_t count = obs_data_array_count(array);
+
+	for (size_t i = 0; i < count; i++) {
+		OBSDataAutoRelease element = obs_data_array_item(array, i);
+		std::string key;
+		if (GetElementKey(element, match, key))
+			elements[key] = element.Get();
+	}
+
+	for (size_t i = 0; i < changed_count; i++) {
+		OBSDataAutoRelease entry = obs_data_array_item(changed, i);
+		OBSDataAutoRelease element_patch = obs_data_get_obj(entry, "patch");
+
+		auto it = elements.find(obs_data_get_string(entry, "key"));
+		if (it != elements.end())
+			ApplyDataPatch(it->second, element_patch);
+	}
+
+	OBSDataArrayAutoRelease order = obs_data_get_array(patch, "order");
+	if (!order)
+		return;
+
+	OBSDataArrayAutoRelease added = obs_data_get_array(patch, "added");
+	size_t added_count = obs_data_array_count(added);
+
+	for (size_t i = 0; i < added_count; i++) {
+		OBSDataAutoRelease entry = obs_data_array_item(added, i);
+		OBSDataAutoRelease value = obs_data_get_obj(entry, "value");
+		elements[obs_data_get_string(entry, "key")] = value.Get();
+	}
+
+	OBSDataArrayAutoRelease new_array = obs_data_array_create();
+	size_t order_count = obs_data_array_count(order);
+
+	for (size_t i = 0; i < order_count; i++) {
+		OBSDataAutoRelease entry = obs_data_array_item(order, i);
+
+		auto it = elements.find(obs_data_get_string(entry, "key"));
+		if (it != elements.end())
+			obs_data_array_push_back(new_array, it->second);
+	}
+
+	obs_data_set_array(data, name, new_array);
+}
+
+/* ------------------------------------------------------------------------- */
+
+OBSDataAutoRelease CreateDataPatch(obs_data_t *from, obs_data_t *to)
+{
+	OBSDataAutoRelease set = obs_data_create();
+	OBSDataAutoRelease objects = obs_data_create();
+	OBSDataAutoRelease arrays = obs_data_create();
+	OBSDataArrayAutoRelease removed = obs_data_array_create();
+	bool has_set = false;
+	bool has_objects = false;
+	bool has_arrays = false;
+
+	obs_data_item_t *item = obs_data_first(to);
+	for (; item != NULL; obs_data_item_next(&item)) {
+		if (!obs_data_item_has_user_value(item))
+			continue;
+
+		const char *name = obs_data_item_get_name(item);
+		enum obs_data_type type = obs_data_item_gettype(item);
+		obs_data_item_t *old = obs_data_item_byname(from, name);
+
+		if (!HasUserValue(old) || obs_data_item_gettype(old) != type) {
+			CopyItem(set, name, item);
+			has_set = true;
+
+		} else if (type == OBS_DATA_OBJECT) {
+			OBSDataAutoRelease old_obj = obs_data_item_get_obj(old);
+			OBSDataAutoRelease obj = obs_data_item_get_obj(item);
+			OBSDataAutoRelease patch = CreateDataPatch(old_obj, obj);
+
+			if (patch) {
+				obs_data_set_obj(objects, name, patch);
+				has_objects = true;
+			}
+
+		} else if (type == OBS_DATA_ARRAY) {
+			OBSDataArrayAutoRelease old_array = obs_data_item_get_array(old);
+			OBSDataArrayAutoRelease array = obs_data_item_get_array(item);
+			bool replace;
+			OBSDataAutoRelease patch = DiffArrays(old_array, array, replace);
+
+			if (replace) {
+				CopyItem(set, name, item);
+				has_set = true;
+			} else if (patch) {
+				obs_data_set_obj(arrays, name, patch);
+				has_arrays = true;
+			}
+
+		} else if (!ScalarsEqual(old, item)) {
+			CopyItem(set, name, item);
+			has_set = true;
+		}
+
+		obs_data_item_release(&old);
+	}
+
+	item = obs_data_first(from);
+	for (; item != NULL; obs_data_item_next(&item)) {
+		if (!obs_data_item_has_user_value(item))
+			continue;
+
+		const char *name = obs_data_item_get_name(item);
+		obs_data_item_t *cur = obs_data_item_byname(to, name);
+
+		if (!HasUserValue(cur)) {
+			OBSDataAutoRelease entry = obs_data_create();
+			obs_data_set_string(entry, "name", name);
+			obs_data_array_push_back(removed, entry);
+		}
+
+		obs_data_item_release(&cur);
+	}
+
+	bool has_removed = obs_data_array_count(removed) > 0;
+	if (!has_set && !has_objects && !has_arrays && !has_removed)
+		return nullptr;
+
+	OBSDataAutoRelease patch = obs_data_create();
+	if (has_set)
+		obs_data_set_obj(patch, "set", set);
+	if (has_objects)
+		obs_data_set_obj(patch, "objects", objects);
+	if (has_arrays)
+		obs_data_set_obj(patch, "arrays", arrays);
+	if (has_removed)
+		obs_data_set_array(patch, "remove", removed);
+	return patch;
+}
+
+void ApplyDataPatch(obs_data_t *data, obs_data_t *patch)
+{
+	OBSDataAutoRelease set = obs_data_get_obj(patch, "set");
+	OBSDataAutoRelease objects = obs_data_get_obj(patch, "objects");
+	OBSDataAutoRelease arrays = obs_data_get_obj(patch, "arrays");
+	OBSDataArrayAutoRelease removed = obs_data_get_array(patch, "remove");
+	size_t removed_count = obs_data_array_count(removed);
+
+	for (size_t i = 0; i < removed_count; i++) {
+		OBSDataAutoRelease entry = obs_data_array_item(removed, i);
+		obs_data_erase(data, obs_data_get_string(entry, "name"));
+	}
+
+	obs_data_item_t *item = obs_data_first(set);
+	for (; item != NULL; obs_data_item_next(&item))
+		CopyItem(data, obs_data_item_get_name(item), item);
+
+	item = obs_data_first(objects);
+	for (; item != NULL; obs_data_item_next(&item)) {
+		const char *name = obs_data_item_get_name(item);
+		OBSDataAutoRelease obj_patch = obs_data_item_get_obj(item);
+		OBSDataAutoRelease obj = obs_data_get_obj(data, name);
+
+		if (!obj) {
+			obj = obs_data_create();
+			obs_data_set_obj(data, name, obj);
+		}
+
+		ApplyDataPatch(obj, obj_patch);
+	}
+
+	item = obs_data_first(arrays);
+	for (; item != NULL; obs_data_item_next(&item)) {
+		OBSDataAutoRelease array_patch = obs_data_item_get_obj(item);
+		ApplyArrayPatch(data, obs_data_item_get_name(item), array_patch);
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <obs.hpp>
+
+/* Structural diffs of obs_data, used by the undo stack to store only the
+ * keys an action changed instead of complete snapshots.
+ *
+ * Arrays of objects that all have a unique "uuid" (saved sources), "id"
+ * (scene items) or "scene_name" (transform states) are diffed by that key, so
+ * items being added, removed or reordered only store the affected items.  Other arrays are diffed by index
+ * when their size is unchanged, and stored whole otherwise. */
+
+/* returns a patch that turns from into to, or nullptr if they're equal */
+OBSDataAutoRelease CreateDataPatch(obs_data_t *from, obs_data_t *to);
+
+/* applies a patch created by CreateDataPatch to data, in place */
+void ApplyDataPatch(obs_data_t *data, obs_data_t *patch);
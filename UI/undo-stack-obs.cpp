@@ -1,8 +1,10 @@
 #include "moc_undo-stack-obs.cpp"
+#include "undo-data-diff.hpp"
 
 #include <util/util.hpp>
 
 #define MAX_STACK_SIZE 5000
+#define MAX_STACK_MEMORY (64 * 1024 * 1024)
 
 undo_stack::undo_stack(ui_ptr ui) : ui(ui)
 {
@@ -20,6 +22,7 @@ void undo_stack::clear()
 {
 	undo_items.clear();
 	redo_items.clear();
+	total_size = 0;
 	last_is_repeatable = false;
 
 	ui->actionMainUndo->setText(QTStr("Undo.Undo"));
@@ -35,28 +38,63 @@ void undo_stack::add_action(const QString &name, const undo_redo_cb &undo, const
 	if (!is_enabled())
 		return;
 
-	while (undo_items.size() >= MAX_STACK_SIZE) {
-		undo_redo_t item = undo_items.back();
-		undo_items.pop_back();
-	}
-
 	if (repeatable) {
 		repeat_reset_timer.start();
 	}
 
 	if (last_is_repeatable && repeatable && name == undo_items[0].name) {
-		undo_items[0].redo = redo;
-		undo_items[0].redo_data = redo_data;
+		undo_redo_t &item = undo_items[0];
+		total_size -= item.size;
+		item.redo = redo;
+		item.redo_data = redo_data;
+		item.size = item.undo_data.size() + item.redo_data.size();
+		total_size += item.size;
 		return;
 	}
 
 	undo_redo_t n = {name, undo_data, redo_data, undo, redo};
+	n.size = undo_data.size() + redo_data.size();
 
 	last_is_repeatable = repeatable;
-	undo_items.push_front(n);
+	push_action(std::move(n));
+}
+
+void undo_stack::add_delta_action(const QString &name, const undo_redo_cb &undo, const undo_redo_cb &redo,
+				  const capture_cb &capture, obs_data_t *undo_state, obs_data_t *redo_state)
+{
+	if (!is_enabled())
+		return;
+
+	OBSDataAutoRelease undo_patch = CreateDataPatch(redo_state, undo_state);
+	OBSDataAutoRelease redo_patch = CreateDataPatch(undo_state, redo_state);
+	if (!undo_patch || !redo_patch)
+		return;
+
+	undo_redo_t n = {name, obs_data_get_json(undo_patch), obs_data_get_json(redo_patch), undo, redo, capture};
+	n.size = n.undo_data.size() + n.redo_data.size();
+
+	last_is_repeatable = false;
+	push_action(std::move(n));
+}
+
+void undo_stack::push_action(undo_redo_t &&action)
+{
 	clear_redo();
 
-	ui->actionMainUndo->setText(QTStr("Undo.Item.Undo").arg(name));
+	total_size += action.size;
+	undo_items.push_front(std::move(action));
+
+	const undo_redo_t &n = undo_items.front();
+	blog(LOG_DEBUG, "Undo action '%s': %zu bytes (%zu bytes in %zu actions)", n.name.toUtf8().constData(),
+	     n.size, total_size, undo_items.size());
+
+	/* always keep the newest action, even if it's over the limit */
+	while (undo_items.size() > MAX_STACK_SIZE || (total_size > MAX_STACK_MEMORY && undo_items.size() > 1)) {
+		total_size -= undo_items.back().size;
+		undo_items.pop_back();
+	}
+
+	ui->actionMainUndo->setText(QTStr("Undo.Item.Undo").arg(n.name));
 	ui->actionMainUndo->setEnabled(true);
 
 	ui->actionMainRedo->setText(QTStr("Undo.Redo"));
@@ -71,7 +109,7 @@ void undo_stack::undo()
 	last_is_repeatable = false;
 
 	undo_redo_t temp = undo_items.front();
-	temp.undo(temp.undo_data);
+	temp.undo(get_data(temp, true));
 	redo_items.push_front(temp);
 	undo_items.pop_front();
 
@@ -94,7 +132,7 @@ void undo_stack::redo()
 	last_is_repeatable = false;
 
 	undo_redo_t temp = redo_items.front();
-	temp.redo(temp.redo_data);
+	temp.redo(get_data(temp, false));
 	undo_items.push_front(temp);
 	redo_items.pop_front();
 
@@ -156,5 +194,24 @@ void undo_stack::pop_disabled()
 
 void undo_stack::clear_redo()
 {
+	for (const undo_redo_t &item : redo_items)
+		total_size -= item.size;
 	redo_items.clear();
 }
+
+std::string undo_stack::get_data(const undo_redo_t &action, bool is_undo) const
+{
+	const std::string &data = is_undo ? action.undo_data : action.redo_data;
+	if (!action.capture)
+		return data;
+
+	OBSData state = action.capture();
+	if (!state) {
+		blog(LOG_WARNING, "Undo action '%s': failed to capture current state", action.name.toUtf8().constData());
+		return "{}";
+	}
+
+	OBSDataAutoRelease patch = obs_data_create_from_json(data.c_str());
+	ApplyDataPatch(state, patch);
+	return obs_data_get_json(state);
+}
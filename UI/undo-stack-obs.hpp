@@ -4,6 +4,8 @@
 #include <QString>
 #include <QTimer>
 
+#include <obs.hpp>
+
 #include <deque>
 #include <functional>
 #include <string>
@@ -15,6 +17,7 @@ class undo_stack : public QObject {
 	Q_OBJECT
 
 	typedef std::function<void(const std::string &data)> undo_redo_cb;
+	typedef std::function<OBSData()> capture_cb;
 	typedef std::function<void(bool is_undo)> func;
 	typedef std::unique_ptr<Ui::OBSBasic> &ui_ptr;
 
@@ -24,11 +27,18 @@ class undo_stack : public QObject {
 		std::string redo_data;
 		undo_redo_cb undo;
 		undo_redo_cb redo;
+
+		/* delta actions only store patches of what changed as their
+		 * undo/redo data, which are applied to the state captured
+		 * when the action is undone or redone */
+		capture_cb capture;
+		size_t size = 0;
 	};
 
 	ui_ptr ui;
 	std::deque<undo_redo_t> undo_items;
 	std::deque<undo_redo_t> redo_items;
+	size_t total_size = 0;
 	int disable_refs = 0;
 	bool enabled = true;
 	bool last_is_repeatable = false;
@@ -40,6 +50,8 @@ class undo_stack : public QObject {
 	void enable_internal();
 	void disable_internal();
 	void clear_redo();
+	void push_action(undo_redo_t &&action);
+	std::string get_data(const undo_redo_t &action, bool is_undo) const;
 
 private slots:
 	void reset_repeatable_state();
@@ -55,6 +67,8 @@ public:
 	void clear();
 	void add_action(const QString &name, const undo_redo_cb &undo, const undo_redo_cb &redo,
 			const std::string &undo_data, const std::string &redo_data, bool repeatable = false);
+	void add_delta_action(const QString &name, const undo_redo_cb &undo, const undo_redo_cb &redo,
+			      const capture_cb &capture, obs_data_t *undo_state, obs_data_t *redo_state);
 	void undo();
 	void redo();
 };
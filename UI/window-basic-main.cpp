@@ -617,9 +617,10 @@ static void SaveAudioDevice(const char *name, int channel, obs_data_t *parent, v
 	obs_data_set_obj(parent, name, data);
 }
 
-static obs_data_t *GenerateSaveData(obs_data_array_t *sceneOrder, obs_data_array_t *quickTransitionData,
-				    int transitionDuration, obs_data_array_t *transitions, OBSScene &scene,
-				    OBSSource &curProgramScene, obs_data_array_t *savedProjectorList)
+static obs_data_t *GenerateSaveData(SavedSourceCache &savedSources, obs_data_array_t *sceneOrder,
+				    obs_data_array_t *quickTransitionData, int transitionDuration,
+				    obs_data_array_t *transitions, OBSScene &scene, OBSSource &curProgramScene,
+				    obs_data_array_t *savedProjectorList)
 {
 	obs_data_t *saveData = obs_data_create();
 
@@ -642,21 +643,15 @@ static obs_data_t *GenerateSaveData(obs_data_array_t *sceneOrder, obs_data_array
 
 		return find(begin(audioSources), end(audioSources), source) == end(audioSources);
 	};
-	using FilterAudioSources_t = decltype(FilterAudioSources);
 
-	obs_data_array_t *sourcesArray = obs_save_sources_filtered(
-		[](void *data, obs_source_t *source) {
-			auto &func = *static_cast<FilterAudioSources_t *>(data);
-			return func(source);
-		},
-		static_cast<void *>(&FilterAudioSources));
+	obs_data_array_t *sourcesArray = savedSources.SaveSources(FilterAudioSources);
 
 	/* -------------------------------- */
 	/* save group sources separately    */
 
 	/* saving separately ensures they won't be loaded in older versions */
-	obs_data_array_t *groupsArray = obs_save_sources_filtered(
-		[](void *, obs_source_t *source) { return obs_source_is_group(source); }, nullptr);
+	obs_data_array_t *groupsArray =
+		savedSources.SaveSources([](obs_source_t *source) { return obs_source_is_group(source); });
 
 	/* -------------------------------- */
 
@@ -833,8 +828,9 @@ void OBSBasic::Save(const char *file)
 	OBSDataArrayAutoRelease transitions = SaveTransitions();
 	OBSDataArrayAutoRelease quickTrData = SaveQuickTransitions();
 	OBSDataArrayAutoRelease savedProjectorList = SaveProjectors();
-	OBSDataAutoRelease saveData = GenerateSaveData(sceneOrder, quickTrData, ui->transitionDuration->value(),
-						       transitions, scene, curProgramScene, savedProjectorList);
+	OBSDataAutoRelease saveData = GenerateSaveData(savedSources, sceneOrder, quickTrData,
+						       ui->transitionDuration->value(), transitions, scene,
+						       curProgramScene, savedProjectorList);
 
 	obs_data_set_bool(saveData, "preview_locked", ui->preview->Locked());
 	obs_data_set_bool(saveData, "scaling_enabled", ui->preview->IsFixedScaling());
@@ -886,8 +882,25 @@ void OBSBasic::Save(const char *file)
 		obs_data_set_obj(saveData, "migration_resolution", res);
 	}
 
-	if (!obs_data_save_json_pretty_safe(saveData, file, "tmp", "bak"))
+	const char *json = obs_data_get_json_pretty(saveData);
+	if (!json || !*json) {
 		blog(LOG_ERROR, "Could not save scene data to %s", file);
+		return;
+	}
+
+	/* write the file in the background, the previous save has to finish
+	 * first so saves can't overwrite newer data */
+	WaitForSave();
+	saveTask = std::async(std::launch::async, [json = std::string(json), path = std::string(file)]() {
+		if (!os_quick_write_utf8_file_safe(path.c_str(), json.c_str(), json.size(), false, "tmp", "bak"))
+			blog(LOG_ERROR, "Could not save scene data to %s", path.c_str());
+	});
+}
+
+void OBSBasic::WaitForSave()
+{
+	if (saveTask.valid())
+		saveTask.wait();
 }
 
 void OBSBasic::DeferSaveBegin()
@@ -1321,6 +1334,10 @@ void OBSBasic::LoadData(obs_data_t *data, const char *file, bool remigrate)
 
 	DisableRelativeCoordinates(disableRelativeCoords);
 
+	/* only create sources when they're first shown, so sources of scenes
+	 * that are rarely used don't use any resources until then */
+	obs_set_lazy_source_creation(config_get_bool(App()->GetAppConfig(), "General", "LazySourceCreation"));
+
 	obs_missing_files_t *files = obs_missing_files_create();
 	obs_load_sources(sources, AddMissingFiles, files);
 
@@ -2264,6 +2281,14 @@ void OBSBasic::OBSInit()
 		show();
 #endif
 
+	/* setup stats collector, the outputs and recording path it reads are
+	 * refreshed from the UI thread after every snapshot */
+	int statsInterval = (int)config_get_int(App()->GetAppConfig(), "General", "StatsInterval");
+	statsCollector = std::make_unique<StatsCollector>(statsInterval);
+	connect(statsCollector.get(), &StatsCollector::Updated, this, &OBSBasic::UpdateStatsSources);
+	UpdateStatsSources();
+	statsCollector->Start();
+
 	/* setup stats dock */
 	OBSBasicStats *statsDlg = new OBSBasicStats(statsDock, false);
 	statsDock->setWidget(statsDlg);
@@ -2896,6 +2921,7 @@ OBSBasic::~OBSBasic()
 	obs_hotkey_set_callback_routing_func(nullptr, nullptr);
 	ClearHotkeys();
 
+	statsCollector.reset();
 	service = nullptr;
 	outputHandler.reset();
 
@@ -2958,8 +2984,12 @@ void OBSBasic::SaveProjectNow()
 	if (disableSaving)
 		return;
 
+	/* the collection file is usually read, copied or switched after this,
+	 * so save every source and make sure the file has been written */
+	savedSources.Clear();
 	projectChanged = true;
 	SaveProjectDeferred();
+	WaitForSave();
 }
 
 void OBSBasic::SaveProject()
@@ -4553,6 +4583,9 @@ bool OBSBasic::ResetAudio()
 		ai.fixed_buffering = true;
 	}
 
+	/* 0 (the default) uses AUDIO_OUTPUT_FRAMES */
+	ai.output_frames = (uint32_t)config_get_uint(App()->GetUserConfig(), "Audio", "BlockSize");
+
 	return obs_reset_audio2(&ai);
 }
 
@@ -4697,6 +4730,8 @@ void OBSBasic::ClearSceneData()
 	}
 
 	collectionModuleData = nullptr;
+	savedSources.Clear();
+	WaitForSave();
 	lastScene = nullptr;
 	swapScene = nullptr;
 	programScene = nullptr;
@@ -4857,6 +4892,9 @@ void OBSBasic::closeEvent(QCloseEvent *event)
 		devicePropertiesThread.reset();
 	}
 
+	if (statsCollector)
+		statsCollector->Stop();
+
 	QApplication::sendPostedEvents(nullptr);
 
 	signalHandlers.clear();
@@ -5898,7 +5936,7 @@ OBSData OBSBasic::BackupScene(obs_scene_t *scene, std::vector<obs_source_t *> *s
 	OBSDataAutoRelease data = obs_data_create();
 
 	obs_data_set_array(data, "array", undo_array);
-	obs_data_get_json(data);
+	obs_data_set_bool(data, "listed_sources", sources != nullptr);
 	return data.Get();
 }
 
@@ -5948,10 +5986,48 @@ void OBSBasic::CreateSceneUndoRedoAction(const QString &action_name, OBSData und
 		ui->sources->RefreshItems();
 	};
 
-	const char *undo_json = obs_data_get_last_json(undo_data);
-	const char *redo_json = obs_data_get_last_json(redo_data);
+	/* only the differences between the two backups are stored, and the
+	 * full scene data is rebuilt from the scene's current state when the
+	 * action is undone or redone */
+	OBSDataArrayAutoRelease array = obs_data_get_array(redo_data, "array");
+	const size_t count = obs_data_array_count(array);
+	if (!count)
+		return;
+
+	OBSDataAutoRelease scene_data = obs_data_array_item(array, count - 1);
+	std::string scene_uuid = obs_data_get_string(scene_data, "uuid");
+	bool listed = obs_data_get_bool(redo_data, "listed_sources");
+	std::vector<std::string> source_uuids;
 
-	undo_s.add_action(action_name, undo_redo, undo_redo, undo_json, redo_json);
+	if (listed) {
+		for (size_t i = 0; i < count - 1; i++) {
+			OBSDataAutoRelease data = obs_data_array_item(array, i);
+			source_uuids.emplace_back(obs_data_get_string(data, "uuid"));
+		}
+	}
+
+	auto capture = [scene_uuid, listed, source_uuids]() -> OBSData {
+		OBSSourceAutoRelease scene_source = obs_get_source_by_uuid(scene_uuid.c_str());
+		obs_scene_t *scene = obs_scene_from_source(scene_source);
+		if (!scene)
+			return nullptr;
+
+		if (!listed)
+			return BackupScene(scene);
+
+		std::vector<OBSSourceAutoRelease> refs;
+		std::vector<obs_source_t *> sources;
+		for (const std::string &uuid : source_uuids) {
+			OBSSourceAutoRelease source = obs_get_source_by_uuid(uuid.c_str());
+			if (source)
+				sources.push_back(source);
+			refs.push_back(std::move(source));
+		}
+
+		return BackupScene(scene, &sources);
+	};
+
+	undo_s.add_delta_action(action_name, undo_redo, undo_redo, capture, undo_data, redo_data);
 }
 
 void OBSBasic::on_actionRemoveSource_triggered()
@@ -7930,13 +8006,38 @@ void OBSBasic::on_actionCopyTransform_triggered()
 	hasCopiedTransform = true;
 }
 
-void undo_redo(const std::string &data)
+void OBSBasic::CreateTransformUndoRedoAction(const QString &action_name, obs_data_t *undo_data,
+					     obs_data_t *redo_data)
 {
-	OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
-	OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
-	reinterpret_cast<OBSBasic *>(App()->GetMainWindow())->SetCurrentScene(source.Get(), true);
+	/* the scene itself is saved after its groups */
+	OBSDataArrayAutoRelease scenes = obs_data_get_array(redo_data, "scenes_and_groups");
+	size_t count = obs_data_array_count(scenes);
+	if (!count)
+		return;
 
-	obs_scene_load_transform_states(data.c_str());
+	OBSDataAutoRelease scene_data = obs_data_array_item(scenes, count - 1);
+	std::string scene_uuid = obs_data_get_string(scene_data, "scene_uuid");
+
+	auto undo_redo = [this](const std::string &data) {
+		OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
+		OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
+		SetCurrentScene(source.Get(), true);
+
+		obs_scene_load_transform_states(data.c_str());
+	};
+
+	/* save all items, the selection may have changed since */
+	auto capture = [scene_uuid]() -> OBSData {
+		OBSSourceAutoRelease source = obs_get_source_by_uuid(scene_uuid.c_str());
+		obs_scene_t *scene = obs_scene_from_source(source);
+		if (!scene)
+			return nullptr;
+
+		OBSDataAutoRelease data = obs_scene_save_transform_states(scene, true);
+		return data.Get();
+	};
+
+	undo_s.add_delta_action(action_name, undo_redo, undo_redo, capture, undo_data, redo_data);
 }
 
 void OBSBasic::on_actionPasteTransform_triggered()
@@ -7962,10 +8063,8 @@ void OBSBasic::on_actionPasteTransform_triggered()
 
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(QTStr("Undo.Transform.Paste").arg(obs_source_get_name(GetCurrentSceneSource())), undo_redo,
-			  undo_redo, undo_data, redo_data);
+	CreateTransformUndoRedoAction(
+		QTStr("Undo.Transform.Paste").arg(obs_source_get_name(GetCurrentSceneSource())), wrapper, rwrapper);
 }
 
 static bool reset_tr(obs_scene_t * /* scene */, obs_sceneitem_t *item, void *)
@@ -8006,10 +8105,8 @@ void OBSBasic::on_actionResetTransform_triggered()
 	obs_scene_enum_items(scene, reset_tr, nullptr);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(scene, false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(QTStr("Undo.Transform.Reset").arg(obs_source_get_name(obs_scene_get_source(scene))),
-			  undo_redo, undo_redo, undo_data, redo_data);
+	CreateTransformUndoRedoAction(
+		QTStr("Undo.Transform.Reset").arg(obs_source_get_name(obs_scene_get_source(scene))), wrapper, rwrapper);
 
 	obs_scene_enum_items(GetCurrentScene(), reset_tr, nullptr);
 }
@@ -8089,11 +8186,9 @@ void OBSBasic::on_actionRotate90CW_triggered()
 	obs_scene_enum_items(GetCurrentScene(), RotateSelectedSources, &f90CW);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.Rotate").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionRotate90CCW_triggered()
@@ -8103,11 +8198,9 @@ void OBSBasic::on_actionRotate90CCW_triggered()
 	obs_scene_enum_items(GetCurrentScene(), RotateSelectedSources, &f90CCW);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.Rotate").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionRotate180_triggered()
@@ -8117,11 +8210,9 @@ void OBSBasic::on_actionRotate180_triggered()
 	obs_scene_enum_items(GetCurrentScene(), RotateSelectedSources, &f180);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.Rotate").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 static bool MultiplySelectedItemScale(obs_scene_t * /* scene */, obs_sceneitem_t *item, void *param)
@@ -8157,11 +8248,9 @@ void OBSBasic::on_actionFlipHorizontal_triggered()
 	obs_scene_enum_items(GetCurrentScene(), MultiplySelectedItemScale, &scale);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.HFlip").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionFlipVertical_triggered()
@@ -8172,11 +8261,9 @@ void OBSBasic::on_actionFlipVertical_triggered()
 	obs_scene_enum_items(GetCurrentScene(), MultiplySelectedItemScale, &scale);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.VFlip").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 static bool CenterAlignSelectedItems(obs_scene_t * /* scene */, obs_sceneitem_t *item, void *param)
@@ -8216,11 +8303,9 @@ void OBSBasic::on_actionFitToScreen_triggered()
 	obs_scene_enum_items(GetCurrentScene(), CenterAlignSelectedItems, &boundsType);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.FitToScreen").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionStretchToScreen_triggered()
@@ -8230,11 +8315,9 @@ void OBSBasic::on_actionStretchToScreen_triggered()
 	obs_scene_enum_items(GetCurrentScene(), CenterAlignSelectedItems, &boundsType);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(QTStr("Undo.Transform.StretchToScreen")
-				  .arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-			  undo_redo, undo_redo, undo_data, redo_data);
+	CreateTransformUndoRedoAction(QTStr("Undo.Transform.StretchToScreen")
+					      .arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
+				      wrapper, rwrapper);
 }
 
 void OBSBasic::CenterSelectedSceneItems(const CenterType &centerType)
@@ -8327,11 +8410,9 @@ void OBSBasic::on_actionCenterToScreen_triggered()
 	CenterSelectedSceneItems(centerType);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.Center").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionVerticalCenter_triggered()
@@ -8341,11 +8422,9 @@ void OBSBasic::on_actionVerticalCenter_triggered()
 	CenterSelectedSceneItems(centerType);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.VCenter").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::on_actionHorizontalCenter_triggered()
@@ -8355,11 +8434,9 @@ void OBSBasic::on_actionHorizontalCenter_triggered()
 	CenterSelectedSceneItems(centerType);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
-	undo_s.add_action(
+	CreateTransformUndoRedoAction(
 		QTStr("Undo.Transform.HCenter").arg(obs_source_get_name(obs_scene_get_source(GetCurrentScene()))),
-		undo_redo, undo_redo, undo_data, redo_data);
+		wrapper, rwrapper);
 }
 
 void OBSBasic::EnablePreviewDisplay(bool enable)
@@ -8462,15 +8539,15 @@ void OBSBasic::Nudge(int dist, MoveDir dir)
 	if (!recent_nudge) {
 		recent_nudge = true;
 		OBSDataAutoRelease wrapper = obs_scene_save_transform_states(GetCurrentScene(), true);
-		std::string undo_data(obs_data_get_json(wrapper));
+		OBSData undo_data = wrapper.Get();
 
 		nudge_timer = new QTimer;
 		QObject::connect(nudge_timer, &QTimer::timeout, [this, &recent_nudge = recent_nudge, undo_data]() {
 			OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), true);
-			std::string redo_data(obs_data_get_json(rwrapper));
 
-			undo_s.add_action(QTStr("Undo.Transform").arg(obs_source_get_name(GetCurrentSceneSource())),
-					  undo_redo, undo_redo, undo_data, redo_data);
+			CreateTransformUndoRedoAction(
+				QTStr("Undo.Transform").arg(obs_source_get_name(GetCurrentSceneSource())), undo_data,
+				rwrapper);
 
 			recent_nudge = false;
 		});
@@ -9336,9 +9413,11 @@ static void ConfirmColor(SourceTree *sources, const QColor &color, QModelIndexLi
 {
 	for (int x = 0; x < selectedItems.count(); x++) {
 		SourceTreeItem *treeItem = sources->GetItemWidget(selectedItems[x].row());
-		treeItem->setStyleSheet("background: " + color.name(QColor::HexArgb));
-		treeItem->style()->unpolish(treeItem);
-		treeItem->style()->polish(treeItem);
+		if (treeItem) {
+			treeItem->setStyleSheet("background: " + color.name(QColor::HexArgb));
+			treeItem->style()->unpolish(treeItem);
+			treeItem->style()->polish(treeItem);
+		}
 
 		OBSSceneItem sceneItem = sources->Get(selectedItems[x].row());
 		OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
@@ -9361,10 +9440,12 @@ void OBSBasic::ColorChange()
 
 		for (int x = 0; x < selectedItems.count(); x++) {
 			SourceTreeItem *treeItem = ui->sources->GetItemWidget(selectedItems[x].row());
-			treeItem->setStyleSheet("");
-			treeItem->setProperty("bgColor", preset);
-			treeItem->style()->unpolish(treeItem);
-			treeItem->style()->polish(treeItem);
+			if (treeItem) {
+				treeItem->setStyleSheet("");
+				treeItem->setProperty("bgColor", preset);
+				treeItem->style()->unpolish(treeItem);
+				treeItem->style()->polish(treeItem);
+			}
 
 			OBSSceneItem sceneItem = ui->sources->Get(selectedItems[x].row());
 			OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
@@ -9386,14 +9467,16 @@ void OBSBasic::ColorChange()
 
 		if (preset == 1) {
 			OBSSceneItem curSceneItem = GetCurrentSceneItem();
-			SourceTreeItem *curTreeItem = GetItemWidgetFromSceneItem(curSceneItem);
+			/* the widget is destroyed if the item is scrolled out
+			 * of view while the dialog is open */
+			QPointer<SourceTreeItem> curTreeItem = GetItemWidgetFromSceneItem(curSceneItem);
 			OBSDataAutoRelease curPrivData = obs_sceneitem_get_private_settings(curSceneItem);
 
 			int oldPreset = obs_data_get_int(curPrivData, "color-preset");
-			const QString oldSheet = curTreeItem->styleSheet();
+			const QString oldSheet = curTreeItem ? curTreeItem->styleSheet() : QString();
 
 			auto liveChangeColor = [=](const QColor &color) {
-				if (color.isValid()) {
+				if (color.isValid() && curTreeItem) {
 					curTreeItem->setStyleSheet("background: " + color.name(QColor::HexArgb));
 				}
 			};
@@ -9405,6 +9488,9 @@ void OBSBasic::ColorChange()
 			};
 
 			auto rejected = [=]() {
+				if (!curTreeItem)
+					return;
+
 				if (oldPreset == 1) {
 					curTreeItem->setStyleSheet(oldSheet);
 					curTreeItem->setProperty("bgColor", 0);
@@ -9439,10 +9525,12 @@ void OBSBasic::ColorChange()
 		} else {
 			for (int x = 0; x < selectedItems.count(); x++) {
 				SourceTreeItem *treeItem = ui->sources->GetItemWidget(selectedItems[x].row());
-				treeItem->setStyleSheet("background: none");
-				treeItem->setProperty("bgColor", preset);
-				treeItem->style()->unpolish(treeItem);
-				treeItem->style()->polish(treeItem);
+				if (treeItem) {
+					treeItem->setStyleSheet("background: none");
+					treeItem->setProperty("bgColor", preset);
+					treeItem->style()->unpolish(treeItem);
+					treeItem->style()->polish(treeItem);
+				}
 
 				OBSSceneItem sceneItem = ui->sources->Get(selectedItems[x].row());
 				OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
@@ -9455,17 +9543,13 @@ void OBSBasic::ColorChange()
 
 SourceTreeItem *OBSBasic::GetItemWidgetFromSceneItem(obs_sceneitem_t *sceneItem)
 {
-	int i = 0;
-	SourceTreeItem *treeItem = ui->sources->GetItemWidget(i);
-	OBSSceneItem item = ui->sources->Get(i);
 	int64_t id = obs_sceneitem_get_id(sceneItem);
-	while (treeItem && obs_sceneitem_get_id(item) != id) {
-		i++;
-		treeItem = ui->sources->GetItemWidget(i);
-		item = ui->sources->Get(i);
+	OBSSceneItem item;
+
+	for (int i = 0; !!(item = ui->sources->Get(i)); i++) {
+		if (obs_sceneitem_get_id(item) == id)
+			return ui->sources->GetItemWidget(i);
 	}
-	if (treeItem)
-		return treeItem;
 
 	return nullptr;
 }
@@ -9887,6 +9971,17 @@ const char *OBSBasic::GetCurrentOutputPath()
 	return path;
 }
 
+void OBSBasic::UpdateStatsSources()
+{
+	if (!statsCollector)
+		return;
+
+	OBSOutputAutoRelease strOutput = obs_frontend_get_streaming_output();
+	OBSOutputAutoRelease recOutput = obs_frontend_get_recording_output();
+
+	statsCollector->SetSources(GetCurrentOutputPath(), strOutput, recOutput);
+}
+
 void OBSBasic::OutputPathInvalidMessage()
 {
 	blog(LOG_ERROR, "Recording stopped because of bad output path");
@@ -43,6 +43,8 @@
 #include "auth-base.hpp"
 #include "log-viewer.hpp"
 #include "undo-stack-obs.hpp"
+#include "saved-source-cache.hpp"
+#include "stats-collector.hpp"
 
 #include <obs-frontend-internal.hpp>
 
@@ -252,6 +254,8 @@ private:
 	bool loaded = false;
 	long disableSaving = 1;
 	bool projectChanged = false;
+	SavedSourceCache savedSources;
+	std::future<void> saveTask;
 	bool previewEnabled = true;
 	ContextBarSize contextBarSize = ContextBarSize_Normal;
 
@@ -294,6 +298,7 @@ private:
 	bool recent_nudge = false;
 
 	os_cpu_usage_info_t *cpuUsageInfo = nullptr;
+	std::unique_ptr<StatsCollector> statsCollector;
 
 	OBSService service;
 	std::unique_ptr<BasicOutputHandler> outputHandler;
@@ -393,6 +398,7 @@ private:
 	void UploadLog(const char *subdir, const char *file, const bool crash);
 
 	void Save(const char *file);
+	void WaitForSave();
 	void LoadData(obs_data_t *data, const char *file, bool remigrate = false);
 	void Load(const char *file, bool remigrate = false);
 
@@ -933,6 +939,7 @@ public:
 	inline bool SavingDisabled() const { return disableSaving; }
 
 	inline double GetCPUUsage() const { return os_cpu_usage_info_query(cpuUsageInfo); }
+	inline StatsCollector *GetStatsCollector() const { return statsCollector.get(); }
 
 	void SaveService();
 	bool LoadService();
@@ -978,6 +985,7 @@ public:
 	static OBSBasic *Get();
 
 	const char *GetCurrentOutputPath();
+	void UpdateStatsSources();
 
 	void DeleteProjector(OBSProjector *projector);
 
@@ -1003,6 +1011,7 @@ public:
 
 	static OBSData BackupScene(obs_scene_t *scene, std::vector<obs_source_t *> *sources = nullptr);
 	void CreateSceneUndoRedoAction(const QString &action_name, OBSData undo_data, OBSData redo_data);
+	void CreateTransformUndoRedoAction(const QString &action_name, obs_data_t *undo_data, obs_data_t *redo_data);
 
 	static inline OBSData BackupScene(obs_source_t *scene_source, std::vector<obs_source_t *> *sources = nullptr)
 	{
@@ -779,22 +779,10 @@ void OBSBasicPreview::mouseReleaseEvent(QMouseEvent *event)
 	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(main->GetCurrentScene(), true);
 
-	auto undo_redo = [](const std::string &data) {
-		OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
-		OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
-		reinterpret_cast<OBSBasic *>(App()->GetMainWindow())->SetCurrentScene(source.Get(), true);
-
-		obs_scene_load_transform_states(data.c_str());
-	};
-
-	if (wrapper && rwrapper) {
-		std::string undo_data(obs_data_get_json(wrapper));
-		std::string redo_data(obs_data_get_json(rwrapper));
-		if (changed && undo_data.compare(redo_data) != 0)
-			main->undo_s.add_action(
-				QTStr("Undo.Transform").arg(obs_source_get_name(main->GetCurrentSceneSource())),
-				undo_redo, undo_redo, undo_data, redo_data);
-	}
+	if (wrapper && rwrapper && changed)
+		main->CreateTransformUndoRedoAction(
+			QTStr("Undo.Transform").arg(obs_source_get_name(main->GetCurrentSceneSource())), wrapper,
+			rwrapper);
 
 	wrapper = nullptr;
 }
@@ -15,7 +15,6 @@
 
 #include <string>
 
-#define TIMER_INTERVAL 2000
 #define REC_TIME_LEFT_INTERVAL 30000
 
 void OBSBasicStats::OBSFrontendEvent(enum obs_frontend_event event, void *ptr)
@@ -51,18 +50,13 @@ static QString MakeMissedFramesText(uint32_t total_lagged, uint32_t total_render
 		.arg(QString::number(total_lagged), QString::number(total_rendered), QString::number(num, 'f', 1));
 }
 
-OBSBasicStats::OBSBasicStats(QWidget *parent, bool closable)
-	: QFrame(parent),
-	  cpu_info(os_cpu_usage_info_start()),
-	  timer(this),
-	  recTimeLeft(this)
+OBSBasicStats::OBSBasicStats(QWidget *parent, bool closable) : QFrame(parent), recTimeLeft(this)
 {
+	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
 	QVBoxLayout *mainLayout = new QVBoxLayout();
 	QGridLayout *topLayout = new QGridLayout();
 	outputLayout = new QGridLayout();
 
-	bitrates.reserve(REC_TIME_LEFT_INTERVAL / TIMER_INTERVAL);
-
 	int row = 0;
 
 	auto newStatBare = [&](QString name, QWidget *label, int col) {
@@ -181,19 +175,16 @@ OBSBasicStats::OBSBasicStats(QWidget *parent, bool closable)
 	setWindowModality(Qt::NonModal);
 	setAttribute(Qt::WA_DeleteOnClose, true);
 
-	QObject::connect(&timer, &QTimer::timeout, this, &OBSBasicStats::Update);
-	timer.setInterval(TIMER_INTERVAL);
-
-	if (isVisible())
-		timer.start();
+	/* the stats are collected on a background thread, this only displays
+	 * each new snapshot */
+	if (StatsCollector *collector = main->GetStatsCollector())
+		QObject::connect(collector, &StatsCollector::Updated, this, &OBSBasicStats::Update);
 
 	Update();
 
 	QObject::connect(&recTimeLeft, &QTimer::timeout, this, &OBSBasicStats::RecordingTimeLeft);
 	recTimeLeft.setInterval(REC_TIME_LEFT_INTERVAL);
 
-	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
-
 	const char *geometry = config_get_string(main->Config(), "Stats", "geometry");
 	if (geometry != NULL) {
 		QByteArray byteArray = QByteArray::fromBase64(QByteArray(geometry));
@@ -230,7 +221,6 @@ void OBSBasicStats::closeEvent(QCloseEvent *event)
 OBSBasicStats::~OBSBasicStats()
 {
 	delete shortcutFilter;
-	os_cpu_usage_info_destroy(cpu_info);
 }
 
 void OBSBasicStats::AddOutputLabels(QString name)
@@ -270,22 +260,19 @@ void OBSBasicStats::Update()
 {
 	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
 
-	/* TODO: Un-hardcode */
-
-	struct obs_video_info ovi = {};
-	obs_get_video_info(&ovi);
-
-	OBSOutputAutoRelease strOutput = obs_frontend_get_streaming_output();
-	OBSOutputAutoRelease recOutput = obs_frontend_get_recording_output();
+	StatsCollector *collector = main->GetStatsCollector();
+	if (!isVisible() || !collector)
+		return;
 
-	if (!strOutput && !recOutput)
+	std::shared_ptr<const obs_frontend_stats> stats = collector->GetSnapshot();
+	if (!stats)
 		return;
 
 	/* ------------------------------------------- */
 	/* general usage                               */
 
-	double curFPS = obs_get_active_fps();
-	double obsFPS = (double)ovi.fps_num / (double)ovi.fps_den;
+	double curFPS = stats->active_fps;
+	double obsFPS = stats->target_fps;
 
 	QString str = QString::number(curFPS, 'f', 2);
 	fps->setText(str);
@@ -299,18 +286,15 @@ void OBSBasicStats::Update()
 
 	/* ------------------ */
 
-	double usage = os_cpu_usage_info_query(cpu_info);
-	str = QString::number(usage, 'g', 2) + QStringLiteral("%");
+	str = QString::number(stats->cpu_usage, 'g', 2) + QStringLiteral("%");
 	cpuUsage->setText(str);
 
 	/* ------------------ */
 
-	const char *path = main->GetCurrentOutputPath();
-
 #define MBYTE (1024ULL * 1024ULL)
 #define GBYTE (1024ULL * 1024ULL * 1024ULL)
 #define TBYTE (1024ULL * 1024ULL * 1024ULL * 1024ULL)
-	num_bytes = os_get_free_disk_space(path);
+	num_bytes = stats->free_disk_space;
 	QString abrv = QStringLiteral(" MB");
 	long double num;
 
@@ -335,19 +319,19 @@ void OBSBasicStats::Update()
 
 	/* ------------------ */
 
-	num = (long double)os_get_proc_resident_size() / (1024.0l * 1024.0l);
+	num = (long double)stats->memory_usage / (1024.0l * 1024.0l);
 
 	str = QString::number(num, 'f', 1) + QStringLiteral(" MB");
 	memUsage->setText(str);
 
 	/* ------------------ */
 
-	num = (long double)obs_get_average_frame_time_ns() / 1000000.0l;
+	num = (long double)stats->average_frame_time_ns / 1000000.0l;
 
 	str = QString::number(num, 'f', 1) + QStringLiteral(" ms");
 	renderTime->setText(str);
 
-	long double fpsFrameTime = (long double)ovi.fps_den * 1000.0l / (long double)ovi.fps_num;
+	long double fpsFrameTime = obsFPS > 0.0 ? 1000.0l / (long double)obsFPS : 0.0l;
 
 	if (num > fpsFrameTime)
 		setClasses(renderTime, "text-danger");
@@ -358,9 +342,8 @@ void OBSBasicStats::Update()
 
 	/* ------------------ */
 
-	video_t *video = obs_get_video();
-	uint32_t total_encoded = video_output_get_total_frames(video);
-	uint32_t total_skipped = video_output_get_skipped_frames(video);
+	uint32_t total_encoded = stats->encoded_frames;
+	uint32_t total_skipped = stats->skipped_frames;
 
 	if (total_encoded < first_encoded || total_skipped < first_skipped) {
 		first_encoded = total_encoded;
@@ -386,8 +369,8 @@ void OBSBasicStats::Update()
 
 	/* ------------------ */
 
-	uint32_t total_rendered = obs_get_total_frames();
-	uint32_t total_lagged = obs_get_lagged_frames();
+	uint32_t total_rendered = stats->rendered_frames;
+	uint32_t total_lagged = stats->lagged_frames;
 
 	if (total_rendered < first_rendered || total_lagged < first_lagged) {
 		first_rendered = total_rendered;
@@ -412,13 +395,11 @@ void OBSBasicStats::Update()
 	/* ------------------------------------------- */
 	/* recording/streaming stats                   */
 
-	outputLabels[0].Update(strOutput, false);
-	outputLabels[1].Update(recOutput, true);
+	outputLabels[0].Update(stats->streaming, false);
+	outputLabels[1].Update(stats->recording, true);
 
-	if (obs_output_active(recOutput)) {
-		long double kbps = outputLabels[1].kbps;
-		bitrates.push_back(kbps);
-	}
+	if (stats->recording.active)
+		bitrates.push_back(stats->recording.kbps);
 }
 
 void OBSBasicStats::StartRecTimeLeft()
@@ -464,48 +445,34 @@ void OBSBasicStats::RecordingTimeLeft()
 
 void OBSBasicStats::Reset()
 {
-	timer.start();
+	OBSBasic *main = reinterpret_cast<OBSBasic *>(App()->GetMainWindow());
 
 	first_encoded = 0xFFFFFFFF;
 	first_skipped = 0xFFFFFFFF;
 	first_rendered = 0xFFFFFFFF;
 	first_lagged = 0xFFFFFFFF;
 
-	OBSOutputAutoRelease strOutput = obs_frontend_get_streaming_output();
-	OBSOutputAutoRelease recOutput = obs_frontend_get_recording_output();
+	outputLabels[0].Reset();
+	outputLabels[1].Reset();
 
-	outputLabels[0].Reset(strOutput);
-	outputLabels[1].Reset(recOutput);
-	Update();
+	/* the counters are rebased on the next snapshot */
+	if (StatsCollector *collector = main->GetStatsCollector())
+		collector->Refresh();
 }
 
-void OBSBasicStats::OutputLabels::Update(obs_output_t *output, bool rec)
+void OBSBasicStats::OutputLabels::Update(const obs_frontend_output_stats &stats, bool rec)
 {
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	uint64_t curTime = os_gettime_ns();
-	uint64_t bytesSent = totalBytes;
-
-	if (bytesSent < lastBytesSent)
-		bytesSent = 0;
-	if (bytesSent == 0)
-		lastBytesSent = 0;
-
-	uint64_t bitsBetween = (bytesSent - lastBytesSent) * 8;
-	long double timePassed = (long double)(curTime - lastBytesSentTime) / 1000000000.0l;
-	kbps = (long double)bitsBetween / timePassed / 1000.0l;
-
-	if (timePassed < 0.01l)
-		kbps = 0.0l;
+	uint64_t totalBytes = stats.total_bytes;
 
 	QString str = QTStr("Basic.Stats.Status.Inactive");
 	QString styling;
-	bool active = output ? obs_output_active(output) : false;
+	bool active = stats.active;
 	if (rec) {
 		if (active)
 			str = QTStr("Basic.Stats.Status.Recording");
 	} else {
 		if (active) {
-			bool reconnecting = output ? obs_output_reconnecting(output) : false;
+			bool reconnecting = stats.reconnecting;
 
 			if (reconnecting) {
 				str = QTStr("Basic.Stats.Status.Reconnecting");
@@ -528,7 +495,7 @@ void OBSBasicStats::OutputLabels::Update(obs_output_t *output, bool rec)
 	}
 	megabytesSent->setText(QString("%1 %2").arg(num, 0, 'f', 1).arg(unit));
 
-	num = kbps;
+	num = stats.kbps;
 	unit = "kb/s";
 	if (num >= 10'000) {
 		num /= 1000;
@@ -537,8 +504,14 @@ void OBSBasicStats::OutputLabels::Update(obs_output_t *output, bool rec)
 	bitrate->setText(QString("%1 %2").arg(num, 0, 'f', 0).arg(unit));
 
 	if (!rec) {
-		int total = output ? obs_output_get_total_frames(output) : 0;
-		int dropped = output ? obs_output_get_frames_dropped(output) : 0;
+		int total = stats.total_frames;
+		int dropped = stats.dropped_frames;
+
+		if (reset) {
+			first_total = total;
+			first_dropped = dropped;
+			reset = false;
+		}
 
 		if (total < first_total || dropped < first_dropped) {
 			first_total = 0;
@@ -562,25 +535,9 @@ void OBSBasicStats::OutputLabels::Update(obs_output_t *output, bool rec)
 			setClasses(droppedFrames, "");
 	}
 
-	lastBytesSent = bytesSent;
-	lastBytesSentTime = curTime;
-}
-
-void OBSBasicStats::OutputLabels::Reset(obs_output_t *output)
-{
-	if (!output)
-		return;
-
-	first_total = obs_output_get_total_frames(output);
-	first_dropped = obs_output_get_frames_dropped(output);
 }
 
 void OBSBasicStats::showEvent(QShowEvent *)
 {
-	timer.start(TIMER_INTERVAL);
-}
-
-void OBSBasicStats::hideEvent(QHideEvent *)
-{
-	timer.stop();
+	Update();
 }
@@ -27,9 +27,6 @@ class OBSBasicStats : public QFrame {
 
 	QGridLayout *outputLayout = nullptr;
 
-	os_cpu_usage_info_t *cpu_info = nullptr;
-
-	QTimer timer;
 	QTimer recTimeLeft;
 	uint64_t num_bytes = 0;
 	std::vector<long double> bitrates;
@@ -41,16 +38,12 @@ class OBSBasicStats : public QFrame {
 		QPointer<QLabel> megabytesSent;
 		QPointer<QLabel> bitrate;
 
-		uint64_t lastBytesSent = 0;
-		uint64_t lastBytesSentTime = 0;
-
 		int first_total = 0;
 		int first_dropped = 0;
+		bool reset = false;
 
-		void Update(obs_output_t *output, bool rec);
-		void Reset(obs_output_t *output);
-
-		long double kbps = 0.0l;
+		void Update(const obs_frontend_output_stats &stats, bool rec);
+		void Reset() { reset = true; }
 	};
 
 	QList<OutputLabels> outputLabels;
@@ -82,5 +75,4 @@ public slots:
 
 protected:
 	virtual void showEvent(QShowEvent *event) override;
-	virtual void hideEvent(QHideEvent *event) override;
 };
@@ -76,28 +76,18 @@ OBSBasicTransform::OBSBasicTransform(OBSSceneItem item, OBSBasic *parent)
 	std::string name = obs_source_get_name(obs_sceneitem_get_source(item));
 	setWindowTitle(QTStr("Basic.TransformWindow.Title").arg(name.c_str()));
 
-	OBSDataAutoRelease wrapper = obs_scene_save_transform_states(main->GetCurrentScene(), false);
-	undo_data = std::string(obs_data_get_json(wrapper));
+	undo_data = obs_scene_save_transform_states(main->GetCurrentScene(), false);
 
 	channelChangedSignal.Connect(obs_get_signal_handler(), "channel_change", OBSChannelChanged, this);
 }
 
 OBSBasicTransform::~OBSBasicTransform()
 {
-	OBSDataAutoRelease wrapper = obs_scene_save_transform_states(main->GetCurrentScene(), false);
-
-	auto undo_redo = [](const std::string &data) {
-		OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
-		OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
-		reinterpret_cast<OBSBasic *>(App()->GetMainWindow())->SetCurrentScene(source.Get(), true);
-		obs_scene_load_transform_states(data.c_str());
-	};
-
-	std::string redo_data(obs_data_get_json(wrapper));
-	if (undo_data.compare(redo_data) != 0)
-		main->undo_s.add_action(
-			QTStr("Undo.Transform").arg(obs_source_get_name(obs_scene_get_source(main->GetCurrentScene()))),
-			undo_redo, undo_redo, undo_data, redo_data);
+	OBSDataAutoRelease redo_data = obs_scene_save_transform_states(main->GetCurrentScene(), false);
+
+	main->CreateTransformUndoRedoAction(
+		QTStr("Undo.Transform").arg(obs_source_get_name(obs_scene_get_source(main->GetCurrentScene()))),
+		undo_data, redo_data);
 }
 
 void OBSBasicTransform::SetScene(OBSScene scene)
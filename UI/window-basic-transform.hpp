@@ -19,7 +19,7 @@ private:
 	OBSSignal channelChangedSignal;
 	std::vector<OBSSignal> sigs;
 
-	std::string undo_data;
+	OBSDataAutoRelease undo_data;
 
 	bool ignoreTransformSignal = false;
 	bool ignoreItemChange = false;
@@ -0,0 +1,497 @@
+/******************************************************************************
+    Copyright (C) 2026 by OBS Studio contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "../util/platform.h"
+#include "../util/threading.h"
+#include "../util/file-serializer.h"
+#include "../util/dstr.h"
+#include "../util/darray.h"
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <time.h>
+#include "effect-cache.h"
+
+#define EFFECT_CACHE_MAGIC 0x4346454F /* "OEFC" */
+
+/* changed effects get a new key rather than replacing their entry, so the
+ * directory is pruned whenever the cache is enabled.  entries are aged by
+ * when they were written, a pruned entry that's still used is just written
+ * again. */
+#define EFFECT_CACHE_MAX_ENTRIES 1024
+#define EFFECT_CACHE_MAX_AGE_SEC (30 * 24 * 60 * 60)
+
+static pthread_mutex_t cache_path_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char *cache_path = NULL;
+
+struct cache_entry_file {
+	char *path;
+	time_t mtime;
+};
+
+static int cmp_entry_mtime(const void *a, const void *b)
+{
+	const struct cache_entry_file *ea = a;
+	const struct cache_entry_file *eb = b;
+
+	return ea->mtime < eb->mtime ? 1 : (ea->mtime > eb->mtime ? -1 : 0);
+}
+
+static void prune_cache(const char *dir_path)
+{
+	DARRAY(struct cache_entry_file) entries;
+	time_t now = time(NULL);
+	size_t removed = 0;
+	struct os_dirent *ent;
+	struct dstr path = {0};
+	os_dir_t *dir;
+
+	dir = os_opendir(dir_path);
+	if (!dir)
+		return;
+
+	da_init(entries);
+
+	while ((ent = os_readdir(dir)) != NULL) {
+		struct cache_entry_file entry;
+		struct stat st;
+
+		const char *ext = os_get_path_extension(ent->d_name);
+
+		if (ent->directory || !ext || strcmp(ext, ".effcache") != 0)
+			continue;
+
+		dstr_printf(&path, "%s/%s", dir_path, ent->d_name);
+		if (os_stat(path.array, &st) != 0)
+			continue;
+
+		if (now - st.st_mtime > EFFECT_CACHE_MAX_AGE_SEC) {
+			if (os_unlink(path.array) == 0)
+				removed++;
+			continue;
+		}
+
+		entry.path = bstrdup(path.array);
+		entry.mtime = st.st_mtime;
+		da_push_back(entries, &entry);
+	}
+
+	os_closedir(dir);
+	dstr_free(&path);
+
+	/* newest first, anything past the limit goes */
+	qsort(entries.array, entries.num, sizeof(*entries.array), cmp_entry_mtime);
+
+	for (size_t i = 0; i < entries.num; i++) {
+		if (i >= EFFECT_CACHE_MAX_ENTRIES && os_unlink(entries.array[i].path) == 0)
+			removed++;
+		bfree(entries.array[i].path);
+	}
+	da_free(entries);
+
+	if (removed)
+		blog(LOG_DEBUG, "Removed %zu old effect cache entries", removed);
+}
+
+void gs_effect_set_cache_path(const char *path)
+{
+	pthread_mutex_lock(&cache_path_mutex);
+	bfree(cache_path);
+	cache_path = NULL;
+
+	if (path && *path) {
+		if (os_mkdirs(path) == MKDIR_ERROR)
+			blog(LOG_WARNING, "Failed to create effect cache directory '%s'", path);
+		else
+			cache_path = bstrdup(path);
+	}
+	pthread_mutex_unlock(&cache_path_mutex);
+
+	if (path && *path)
+		prune_cache(path);
+}
+
+/* ------------------------------------------------------------------------- */
+/* FNV-1a, used for both the cache key and the include file hashes */
+
+#define FNV_OFFSET 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+static inline uint64_t hash_data(uint64_t hash, const void *data, size_t size)
+{
+	const uint8_t *bytes = data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static inline uint64_t hash_str(uint64_t hash, const char *str)
+{
+	/* include the terminator so that adjacent strings can't alias */
+	return str ? hash_data(hash, str, strlen(str) + 1) : hash_data(hash, "", 1);
+}
+
+static uint64_t get_cache_key(const char *file, const char *effect_string, const char *preprocessor)
+{
+	uint32_t version = EFFECT_CACHE_VERSION;
+	uint64_t hash = FNV_OFFSET;
+
+	hash = hash_data(hash, &version, sizeof(version));
+	hash = hash_str(hash, preprocessor);
+	hash = hash_str(hash, file);
+	hash = hash_str(hash, effect_string);
+	return hash;
+}
+
+static char *get_cache_file(uint64_t key)
+{
+	struct dstr path = {0};
+
+	pthread_mutex_lock(&cache_path_mutex);
+	if (cache_path) {
+		dstr_copy(&path, cache_path);
+		dstr_replace(&path, "\\", "/");
+		if (dstr_end(&path) != '/')
+			dstr_cat_ch(&path, '/');
+		dstr_catf(&path, "%016llx.effcache", (unsigned long long)key);
+	}
+	pthread_mutex_unlock(&cache_path_mutex);
+
+	return path.array;
+}
+
+/* ------------------------------------------------------------------------- */
+/* writing */
+
+static void write_str(struct serializer *s, const char *str)
+{
+	uint32_t len = str ? (uint32_t)strlen(str) : 0;
+	s_wl32(s, len);
+	s_write(s, str, len);
+}
+
+static void write_str_array(struct serializer *s, const dstr_array_t *strs)
+{
+	s_wl32(s, (uint32_t)strs->num);
+	for (size_t i = 0; i < strs->num; i++)
+		write_str(s, strs->array[i].array);
+}
+
+static void write_param(struct serializer *s, const struct ep_param *param)
+{
+	write_str(s, param->name);
+	write_str(s, param->type);
+
+	s_wl32(s, (uint32_t)param->default_val.num);
+	s_write(s, param->default_val.array, param->default_val.num);
+
+	s_wl32(s, (uint32_t)param->annotations.num);
+	for (size_t i = 0; i < param->annotations.num; i++)
+		write_param(s, param->annotations.array + i);
+}
+
+static void write_pass(struct serializer *s, const struct ep_pass *pass)
+{
+	write_str(s, pass->name);
+	write_str(s, pass->vertex_shader.array);
+	write_str_array(s, &pass->vertex_params);
+	write_str(s, pass->pixel_shader.array);
+	write_str_array(s, &pass->pixel_params);
+}
+
+static void write_technique(struct serializer *s, const struct ep_technique *tech)
+{
+	write_str(s, tech->name);
+
+	s_wl32(s, (uint32_t)tech->passes.num);
+	for (size_t i = 0; i < tech->passes.num; i++)
+		write_pass(s, tech->passes.array + i);
+}
+
+void ep_cache_save(struct effect_parser *ep, const char *effect_string, const char *preprocessor)
+{
+	DARRAY(struct cf_lexer) *deps = (void *)&ep->cfp.pp.dependencies;
+	uint64_t key = get_cache_key(ep->file, effect_string, preprocessor);
+	char *path = get_cache_file(key);
+	struct serializer s;
+
+	if (!path)
+		return;
+
+	if (!file_output_serializer_init_safe(&s, path, "tmp")) {
+		blog(LOG_DEBUG, "Could not write effect cache file '%s'", path);
+		bfree(path);
+		return;
+	}
+
+	s_wl32(&s, EFFECT_CACHE_MAGIC);
+	s_wl32(&s, EFFECT_CACHE_VERSION);
+	s_wl64(&s, key);
+
+	s_wl32(&s, (uint32_t)deps->num);
+	for (size_t i = 0; i < deps->num; i++) {
+		struct cf_lexer *dep = deps->array + i;
+		write_str(&s, dep->file);
+		s_wl64(&s, hash_str(FNV_OFFSET, dep->base_lexer.text));
+	}
+
+	s_wl32(&s, (uint32_t)ep->params.num);
+	for (size_t i = 0; i < ep->params.num; i++)
+		write_param(&s, ep->params.array + i);
+
+	s_wl32(&s, (uint32_t)ep->techniques.num);
+	for (size_t i = 0; i < ep->techniques.num; i++)
+		write_technique(&s, ep->techniques.array + i);
+
+	s_wl32(&s, EFFECT_CACHE_MAGIC);
+
+	file_output_serializer_free(&s);
+	bfree(path);
+}
+
+/* ------------------------------------------------------------------------- */
+/* reading */
+
+struct cache_reader {
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+	bool error;
+};
+
+static inline bool read_data(struct cache_reader *r, void *out, size_t size)
+{
+	if (r->error || size > r->size - r->pos) {
+		r->error = true;
+		return false;
+	}
+
+	memcpy(out, r->data + r->pos, size);
+	r->pos += size;
+	return true;
+}
+
+static inline uint32_t read_u32(struct cache_reader *r)
+{
+	uint8_t b[4] = {0};
+	read_data(r, b, sizeof(b));
+	return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static inline uint64_t read_u64(struct cache_reader *r)
+{
+	uint64_t lo = read_u32(r);
+	uint64_t hi = read_u32(r);
+	return lo | (hi << 32);
+}
+
+/* returns NULL for empty strings, matching what the parser produces */
+static char *read_str(struct cache_reader *r)
+{
+	uint32_t len = read_u32(r);
+	char *str;
+
+	if (r->error || !len)
+		return NULL;
+	if (len > r->size - r->pos) {
+		r->error = true;
+		return NULL;
+	}
+
+	str = bmalloc(len + 1);
+	read_data(r, str, len);
+	str[len] = 0;
+	return str;
+}
+
+static void read_dstr(struct cache_reader *r, struct dstr *dst)
+{
+	char *str = read_str(r);
+
+	dstr_free(dst);
+	if (str) {
+		dst->array = str;
+		dst->len = strlen(str);
+		dst->capacity = dst->len + 1;
+	}
+}
+
+/* bounds array counts by the remaining data so corrupt files can't cause
+ * huge allocations */
+static inline uint32_t read_count(struct cache_reader *r)
+{
+	uint32_t count = read_u32(r);
+	if (count > r->size - r->pos) {
+		r->error = true;
+		return 0;
+	}
+	return count;
+}
+
+static void read_str_array(struct cache_reader *r, dstr_array_t *strs)
+{
+	uint32_t count = read_count(r);
+
+	for (uint32_t i = 0; i < count && !r->error; i++) {
+		struct dstr *str = da_push_back_new(*strs);
+		read_dstr(r, str);
+	}
+}
+
+static void read_param(struct cache_reader *r, struct ep_param *param)
+{
+	char *name = read_str(r);
+	char *type = read_str(r);
+	uint32_t count;
+
+	ep_param_init(param, type, name, false, false, false);
+	if (!name || !type)
+		r->error = true;
+
+	count = read_count(r);
+	if (!r->error && count) {
+		da_resize(param->default_val, count);
+		read_data(r, param->default_val.array, count);
+	}
+
+	count = read_count(r);
+	for (uint32_t i = 0; i < count && !r->error; i++)
+		read_param(r, da_push_back_new(param->annotations));
+}
+
+static void read_pass(struct cache_reader *r, struct ep_pass *pass)
+{
+	ep_pass_init(pass);
+	pass->name = read_str(r);
+	read_dstr(r, &pass->vertex_shader);
+	read_str_array(r, &pass->vertex_params);
+	read_dstr(r, &pass->pixel_shader);
+	read_str_array(r, &pass->pixel_params);
+}
+
+static void read_technique(struct cache_reader *r, struct ep_technique *tech)
+{
+	uint32_t count;
+
+	ep_technique_init(tech);
+	tech->name = read_str(r);
+
+	count = read_count(r);
+	for (uint32_t i = 0; i < count && !r->error; i++)
+		read_pass(r, da_push_back_new(tech->passes));
+}
+
+static bool dependencies_valid(struct cache_reader *r)
+{
+	uint32_t count = read_count(r);
+
+	for (uint32_t i = 0; i < count && !r->error; i++) {
+		char *dep_path = read_str(r);
+		uint64_t hash = read_u64(r);
+		char *text = dep_path ? os_quick_read_utf8_file(dep_path) : NULL;
+		bool valid = text && hash_str(FNV_OFFSET, text) == hash;
+
+		bfree(text);
+		bfree(dep_path);
+
+		if (!valid)
+			return false;
+	}
+
+	return !r->error;
+}
+
+static uint8_t *read_cache_file(const char *path, size_t *size)
+{
+	FILE *f = os_fopen(path, "rb");
+	uint8_t *data = NULL;
+	int64_t file_size;
+
+	if (!f)
+		return NULL;
+
+	file_size = os_fgetsize(f);
+	if (file_size > 0) {
+		data = bmalloc((size_t)file_size);
+		if (fread(data, 1, (size_t)file_size, f) != (size_t)file_size) {
+			bfree(data);
+			data = NULL;
+		}
+	}
+
+	fclose(f);
+	*size = (size_t)file_size;
+	return data;
+}
+
+static void ep_clear_built(struct effect_parser *ep)
+{
+	for (size_t i = 0; i < ep->params.num; i++)
+		ep_param_free(ep->params.array + i);
+	for (size_t i = 0; i < ep->techniques.num; i++)
+		ep_technique_free(ep->techniques.array + i);
+
+	da_free(ep->params);
+	da_free(ep->techniques);
+}
+
+bool ep_cache_load(struct effect_parser *ep, const char *effect_string, const char *preprocessor)
+{
+	uint64_t key = get_cache_key(ep->file, effect_string, preprocessor);
+	char *path = get_cache_file(key);
+	struct cache_reader r = {0};
+	uint8_t *data;
+	uint32_t count;
+
+	if (!path)
+		return false;
+
+	data = read_cache_file(path, &r.size);
+	bfree(path);
+
+	if (!data)
+		return false;
+
+	r.data = data;
+
+	if (read_u32(&r) != EFFECT_CACHE_MAGIC || read_u32(&r) != EFFECT_CACHE_VERSION || read_u64(&r) != key)
+		goto fail;
+	if (!dependencies_valid(&r))
+		goto fail;
+
+	count = read_count(&r);
+	for (uint32_t i = 0; i < count && !r.error; i++)
+		read_param(&r, da_push_back_new(ep->params));
+
+	count = read_count(&r);
+	for (uint32_t i = 0; i < count && !r.error; i++)
+		read_technique(&r, da_push_back_new(ep->techniques));
+
+	if (read_u32(&r) != EFFECT_CACHE_MAGIC || r.error) {
+		blog(LOG_DEBUG, "Discarding corrupt effect cache entry for '%s'", ep->file);
+		goto fail;
+	}
+
+	bfree(data);
+	return true;
+
+fail:
+	ep_clear_built(ep);
+	bfree(data);
+	return false;
+}
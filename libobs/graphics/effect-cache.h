@@ -0,0 +1,46 @@
+/******************************************************************************
+    Copyright (C) 2026 by OBS Studio contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "effect-parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The effect cache stores the output of the CPU side of the effect parser
+ * (parameters, annotations, and the generated shader text of every pass) in
+ * a versioned binary file.  Entries are keyed by a hash of the effect file
+ * path, its contents, and the graphics preprocessor name, and every file
+ * pulled in via #include is validated against its stored content hash when
+ * the entry is loaded.
+ */
+
+#define EFFECT_CACHE_VERSION 1
+
+/* Loads a built effect from the cache, returns false if there is no valid
+ * entry for it */
+extern bool ep_cache_load(struct effect_parser *ep, const char *effect_string, const char *preprocessor);
+
+/* Stores a freshly built effect in the cache */
+extern void ep_cache_save(struct effect_parser *ep, const char *effect_string, const char *preprocessor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,10 +19,9 @@
 #include <limits.h>
 #include "../util/platform.h"
 #include "effect-parser.h"
+#include "effect-cache.h"
 #include "effect.h"
 
-typedef DARRAY(struct dstr) dstr_array_t;
-
 static inline bool ep_parse_param_assign(struct effect_parser *ep, struct ep_param *param);
 
 static enum gs_shader_param_type get_effect_param_type(const char *type)
@@ -69,6 +68,8 @@ void ep_free(struct effect_parser *ep)
 	for (i = 0; i < ep->techniques.num; i++)
 		ep_technique_free(ep->techniques.array + i);
 
+	bfree(ep->file);
+	ep->file = NULL;
 	ep->cur_pass = NULL;
 	cf_parser_free(&ep->cfp);
 	da_free(ep->params);
@@ -1181,8 +1182,6 @@ error:
 	bfree(name);
 }
 
-static bool ep_compile(struct effect_parser *ep);
-
 extern const char *gs_preprocessor_name(void);
 
 #if defined(_DEBUG) && defined(_DEBUG_SHADERS)
@@ -1352,24 +1351,22 @@ static void debug_print_string(const char *offset, const char *str)
 }
 #endif
 
-bool ep_parse(struct effect_parser *ep, gs_effect_t *effect, const char *effect_string, const char *file)
-{
-	bool success;
-
-	const char *graphics_preprocessor = gs_preprocessor_name();
+static void ep_build_shaders(struct effect_parser *ep);
 
-	if (graphics_preprocessor) {
+static bool ep_parse_string(struct effect_parser *ep, const char *effect_string, const char *file,
+			    const char *preprocessor)
+{
+	if (preprocessor) {
 		struct cf_def def;
 
 		cf_def_init(&def);
-		def.name.str.array = graphics_preprocessor;
-		def.name.str.len = strlen(graphics_preprocessor);
+		def.name.str.array = preprocessor;
+		def.name.str.len = strlen(preprocessor);
 
 		strref_copy(&def.name.unmerged_str, &def.name.str);
 		cf_preprocessor_add_def(&ep->cfp.pp, &def);
 	}
 
-	ep->effect = effect;
 	if (!cf_parser_parse(&ep->cfp, effect_string, file))
 		return false;
 
@@ -1404,7 +1401,38 @@ bool ep_parse(struct effect_parser *ep, gs_effect_t *effect, const char *effect_
 	debug_print_string("\t", ep->cfp.lex.reformatted);
 #endif
 
-	success = !error_data_has_errors(&ep->cfp.error_list);
+	if (error_data_has_errors(&ep->cfp.error_list))
+		return false;
+
+	ep_build_shaders(ep);
+	return true;
+}
+
+bool ep_build(struct effect_parser *ep, const char *effect_string, const char *file, const char *preprocessor)
+{
+	bfree(ep->file);
+	ep->file = bstrdup(file);
+
+	/* effects created from strings alone are often generated, so only
+	 * effects with a file name are cached */
+	if (ep->file && ep_cache_load(ep, effect_string, preprocessor))
+		return true;
+
+	if (!ep_parse_string(ep, effect_string, file, preprocessor))
+		return false;
+
+	if (ep->file)
+		ep_cache_save(ep, effect_string, preprocessor);
+	return true;
+}
+
+bool ep_parse(struct effect_parser *ep, gs_effect_t *effect, const char *effect_string, const char *file)
+{
+	bool success;
+
+	ep->effect = effect;
+
+	success = ep_build(ep, effect_string, file, gs_preprocessor_name());
 	if (success)
 		success = ep_compile(ep);
 
@@ -1721,6 +1749,20 @@ static void ep_makeshaderstring(struct effect_parser *ep, struct dstr *shader, c
 	ep_reset_written(ep);
 }
 
+static void ep_build_shaders(struct effect_parser *ep)
+{
+	for (size_t i = 0; i < ep->techniques.num; i++) {
+		struct ep_technique *tech = ep->techniques.array + i;
+
+		for (size_t j = 0; j < tech->passes.num; j++) {
+			struct ep_pass *pass = tech->passes.array + j;
+
+			ep_makeshaderstring(ep, &pass->vertex_shader, &pass->vertex_program, &pass->vertex_params);
+			ep_makeshaderstring(ep, &pass->pixel_shader, &pass->fragment_program, &pass->pixel_params);
+		}
+	}
+}
+
 static void ep_compile_annotations(ep_param_array_t *ep_annotations, gs_effect_param_array_t *gsp_annotations,
 				   struct effect_parser *ep)
 {
@@ -1804,23 +1846,37 @@ static bool ep_compile_pass_shaderparams(struct effect_parser *ep, pass_shaderpa
 	return true;
 }
 
+static void ep_add_shader_error(struct effect_parser *ep, const char *errors)
+{
+	struct dstr msg;
+
+	/* effects loaded from the cache have no tokens to point the error at */
+	if (ep->cfp.cur_token) {
+		cf_adderror(&ep->cfp, "Error creating shader: $1", LEX_ERROR, errors, NULL, NULL);
+		return;
+	}
+
+	dstr_init_copy(&msg, "Error creating shader: ");
+	dstr_cat(&msg, errors);
+	error_data_add(&ep->cfp.error_list, ep->file, 0, 0, msg.array, LEX_ERROR);
+	dstr_free(&msg);
+}
+
 static inline bool ep_compile_pass_shader(struct effect_parser *ep, struct gs_effect_technique *tech,
 					  struct gs_effect_pass *pass, struct ep_pass *pass_in, size_t pass_idx,
 					  enum gs_shader_type type)
 {
-	struct dstr shader_str;
 	struct dstr location;
-	dstr_array_t used_params;
+	dstr_array_t *used_params = NULL;
 	pass_shaderparam_array_t *pass_params = NULL;
 	gs_shader_t *shader = NULL;
+	const char *shader_str = NULL;
 	bool success = true;
 	char *errors = NULL;
 
-	dstr_init(&shader_str);
-	da_init(used_params);
 	dstr_init(&location);
 
-	dstr_copy(&location, ep->cfp.lex.file);
+	dstr_copy(&location, ep->file);
 	if (type == GS_SHADER_VERTEX)
 		dstr_cat(&location, " (Vertex ");
 	else if (type == GS_SHADER_PIXEL)
@@ -1832,42 +1888,41 @@ static inline bool ep_compile_pass_shader(struct effect_parser *ep, struct gs_ef
 	dstr_catf(&location, "shader, technique %s, pass %u)", tech->name, (unsigned)pass_idx);
 
 	if (type == GS_SHADER_VERTEX) {
-		ep_makeshaderstring(ep, &shader_str, &pass_in->vertex_program, &used_params);
+		shader_str = pass_in->vertex_shader.array;
+		used_params = &pass_in->vertex_params;
 
-		pass->vertshader = gs_vertexshader_create(shader_str.array, location.array, &errors);
+		pass->vertshader = gs_vertexshader_create(shader_str, location.array, &errors);
 
 		shader = pass->vertshader;
 		pass_params = &pass->vertshader_params;
 	} else if (type == GS_SHADER_PIXEL) {
-		ep_makeshaderstring(ep, &shader_str, &pass_in->fragment_program, &used_params);
+		shader_str = pass_in->pixel_shader.array;
+		used_params = &pass_in->pixel_params;
 
-		pass->pixelshader = gs_pixelshader_create(shader_str.array, location.array, &errors);
+		pass->pixelshader = gs_pixelshader_create(shader_str, location.array, &errors);
 
 		shader = pass->pixelshader;
 		pass_params = &pass->pixelshader_params;
 	}
 
 	if (errors && strlen(errors)) {
-		cf_adderror(&ep->cfp, "Error creating shader: $1", LEX_ERROR, errors, NULL, NULL);
+		ep_add_shader_error(ep, errors);
 	}
 	bfree(errors);
 
 #if defined(_DEBUG) && defined(_DEBUG_SHADERS)
 	blog(LOG_DEBUG, "\t\t\t%s Shader:", type == GS_SHADER_VERTEX ? "Vertex" : "Fragment");
 	blog(LOG_DEBUG, "\t\t\tCode:");
-	debug_print_string("\t\t\t\t\t", shader_str.array);
+	debug_print_string("\t\t\t\t\t", shader_str);
 	blog(LOG_DEBUG, "\t\t\tParameters:");
 #endif
 
 	if (shader)
-		success = ep_compile_pass_shaderparams(ep, pass_params, &used_params, shader);
+		success = ep_compile_pass_shaderparams(ep, pass_params, used_params, shader);
 	else
 		success = false;
 
 	dstr_free(&location);
-	dstr_array_free(used_params.array, used_params.num);
-	da_free(used_params);
-	dstr_free(&shader_str);
 
 	return success;
 }
@@ -1928,7 +1983,7 @@ static inline bool ep_compile_technique(struct effect_parser *ep, size_t idx)
 	return success;
 }
 
-static bool ep_compile(struct effect_parser *ep)
+bool ep_compile(struct effect_parser *ep)
 {
 	bool success = true;
 	size_t i;
@@ -30,6 +30,7 @@ struct dstr;
 
 typedef DARRAY(struct ep_param) ep_param_array_t;
 typedef DARRAY(struct ep_var) ep_var_array_t;
+typedef DARRAY(struct dstr) dstr_array_t;
 
 /*
  * The effect parser takes an effect file and converts it into individual
@@ -172,6 +173,10 @@ struct ep_pass {
 	cf_token_array_t vertex_program;
 	cf_token_array_t fragment_program;
 	struct gs_effect_pass *pass;
+
+	/* generated shader text and the uniforms it uses */
+	struct dstr vertex_shader, pixel_shader;
+	dstr_array_t vertex_params, pixel_params;
 };
 
 static inline void ep_pass_init(struct ep_pass *epp)
@@ -184,6 +189,13 @@ static inline void ep_pass_free(struct ep_pass *epp)
 	bfree(epp->name);
 	da_free(epp->vertex_program);
 	da_free(epp->fragment_program);
+
+	dstr_free(&epp->vertex_shader);
+	dstr_free(&epp->pixel_shader);
+	dstr_array_free(epp->vertex_params.array, epp->vertex_params.num);
+	dstr_array_free(epp->pixel_params.array, epp->pixel_params.num);
+	da_free(epp->vertex_params);
+	da_free(epp->pixel_params);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -252,6 +264,7 @@ static inline void ep_func_free(struct ep_func *epf)
 
 struct effect_parser {
 	gs_effect_t *effect;
+	char *file;
 
 	ep_param_array_t params;
 	DARRAY(struct ep_struct) structs;
@@ -277,12 +290,24 @@ static inline void ep_init(struct effect_parser *ep)
 	da_init(ep->files);
 	da_init(ep->tokens);
 
+	ep->effect = NULL;
+	ep->file = NULL;
 	ep->cur_pass = NULL;
 	cf_parser_init(&ep->cfp);
 }
 
 extern void ep_free(struct effect_parser *ep);
 
+/*
+ * Parses the effect and generates the shader text of every pass without
+ * touching the graphics subsystem.  If an effect cache path is set, the
+ * result is loaded from/stored to the cache (see effect-cache.h).
+ */
+extern bool ep_build(struct effect_parser *ep, const char *effect_string, const char *file, const char *preprocessor);
+
+/* Creates the effect's parameters, techniques and shaders from built data */
+extern bool ep_compile(struct effect_parser *ep);
+
 extern bool ep_parse(struct effect_parser *ep, gs_effect_t *effect, const char *effect_string, const char *file);
 
 #ifdef __cplusplus
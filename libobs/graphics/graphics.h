@@ -548,6 +548,14 @@ EXPORT gs_effect_t *gs_get_effect(void);
 EXPORT gs_effect_t *gs_effect_create_from_file(const char *file, char **error_string);
 EXPORT gs_effect_t *gs_effect_create(const char *effect_string, const char *filename, char **error_string);
 
+/**
+ * Sets the directory used to cache parsed effect files.  Effects created with
+ * a file name are looked up in (and added to) the cache, skipping lexing,
+ * preprocessing and shader text generation when the file is unchanged.
+ * Pass NULL to disable the cache.
+ */
+EXPORT void gs_effect_set_cache_path(const char *path);
+
 EXPORT gs_shader_t *gs_vertexshader_create_from_file(const char *file, char **error_string);
 EXPORT gs_shader_t *gs_pixelshader_create_from_file(const char *file, char **error_string);
 
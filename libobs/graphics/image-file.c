@@ -19,6 +19,9 @@
 #include "../util/base.h"
 #include "../util/platform.h"
 #include "../util/dstr.h"
+#include "../util/darray.h"
+#include "../util/threading.h"
+#include "../util/task.h"
 #include "vec4.h"
 
 #define blog(level, format, ...) blog(level, "%s: " format, __FUNCTION__, __VA_ARGS__)
@@ -55,11 +58,6 @@ static void bi_def_bitmap_modified(void *bitmap)
 	UNUSED_PARAMETER(bitmap);
 }
 
-static inline int get_full_decoded_gif_size(gs_image_file_t *image)
-{
-	return image->gif.width * image->gif.height * 4 * image->gif.frame_count;
-}
-
 static inline void *alloc_mem(gs_image_file_t *image, uint64_t *mem_usage, size_t size)
 {
 	UNUSED_PARAMETER(image);
@@ -69,12 +67,353 @@ static inline void *alloc_mem(gs_image_file_t *image, uint64_t *mem_usage, size_
 	return bzalloc(size);
 }
 
+/* ------------------------------------------------------------------------- */
+/* Animated gif frames are decoded incrementally.  Only a window of frames
+ * starting at the current frame is kept decoded, and a worker thread decodes
+ * ahead into that window while the gif plays.  The worker is the only user of
+ * the gif decoder once the image has been loaded.
+ *
+ * The workers are shared by all gifs.  Each gif is assigned to one worker so
+ * that its decoder is never used by two threads, and decodes a limited number
+ * of frames at a time before queueing itself again so that gifs sharing a
+ * worker take turns. */
+
+#define GIF_FRAME_CACHE_BUDGET (128 * 1024 * 1024)
+#define GIF_FRAME_CACHE_MIN_FRAMES 2
+#define GIF_DECODE_SLICE_FRAMES 8
+#define GIF_MAX_DECODE_WORKERS 4
+
+static struct {
+	pthread_mutex_t mutex;
+	os_task_queue_t *workers[GIF_MAX_DECODE_WORKERS];
+	size_t num_workers;
+	size_t next_worker;
+	long refs;
+} gif_decoders = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static os_task_queue_t *gif_decoder_acquire(void)
+{
+	os_task_queue_t *worker;
+
+	pthread_mutex_lock(&gif_decoders.mutex);
+
+	if (gif_decoders.refs++ == 0) {
+		int cores = os_get_logical_cores() / 2;
+
+		if (cores < 1)
+			cores = 1;
+		else if (cores > GIF_MAX_DECODE_WORKERS)
+			cores = GIF_MAX_DECODE_WORKERS;
+
+		gif_decoders.num_workers = (size_t)cores;
+		for (size_t i = 0; i < gif_decoders.num_workers; i++)
+			gif_decoders.workers[i] = os_task_queue_create();
+	}
+
+	worker = gif_decoders.workers[gif_decoders.next_worker++ % gif_decoders.num_workers];
+
+	pthread_mutex_unlock(&gif_decoders.mutex);
+	return worker;
+}
+
+/* the workers are shut down along with the last gif that uses them */
+static void gif_decoder_release(void)
+{
+	pthread_mutex_lock(&gif_decoders.mutex);
+
+	if (--gif_decoders.refs == 0) {
+		for (size_t i = 0; i < gif_decoders.num_workers; i++) {
+			os_task_queue_destroy(gif_decoders.workers[i]);
+			gif_decoders.workers[i] = NULL;
+		}
+		gif_decoders.num_workers = 0;
+	}
+
+	pthread_mutex_unlock(&gif_decoders.mutex);
+}
+
+struct gs_gif_frame_cache {
+	pthread_mutex_t mutex;
+	os_task_queue_t *decoder;
+	os_event_t *idle;
+	enum gs_image_alpha_mode alpha_mode;
+
+	/* number of frames kept decoded, starting at cur_frame */
+	int window;
+	int allocated;
+	DARRAY(uint8_t *) free_frames;
+
+	int displayed_frame;
+	bool decode_queued;
+	int pending_tasks;
+	volatile bool stop;
+};
+
+static inline size_t get_frame_size(gs_image_file_t *image)
+{
+	return (size_t)image->gif.width * image->gif.height * 4;
+}
+
+static void init_frame_cache(gs_image_file_t *image, enum gs_image_alpha_mode alpha_mode)
+{
+	struct gs_gif_frame_cache *fc = bzalloc(sizeof(*fc));
+	size_t window = GIF_FRAME_CACHE_BUDGET / get_frame_size(image);
+
+	if (window < GIF_FRAME_CACHE_MIN_FRAMES)
+		window = GIF_FRAME_CACHE_MIN_FRAMES;
+	if (window > image->gif.frame_count)
+		window = image->gif.frame_count;
+
+	pthread_mutex_init(&fc->mutex, NULL);
+	os_event_init(&fc->idle, OS_EVENT_TYPE_AUTO);
+	fc->alpha_mode = alpha_mode;
+	fc->window = (int)window;
+	image->frame_cache = fc;
+}
+
+static void free_frame_cache(gs_image_file_t *image)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+
+	if (!fc)
+		return;
+
+	/* queued tasks return as soon as they see the stop flag, but they
+	 * still have to be waited for as the workers are shared */
+	os_atomic_set_bool(&fc->stop, true);
+
+	pthread_mutex_lock(&fc->mutex);
+	while (fc->pending_tasks) {
+		pthread_mutex_unlock(&fc->mutex);
+		os_event_wait(fc->idle);
+		pthread_mutex_lock(&fc->mutex);
+	}
+	pthread_mutex_unlock(&fc->mutex);
+
+	if (fc->decoder)
+		gif_decoder_release();
+
+	for (unsigned int i = 0; i < image->gif.frame_count; i++)
+		bfree(image->animation_frame_cache[i]);
+	for (size_t i = 0; i < fc->free_frames.num; i++)
+		bfree(fc->free_frames.array[i]);
+
+	da_free(fc->free_frames);
+	os_event_destroy(fc->idle);
+	pthread_mutex_destroy(&fc->mutex);
+	bfree(fc);
+	image->frame_cache = NULL;
+}
+
+static inline int frame_distance(gs_image_file_t *image, int from, int to)
+{
+	const int count = (int)image->gif.frame_count;
+	return (to - from + count) % count;
+}
+
+/* must be called with the frame cache mutex held */
+static bool frame_wanted(gs_image_file_t *image, int frame)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	int displayed = fc->displayed_frame;
+
+	if (frame_distance(image, image->cur_frame, frame) < fc->window)
+		return true;
+
+	/* frames decoded too late to be shown on time are still kept if they
+	 * are newer than what is on screen, so a decoder that can't keep up
+	 * drops frames instead of stalling playback */
+	if (displayed < 0 || frame == displayed)
+		return false;
+	return frame_distance(image, displayed, frame) < frame_distance(image, displayed, image->cur_frame);
+}
+
+/* returns the newest decoded frame that hasn't been displayed yet, up to and
+ * including the current frame, or -1 if there is none.  must be called with
+ * the frame cache mutex held */
+static int get_ready_frame(gs_image_file_t *image)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	const int count = (int)image->gif.frame_count;
+	int pending = 1;
+
+	if (fc->displayed_frame >= 0)
+		pending = frame_distance(image, fc->displayed_frame, image->cur_frame);
+
+	for (int i = 0; i < pending; i++) {
+		int frame = (image->cur_frame - i + count) % count;
+		if (image->animation_frame_cache[frame])
+			return frame;
+	}
+
+	return -1;
+}
+
+/* must be called with the frame cache mutex held */
+static uint8_t *get_frame_buffer(gs_image_file_t *image)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	const int count = (int)image->gif.frame_count;
+	uint8_t *buffer;
+
+	if (fc->free_frames.num) {
+		buffer = fc->free_frames.array[fc->free_frames.num - 1];
+		da_pop_back(fc->free_frames);
+		return buffer;
+	}
+
+	if (fc->allocated < fc->window) {
+		fc->allocated++;
+		return bmalloc(get_frame_size(image));
+	}
+
+	/* evict the frame furthest behind playback */
+	for (int dist = count - 1; dist >= fc->window; dist--) {
+		int frame = (image->cur_frame + dist) % count;
+
+		buffer = image->animation_frame_cache[frame];
+		if (buffer) {
+			image->animation_frame_cache[frame] = NULL;
+			return buffer;
+		}
+	}
+
+	return NULL;
+}
+
+/* copies the decoder's current canvas into the cache if the frame is still
+ * wanted */
+static void store_decoded_frame(gs_image_file_t *image, int frame)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	const size_t area = (size_t)image->gif.width * image->gif.height;
+	uint8_t *buffer = NULL;
+
+	pthread_mutex_lock(&fc->mutex);
+	if (!image->animation_frame_cache[frame] && frame_wanted(image, frame))
+		buffer = get_frame_buffer(image);
+	pthread_mutex_unlock(&fc->mutex);
+
+	if (!buffer)
+		return;
+
+	memcpy(buffer, image->gif.frame_image, area * 4);
+
+	if (fc->alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
+		gs_premultiply_xyza_srgb_loop(buffer, area);
+	} else if (fc->alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
+		gs_premultiply_xyza_loop(buffer, area);
+	}
+
+	pthread_mutex_lock(&fc->mutex);
+	if (!image->animation_frame_cache[frame] && frame_wanted(image, frame))
+		image->animation_frame_cache[frame] = buffer;
+	else
+		da_push_back(fc->free_frames, &buffer);
+	pthread_mutex_unlock(&fc->mutex);
+}
+
+/* must be called with the frame cache mutex held */
+static int get_next_missing_frame(gs_image_file_t *image)
+{
+	const int count = (int)image->gif.frame_count;
+
+	for (int i = 0; i < image->frame_cache->window; i++) {
+		int frame = (image->cur_frame + i) % count;
+		if (!image->animation_frame_cache[frame])
+			return frame;
+	}
+
+	return -1;
+}
+
+static void decode_ahead_task(void *param);
+
+/* must be called with the frame cache mutex held */
+static inline bool mark_decode_queued(struct gs_gif_frame_cache *fc)
+{
+	if (fc->decode_queued)
+		return false;
+
+	fc->decode_queued = true;
+	fc->pending_tasks++;
+	return true;
+}
+
+static void decode_ahead_task(void *param)
+{
+	gs_image_file_t *image = param;
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	int decoded = 0;
+	bool requeue = false;
+
+	pthread_mutex_lock(&fc->mutex);
+	fc->decode_queued = false;
+
+	while (!os_atomic_load_bool(&fc->stop)) {
+		int target = get_next_missing_frame(image);
+		int frame;
+
+		if (target == -1)
+			break;
+
+		/* let other gifs on this worker have a turn */
+		if (decoded >= GIF_DECODE_SLICE_FRAMES) {
+			requeue = mark_decode_queued(fc);
+			break;
+		}
+
+		pthread_mutex_unlock(&fc->mutex);
+
+		/* frames have to be decoded in order, so if looped, start over
+		 * from frame 0 */
+		frame = (target > image->last_decoded_frame) ? image->last_decoded_frame + 1 : 0;
+
+		for (; frame <= target && decoded < GIF_DECODE_SLICE_FRAMES; frame++, decoded++) {
+			/* on failure, keep whatever made it onto the canvas so
+			 * playback continues instead of retrying forever */
+			gif_decode_frame(&image->gif, frame);
+			image->last_decoded_frame = frame;
+			store_decoded_frame(image, frame);
+
+			if (os_atomic_load_bool(&fc->stop))
+				break;
+		}
+
+		pthread_mutex_lock(&fc->mutex);
+	}
+
+	if (--fc->pending_tasks == 0)
+		os_event_signal(fc->idle);
+	pthread_mutex_unlock(&fc->mutex);
+
+	if (requeue)
+		os_task_queue_queue_task(fc->decoder, decode_ahead_task, image);
+}
+
+static void queue_decode_ahead(gs_image_file_t *image)
+{
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	bool queue;
+
+	if (!fc->decoder)
+		fc->decoder = gif_decoder_acquire();
+
+	pthread_mutex_lock(&fc->mutex);
+	queue = mark_decode_queued(fc);
+	pthread_mutex_unlock(&fc->mutex);
+
+	if (queue)
+		os_task_queue_queue_task(fc->decoder, decode_ahead_task, image);
+}
+
+/* ------------------------------------------------------------------------- */
+
 static bool init_animated_gif(gs_image_file_t *image, const char *path, uint64_t *mem_usage,
 			      enum gs_image_alpha_mode alpha_mode)
 {
 	bool is_animated_gif = true;
 	gif_result result;
-	uint64_t max_size;
 	size_t size, size_read;
 	FILE *file;
 
@@ -120,44 +459,28 @@ static bool init_animated_gif(gs_image_file_t *image, const char *path, uint64_t
 		goto fail;
 	}
 
-	max_size = (uint64_t)image->gif.width * (uint64_t)image->gif.height * (uint64_t)image->gif.frame_count * 4LLU;
-
-	if ((uint64_t)get_full_decoded_gif_size(image) != max_size) {
-		blog(LOG_WARNING, "Gif '%s' overflowed maximum pointer size", path);
-		goto fail;
-	}
-
 	image->is_animated_gif = (image->gif.frame_count > 1 && result >= 0);
 	if (image->is_animated_gif) {
-		gif_decode_frame(&image->gif, 0);
-
-		image->animation_frame_cache = alloc_mem(image, mem_usage, image->gif.frame_count * sizeof(uint8_t *));
-		image->animation_frame_data = alloc_mem(image, mem_usage, get_full_decoded_gif_size(image));
-
-		for (unsigned int i = 0; i < image->gif.frame_count; i++) {
-			if (gif_decode_frame(&image->gif, i) != GIF_OK)
-				blog(LOG_WARNING,
-				     "Couldn't decode frame %u "
-				     "of '%s'",
-				     i, path);
-		}
-
-		gif_decode_frame(&image->gif, 0);
-
 		image->cx = (uint32_t)image->gif.width;
 		image->cy = (uint32_t)image->gif.height;
 		image->format = GS_RGBA;
 
+		image->animation_frame_cache = alloc_mem(image, mem_usage, image->gif.frame_count * sizeof(uint8_t *));
+		init_frame_cache(image, alpha_mode);
+
 		if (mem_usage) {
-			*mem_usage += (size_t)4 * image->cx * image->cy;
+			/* the decoded frame window, the decoder's canvas, and
+			 * the file itself */
+			*mem_usage += (uint64_t)image->frame_cache->window * get_frame_size(image);
+			*mem_usage += get_frame_size(image);
 			*mem_usage += size;
 		}
 
-		if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
-			gs_premultiply_xyza_srgb_loop(image->gif.frame_image, (size_t)image->cx * image->cy);
-		} else if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
-			gs_premultiply_xyza_loop(image->gif.frame_image, (size_t)image->cx * image->cy);
-		}
+		/* only the first frame is decoded up front, the rest are
+		 * decoded ahead of playback */
+		if (gif_decode_frame(&image->gif, 0) != GIF_OK)
+			blog(LOG_WARNING, "Couldn't decode first frame of '%s'", path);
+		store_decoded_frame(image, 0);
 	} else {
 		gif_finalise(&image->gif);
 		bfree(image->gif_data);
@@ -226,9 +549,9 @@ void gs_image_file_free(gs_image_file_t *image)
 
 	if (image->loaded) {
 		if (image->is_animated_gif) {
+			free_frame_cache(image);
 			gif_finalise(&image->gif);
 			bfree(image->animation_frame_cache);
-			bfree(image->animation_frame_data);
 		}
 
 		gs_texture_destroy(image->texture);
@@ -266,7 +589,8 @@ void gs_image_file_init_texture(gs_image_file_t *image)
 
 	if (image->is_animated_gif) {
 		image->texture = gs_texture_create(image->cx, image->cy, image->format, 1,
-						   (const uint8_t **)&image->gif.frame_image, GS_DYNAMIC);
+						   (const uint8_t **)&image->animation_frame_cache[0], GS_DYNAMIC);
+		image->frame_cache->displayed_frame = image->animation_frame_cache[0] ? 0 : -1;
 
 	} else {
 		image->texture = gs_texture_create(image->cx, image->cy, image->format, 1,
@@ -308,113 +632,95 @@ static inline int calculate_new_frame(gs_image_file_t *image, uint64_t elapsed_t
 	return new_frame;
 }
 
-static void decode_new_frame(gs_image_file_t *image, int new_frame, enum gs_image_alpha_mode alpha_mode)
-{
-	if (!image->animation_frame_cache[new_frame]) {
-		int last_frame;
-
-		/* if looped, decode frame 0 */
-		last_frame = (new_frame < image->last_decoded_frame) ? 0 : image->last_decoded_frame + 1;
-
-		/* decode missed frames */
-		for (int i = last_frame; i < new_frame; i++) {
-			if (gif_decode_frame(&image->gif, i) != GIF_OK)
-				return;
-		}
-
-		/* decode actual desired frame */
-		if (gif_decode_frame(&image->gif, new_frame) == GIF_OK) {
-			const size_t area = (size_t)image->gif.width * image->gif.height;
-			size_t pos = new_frame * area * 4;
-			image->animation_frame_cache[new_frame] = image->animation_frame_data + pos;
-
-			if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY_SRGB) {
-				gs_premultiply_xyza_srgb_loop(image->gif.frame_image, area);
-			} else if (alpha_mode == GS_IMAGE_ALPHA_PREMULTIPLY) {
-				gs_premultiply_xyza_loop(image->gif.frame_image, area);
-			}
-
-			memcpy(image->animation_frame_cache[new_frame], image->gif.frame_image, area * 4);
-
-			image->last_decoded_frame = new_frame;
-		}
-	}
-
-	image->cur_frame = new_frame;
-}
-
-static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed_time_ns,
-					enum gs_image_alpha_mode alpha_mode)
+static bool gs_image_file_tick_internal(gs_image_file_t *image, uint64_t elapsed_time_ns)
 {
+	struct gs_gif_frame_cache *fc;
+	bool updated;
 	int loops;
 
 	if (!image->is_animated_gif || !image->loaded)
 		return false;
 
+	fc = image->frame_cache;
+
 	loops = image->gif.loop_count;
 	if (loops >= 0xFFFF)
 		loops = 0;
 
 	if (!loops || image->cur_loop < loops) {
 		int new_frame = calculate_new_frame(image, elapsed_time_ns, loops);
+		bool decode;
 
-		if (new_frame != image->cur_frame) {
-			decode_new_frame(image, new_frame, alpha_mode);
-			return true;
-		}
+		pthread_mutex_lock(&fc->mutex);
+		decode = new_frame != image->cur_frame || !image->animation_frame_cache[new_frame];
+		image->cur_frame = new_frame;
+		pthread_mutex_unlock(&fc->mutex);
+
+		if (decode || !fc->decoder)
+			queue_decode_ahead(image);
 	}
 
-	return false;
+	pthread_mutex_lock(&fc->mutex);
+	updated = get_ready_frame(image) != -1;
+	pthread_mutex_unlock(&fc->mutex);
+
+	return updated;
 }
 
 bool gs_image_file_tick(gs_image_file_t *image, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(image, elapsed_time_ns, false);
+	return gs_image_file_tick_internal(image, elapsed_time_ns);
 }
 
 bool gs_image_file2_tick(gs_image_file2_t *if2, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if2->image, elapsed_time_ns, false);
+	return gs_image_file_tick_internal(&if2->image, elapsed_time_ns);
 }
 
 bool gs_image_file3_tick(gs_image_file3_t *if3, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if3->image2.image, elapsed_time_ns, if3->alpha_mode);
+	return gs_image_file_tick_internal(&if3->image2.image, elapsed_time_ns);
 }
 
 bool gs_image_file4_tick(gs_image_file4_t *if4, uint64_t elapsed_time_ns)
 {
-	return gs_image_file_tick_internal(&if4->image3.image2.image, elapsed_time_ns, if4->image3.alpha_mode);
+	return gs_image_file_tick_internal(&if4->image3.image2.image, elapsed_time_ns);
 }
 
-static void gs_image_file_update_texture_internal(gs_image_file_t *image, enum gs_image_alpha_mode alpha_mode)
+static void gs_image_file_update_texture_internal(gs_image_file_t *image)
 {
+	struct gs_gif_frame_cache *fc = image->frame_cache;
+	int frame;
+
 	if (!image->is_animated_gif || !image->loaded)
 		return;
 
-	if (!image->animation_frame_cache[image->cur_frame])
-		decode_new_frame(image, image->cur_frame, alpha_mode);
-
-	gs_texture_set_image(image->texture, image->animation_frame_cache[image->cur_frame], image->gif.width * 4,
-			     false);
+	/* the mutex is held during upload so the frame can't be evicted */
+	pthread_mutex_lock(&fc->mutex);
+	frame = get_ready_frame(image);
+	if (frame != -1) {
+		gs_texture_set_image(image->texture, image->animation_frame_cache[frame], image->gif.width * 4, false);
+		fc->displayed_frame = frame;
+	}
+	pthread_mutex_unlock(&fc->mutex);
 }
 
 void gs_image_file_update_texture(gs_image_file_t *image)
 {
-	gs_image_file_update_texture_internal(image, false);
+	gs_image_file_update_texture_internal(image);
 }
 
 void gs_image_file2_update_texture(gs_image_file2_t *if2)
 {
-	gs_image_file_update_texture_internal(&if2->image, false);
+	gs_image_file_update_texture_internal(&if2->image);
 }
 
 void gs_image_file3_update_texture(gs_image_file3_t *if3)
 {
-	gs_image_file_update_texture_internal(&if3->image2.image, if3->alpha_mode);
+	gs_image_file_update_texture_internal(&if3->image2.image);
 }
 
 void gs_image_file4_update_texture(gs_image_file4_t *if4)
 {
-	gs_image_file_update_texture_internal(&if4->image3.image2.image, if4->image3.alpha_mode);
+	gs_image_file_update_texture_internal(&if4->image3.image2.image);
 }
@@ -24,6 +24,8 @@
 extern "C" {
 #endif
 
+struct gs_gif_frame_cache;
+
 struct gs_image_file {
 	gs_texture_t *texture;
 	enum gs_color_format format;
@@ -36,7 +38,7 @@ struct gs_image_file {
 	gif_animation gif;
 	uint8_t *gif_data;
 	uint8_t **animation_frame_cache;
-	uint8_t *animation_frame_data;
+	struct gs_gif_frame_cache *frame_cache;
 	uint64_t cur_time;
 	int cur_frame;
 	int cur_loop;
@@ -27,6 +27,7 @@
 
 #include "audio-io.h"
 #include "audio-resampler.h"
+#include "clock-follower.h"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -43,21 +44,28 @@ extern profiler_name_store_t *obs_get_profiler_name_store(void);
 		int invalid = 0; \
 	} while (0)
 
-struct audio_input {
+/* resampling to one target format, shared by all inputs of a mix that want
+ * that format, so the mix is only resampled once per tick for each format */
+struct audio_converter {
 	struct audio_convert_info conversion;
 	audio_resampler_t *resampler;
+	long refs;
+
+	bool success;
+	struct audio_data data;
+};
+
+struct audio_input {
+	struct audio_convert_info conversion;
+	struct audio_converter *converter;
 
 	audio_output_callback_t callback;
 	void *param;
 };
 
-static inline void audio_input_free(struct audio_input *input)
-{
-	audio_resampler_destroy(input->resampler);
-}
-
 struct audio_mix {
 	DARRAY(struct audio_input) inputs;
+	DARRAY(struct audio_converter *) converters;
 	float buffer[MAX_AUDIO_CHANNELS][AUDIO_OUTPUT_FRAMES];
 	float buffer_unclamped[MAX_AUDIO_CHANNELS][AUDIO_OUTPUT_FRAMES];
 };
@@ -73,6 +81,19 @@ struct audio_output {
 
 	bool initialized;
 
+	/* when offline, ticks are run as fast as possible up to the time given
+	 * to audio_output_advance instead of following the system clock */
+	volatile bool offline;
+	pthread_mutex_t clock_mutex;
+	uint64_t offline_time;
+	os_event_t *advance_event;
+	os_event_t *caught_up_event;
+
+	/* external clock the ticks follow, see audio_output_set_clock */
+	struct audio_output_clock clock;
+	bool clock_changed;
+	double clock_ratio;
+
 	audio_input_callback_t input_cb;
 	void *input_param;
 	pthread_mutex_t input_mutex;
@@ -81,27 +102,32 @@ struct audio_output {
 
 /* ------------------------------------------------------------------------- */
 
-static bool resample_audio_output(struct audio_input *input, struct audio_data *data)
+static void resample_audio_output(struct audio_output *audio, struct audio_mix *mix, uint64_t timestamp,
+				  uint32_t frames)
 {
-	bool success = true;
-
-	if (input->resampler) {
+	for (size_t i = 0; i < mix->converters.num; i++) {
+		struct audio_converter *converter = mix->converters.array[i];
+		struct audio_data *data = &converter->data;
 		uint8_t *output[MAX_AV_PLANES];
-		uint32_t frames;
+		uint32_t out_frames;
 		uint64_t offset;
 
+		float(*buf)[AUDIO_OUTPUT_FRAMES] = converter->conversion.allow_clipping ? mix->buffer_unclamped
+											: mix->buffer;
+		const uint8_t *input[MAX_AV_PLANES] = {0};
+		for (size_t plane = 0; plane < audio->planes; plane++)
+			input[plane] = (const uint8_t *)buf[plane];
+
 		memset(output, 0, sizeof(output));
 
-		success = audio_resampler_resample(input->resampler, output, &frames, &offset,
-						   (const uint8_t *const *)data->data, data->frames);
+		converter->success =
+			audio_resampler_resample(converter->resampler, output, &out_frames, &offset, input, frames);
 
-		for (size_t i = 0; i < MAX_AV_PLANES; i++)
-			data->data[i] = output[i];
-		data->frames = frames;
-		data->timestamp -= offset;
+		for (size_t plane = 0; plane < MAX_AV_PLANES; plane++)
+			data->data[plane] = output[plane];
+		data->frames = out_frames;
+		data->timestamp = timestamp - offset;
 	}
-
-	return success;
 }
 
 static inline void do_audio_output(struct audio_output *audio, size_t mix_idx, uint64_t timestamp, uint32_t frames)
@@ -111,19 +137,28 @@ static inline void do_audio_output(struct audio_output *audio, size_t mix_idx, u
 
 	pthread_mutex_lock(&audio->input_mutex);
 
+	resample_audio_output(audio, mix, timestamp, frames);
+
 	for (size_t i = mix->inputs.num; i > 0; i--) {
 		struct audio_input *input = mix->inputs.array + (i - 1);
+		struct audio_converter *converter = input->converter;
 
-		float(*buf)[AUDIO_OUTPUT_FRAMES] = input->conversion.allow_clipping ? mix->buffer_unclamped
-										    : mix->buffer;
-		for (size_t i = 0; i < audio->planes; i++)
-			data.data[i] = (uint8_t *)buf[i];
+		if (converter) {
+			if (!converter->success)
+				continue;
 
-		data.frames = frames;
-		data.timestamp = timestamp;
+			data = converter->data;
+		} else {
+			float(*buf)[AUDIO_OUTPUT_FRAMES] = input->conversion.allow_clipping ? mix->buffer_unclamped
+											    : mix->buffer;
+			for (size_t i = 0; i < audio->planes; i++)
+				data.data[i] = (uint8_t *)buf[i];
 
-		if (resample_audio_output(input, &data))
-			input->callback(input->param, mix_idx, &data);
+			data.frames = frames;
+			data.timestamp = timestamp;
+		}
+
+		input->callback(input->param, mix_idx, &data);
 	}
 
 	pthread_mutex_unlock(&audio->input_mutex);
@@ -159,7 +194,8 @@ static inline void clamp_audio_output(struct audio_output *audio, size_t bytes)
 
 static void input_and_output(struct audio_output *audio, uint64_t audio_time, uint64_t prev_time)
 {
-	size_t bytes = AUDIO_OUTPUT_FRAMES * audio->block_size;
+	uint32_t frames = audio->info.output_frames;
+	size_t bytes = frames * audio->block_size;
 	struct audio_output_data data[MAX_AUDIO_MIXES];
 	uint32_t active_mixes = 0;
 	uint64_t new_ts = 0;
@@ -199,7 +235,64 @@ static void input_and_output(struct audio_output *audio, uint64_t audio_time, ui
 
 	/* output */
 	for (size_t i = 0; i < MAX_AUDIO_MIXES; i++)
-		do_audio_output(audio, i, new_ts, AUDIO_OUTPUT_FRAMES);
+		do_audio_output(audio, i, new_ts, frames);
+}
+
+/* returns false if the thread has to wait for audio_output_advance (or was
+ * woken for another reason, e.g. to stop) before running the tick */
+static bool offline_tick_ready(struct audio_output *audio, uint64_t audio_time)
+{
+	bool ready;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	ready = audio->offline_time >= audio_time;
+	if (!ready)
+		os_event_signal(audio->caught_up_event);
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	if (!ready)
+		os_event_wait(audio->advance_event);
+	return ready;
+}
+
+/* returns the system time the next tick ends at, or 0 if there's no clock to
+ * follow */
+static uint64_t follow_clock(struct audio_output *audio, struct clock_follower *cf, uint64_t prev_time)
+{
+	const uint32_t frames = audio->info.output_frames;
+	const uint32_t rate = audio->info.samples_per_sec;
+	uint64_t clock_time = 0;
+	uint64_t end_time;
+	bool has_clock;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	has_clock = audio->clock.get_time != NULL;
+	if (has_clock)
+		clock_time = audio->clock.get_time(audio->clock.param);
+	if (audio->clock_changed) {
+		audio->clock_changed = false;
+		cf->active = false;
+	}
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	if (!has_clock) {
+		cf->active = false;
+		return 0;
+	}
+
+	/* the time of the clock when the last tick ended */
+	clock_time -= os_gettime_ns() - prev_time;
+
+	end_time = clock_follower_tick(cf, clock_time, prev_time, frames, rate);
+	if (cf->resynced)
+		blog(LOG_WARNING, "audio-io: Clock of '%s' jumped by %.1f ms, resyncing", audio->info.name,
+		     cf->jump / 1000000.0);
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	audio->clock_ratio = clock_follower_ratio(cf, frames, rate);
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	return end_time;
 }
 
 static void *audio_thread(void *param)
@@ -214,6 +307,8 @@ static void *audio_thread(void *param)
 	uint64_t samples = 0;
 	uint64_t start_time = os_gettime_ns();
 	uint64_t prev_time = start_time;
+	bool offline = false;
+	struct clock_follower follower = {0};
 
 	os_set_thread_name("audio-io: audio thread");
 
@@ -221,10 +316,38 @@ static void *audio_thread(void *param)
 		profile_store_name(obs_get_profiler_name_store(), "audio_thread(%s)", audio->info.name);
 
 	while (os_event_try(audio->stop_event) == EAGAIN) {
-		samples += AUDIO_OUTPUT_FRAMES;
-		uint64_t audio_time = start_time + audio_frames_to_ns(rate, samples);
+		bool was_offline = offline;
+		offline = os_atomic_load_bool(&audio->offline);
+
+		/* the virtual clock is ahead of the system clock by the time
+		 * that was rendered offline, so start over from the current
+		 * time when going back */
+		if (was_offline && !offline) {
+			start_time = os_gettime_ns();
+			prev_time = start_time;
+			samples = 0;
+			follower.active = false;
+			os_event_signal(audio->caught_up_event);
+		}
+
+		bool following = follower.active;
+		uint64_t audio_time = offline ? 0 : follow_clock(audio, &follower, prev_time);
+
+		/* back on the system clock, continue from the last tick */
+		if (following && !follower.active) {
+			start_time = prev_time;
+			samples = 0;
+		}
 
-		os_sleepto_ns_fast(audio_time);
+		if (!audio_time)
+			audio_time = start_time + audio_frames_to_ns(rate, samples + audio->info.output_frames);
+
+		if (!offline)
+			os_sleepto_ns_fast(audio_time);
+		else if (!offline_tick_ready(audio, audio_time))
+			continue;
+
+		samples += audio->info.output_frames;
 
 		profile_start(audio_thread_name);
 
@@ -236,6 +359,8 @@ static void *audio_thread(void *param)
 		profile_reenable_thread();
 	}
 
+	os_event_signal(audio->caught_up_event);
+
 #ifdef _WIN32
 	if (handle)
 		AvRevertMmThreadCharacteristics(handle);
@@ -260,32 +385,80 @@ static size_t audio_get_input_idx(const audio_t *audio, size_t mix_idx, audio_ou
 	return DARRAY_INVALID;
 }
 
-static inline bool audio_input_init(struct audio_input *input, struct audio_output *audio)
+static inline bool same_conversion(const struct audio_convert_info *a, const struct audio_convert_info *b)
+{
+	return a->format == b->format && a->samples_per_sec == b->samples_per_sec && a->speakers == b->speakers &&
+	       a->allow_clipping == b->allow_clipping;
+}
+
+static struct audio_converter *get_converter(struct audio_output *audio, struct audio_mix *mix,
+					     const struct audio_convert_info *conversion)
+{
+	struct audio_converter *converter;
+
+	for (size_t i = 0; i < mix->converters.num; i++) {
+		converter = mix->converters.array[i];
+		if (same_conversion(&converter->conversion, conversion)) {
+			converter->refs++;
+			return converter;
+		}
+	}
+
+	struct resample_info from = {.format = audio->info.format,
+				     .samples_per_sec = audio->info.samples_per_sec,
+				     .speakers = audio->info.speakers};
+
+	struct resample_info to = {.format = conversion->format,
+				   .samples_per_sec = conversion->samples_per_sec,
+				   .speakers = conversion->speakers};
+
+	audio_resampler_t *resampler = audio_resampler_create(&to, &from);
+	if (!resampler) {
+		blog(LOG_ERROR, "audio_input_init: Failed to "
+				"create resampler");
+		return NULL;
+	}
+
+	converter = bzalloc(sizeof(*converter));
+	converter->conversion = *conversion;
+	converter->resampler = resampler;
+	converter->refs = 1;
+
+	da_push_back(mix->converters, &converter);
+	return converter;
+}
+
+static void release_converter(struct audio_mix *mix, struct audio_converter *converter)
+{
+	if (--converter->refs)
+		return;
+
+	da_erase_item(mix->converters, &converter);
+	audio_resampler_destroy(converter->resampler);
+	bfree(converter);
+}
+
+static inline bool audio_input_init(struct audio_input *input, struct audio_output *audio, struct audio_mix *mix)
 {
 	if (input->conversion.format != audio->info.format ||
 	    input->conversion.samples_per_sec != audio->info.samples_per_sec ||
 	    input->conversion.speakers != audio->info.speakers) {
-		struct resample_info from = {.format = audio->info.format,
-					     .samples_per_sec = audio->info.samples_per_sec,
-					     .speakers = audio->info.speakers};
-
-		struct resample_info to = {.format = input->conversion.format,
-					   .samples_per_sec = input->conversion.samples_per_sec,
-					   .speakers = input->conversion.speakers};
-
-		input->resampler = audio_resampler_create(&to, &from);
-		if (!input->resampler) {
-			blog(LOG_ERROR, "audio_input_init: Failed to "
-					"create resampler");
+		input->converter = get_converter(audio, mix, &input->conversion);
+		if (!input->converter)
 			return false;
-		}
 	} else {
-		input->resampler = NULL;
+		input->converter = NULL;
 	}
 
 	return true;
 }
 
+static inline void audio_input_free(struct audio_input *input, struct audio_mix *mix)
+{
+	if (input->converter)
+		release_converter(mix, input->converter);
+}
+
 bool audio_output_connect(audio_t *audio, size_t mi, const struct audio_convert_info *conversion,
 			  audio_output_callback_t callback, void *param)
 {
@@ -318,7 +491,7 @@ bool audio_output_connect(audio_t *audio, size_t mi, const struct audio_convert_
 		if (input.conversion.samples_per_sec == 0)
 			input.conversion.samples_per_sec = audio->info.samples_per_sec;
 
-		success = audio_input_init(&input, audio);
+		success = audio_input_init(&input, audio, mix);
 		if (success)
 			da_push_back(mix->inputs, &input);
 	}
@@ -338,7 +511,7 @@ void audio_output_disconnect(audio_t *audio, size_t mix_idx, audio_output_callba
 	size_t idx = audio_get_input_idx(audio, mix_idx, callback, param);
 	if (idx != DARRAY_INVALID) {
 		struct audio_mix *mix = &audio->mixes[mix_idx];
-		audio_input_free(mix->inputs.array + idx);
+		audio_input_free(mix->inputs.array + idx, mix);
 		da_erase(mix->inputs, idx);
 	}
 
@@ -347,7 +520,9 @@ void audio_output_disconnect(audio_t *audio, size_t mix_idx, audio_output_callba
 
 static inline bool valid_audio_params(const struct audio_output_info *info)
 {
-	return info->format && info->name && info->samples_per_sec > 0 && info->speakers > 0;
+	return info->format && info->name && info->samples_per_sec > 0 && info->speakers > 0 &&
+	       (!info->output_frames ||
+		(info->output_frames >= MIN_AUDIO_OUTPUT_FRAMES && info->output_frames <= AUDIO_OUTPUT_FRAMES));
 }
 
 int audio_output_open(audio_t **audio, struct audio_output_info *info)
@@ -363,25 +538,40 @@ int audio_output_open(audio_t **audio, struct audio_output_info *info)
 		goto fail0;
 
 	memcpy(&out->info, info, sizeof(struct audio_output_info));
+	if (!out->info.output_frames)
+		out->info.output_frames = AUDIO_OUTPUT_FRAMES;
 	out->channels = get_audio_channels(info->speakers);
 	out->planes = planar ? out->channels : 1;
 	out->input_cb = info->input_callback;
 	out->input_param = info->input_param;
 	out->block_size = (planar ? 1 : out->channels) * get_audio_bytes_per_channel(info->format);
+	out->clock_ratio = 1.0;
 
 	if (pthread_mutex_init_recursive(&out->input_mutex) != 0)
 		goto fail0;
-	if (os_event_init(&out->stop_event, OS_EVENT_TYPE_MANUAL) != 0)
+	if (pthread_mutex_init(&out->clock_mutex, NULL) != 0)
 		goto fail1;
-	if (pthread_create(&out->thread, NULL, audio_thread, out) != 0)
+	if (os_event_init(&out->stop_event, OS_EVENT_TYPE_MANUAL) != 0)
 		goto fail2;
+	if (os_event_init(&out->advance_event, OS_EVENT_TYPE_AUTO) != 0)
+		goto fail3;
+	if (os_event_init(&out->caught_up_event, OS_EVENT_TYPE_MANUAL) != 0)
+		goto fail4;
+	if (pthread_create(&out->thread, NULL, audio_thread, out) != 0)
+		goto fail5;
 
 	out->initialized = true;
 	*audio = out;
 	return AUDIO_OUTPUT_SUCCESS;
 
-fail2:
+fail5:
+	os_event_destroy(out->caught_up_event);
+fail4:
+	os_event_destroy(out->advance_event);
+fail3:
 	os_event_destroy(out->stop_event);
+fail2:
+	pthread_mutex_destroy(&out->clock_mutex);
 fail1:
 	pthread_mutex_destroy(&out->input_mutex);
 fail0:
@@ -398,8 +588,12 @@ void audio_output_close(audio_t *audio)
 
 	if (audio->initialized) {
 		os_event_signal(audio->stop_event);
+		os_event_signal(audio->advance_event);
 		pthread_join(audio->thread, &thread_ret);
 		os_event_destroy(audio->stop_event);
+		os_event_destroy(audio->advance_event);
+		os_event_destroy(audio->caught_up_event);
+		pthread_mutex_destroy(&audio->clock_mutex);
 		pthread_mutex_destroy(&audio->input_mutex);
 	}
 
@@ -407,9 +601,10 @@ void audio_output_close(audio_t *audio)
 		struct audio_mix *mix = &audio->mixes[mix_idx];
 
 		for (size_t i = 0; i < mix->inputs.num; i++)
-			audio_input_free(mix->inputs.array + i);
+			audio_input_free(mix->inputs.array + i, mix);
 
 		da_free(mix->inputs);
+		da_free(mix->converters);
 	}
 	bfree(audio);
 }
@@ -453,3 +648,69 @@ uint32_t audio_output_get_sample_rate(const audio_t *audio)
 {
 	return audio->info.samples_per_sec;
 }
+
+uint32_t audio_output_get_output_frames(const audio_t *audio)
+{
+	return audio ? audio->info.output_frames : AUDIO_OUTPUT_FRAMES;
+}
+
+void audio_output_set_offline(audio_t *audio, bool offline)
+{
+	if (!audio)
+		return;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	audio->offline_time = 0;
+	os_atomic_set_bool(&audio->offline, offline);
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	os_event_signal(audio->advance_event);
+}
+
+void audio_output_advance(audio_t *audio, uint64_t time)
+{
+	if (!audio)
+		return;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	if (!audio->offline) {
+		pthread_mutex_unlock(&audio->clock_mutex);
+		return;
+	}
+
+	audio->offline_time = time;
+	os_event_reset(audio->caught_up_event);
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	os_event_signal(audio->advance_event);
+	os_event_wait(audio->caught_up_event);
+}
+
+void audio_output_set_clock(audio_t *audio, const struct audio_output_clock *clock)
+{
+	if (!audio)
+		return;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	if (clock)
+		audio->clock = *clock;
+	else
+		memset(&audio->clock, 0, sizeof(audio->clock));
+	audio->clock_changed = true;
+	audio->clock_ratio = 1.0;
+	pthread_mutex_unlock(&audio->clock_mutex);
+}
+
+double audio_output_get_clock_ratio(audio_t *audio)
+{
+	double ratio;
+
+	if (!audio)
+		return 1.0;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	ratio = audio->clock_ratio;
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	return ratio;
+}
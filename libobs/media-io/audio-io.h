@@ -28,7 +28,10 @@ extern "C" {
 #define MAX_AUDIO_MIXES 6
 #define MAX_AUDIO_CHANNELS 8
 #define MAX_DEVICE_INPUT_CHANNELS 64
+/* maximum (and default) number of frames per audio tick, buffers are sized
+ * for this.  the actual number is set with audio_output_info::output_frames */
 #define AUDIO_OUTPUT_FRAMES 1024
+#define MIN_AUDIO_OUTPUT_FRAMES 64
 
 #define TOTAL_AUDIO_SIZE (MAX_AUDIO_MIXES * MAX_AUDIO_CHANNELS * AUDIO_OUTPUT_FRAMES * sizeof(float))
 
@@ -96,6 +99,9 @@ struct audio_output_info {
 
 	audio_input_callback_t input_callback;
 	void *input_param;
+
+	/* frames per tick, 0 for AUDIO_OUTPUT_FRAMES */
+	uint32_t output_frames;
 };
 
 struct audio_convert_info {
@@ -221,8 +227,32 @@ EXPORT size_t audio_output_get_block_size(const audio_t *audio);
 EXPORT size_t audio_output_get_planes(const audio_t *audio);
 EXPORT size_t audio_output_get_channels(const audio_t *audio);
 EXPORT uint32_t audio_output_get_sample_rate(const audio_t *audio);
+EXPORT uint32_t audio_output_get_output_frames(const audio_t *audio);
 EXPORT const struct audio_output_info *audio_output_get_info(const audio_t *audio);
 
+/* in offline mode the audio thread doesn't follow the system clock, instead
+ * it runs ticks as fast as it can up to the time given to
+ * audio_output_advance, which waits until they are done */
+EXPORT void audio_output_set_offline(audio_t *audio, bool offline);
+EXPORT void audio_output_advance(audio_t *audio, uint64_t time);
+
+/* an external clock for the audio thread to follow instead of the system
+ * clock, e.g. the sample clock of an audio device.  get_time returns the
+ * current time of the clock in nanoseconds, only its rate matters.  it's
+ * called from the audio thread and must not call back into the audio
+ * output */
+struct audio_output_clock {
+	uint64_t (*get_time)(void *param);
+	void *param;
+};
+
+/* ticks follow the given clock, or the system clock again if NULL.  the
+ * output then runs at the sample rate of that clock, and the ratio of that
+ * rate to the nominal sample rate is returned by
+ * audio_output_get_clock_ratio */
+EXPORT void audio_output_set_clock(audio_t *audio, const struct audio_output_clock *clock);
+EXPORT double audio_output_get_clock_ratio(audio_t *audio);
+
 #ifdef __cplusplus
 }
 #endif
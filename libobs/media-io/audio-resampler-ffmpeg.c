@@ -15,6 +15,8 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 
+#include <math.h>
+
 #include "../util/bmem.h"
 #include "audio-resampler.h"
 #include "audio-io.h"
@@ -34,6 +36,11 @@ struct audio_resampler {
 	uint32_t output_ch;
 	uint32_t output_freq;
 	uint32_t output_planes;
+
+	/* the compensation last set, and the frames output since */
+	bool compensating;
+	int comp_delta;
+	int64_t comp_frames;
 #if LIBSWRESAMPLE_VERSION_INT < AV_VERSION_INT(4, 5, 100)
 	uint64_t input_layout;
 	uint64_t output_layout;
@@ -213,6 +220,36 @@ bool audio_resampler_resample(audio_resampler_t *rs, uint8_t *output[], uint32_t
 	for (uint32_t i = 0; i < rs->output_planes; i++)
 		output[i] = rs->output_buffer[i];
 
+	rs->comp_frames += ret;
 	*out_frames = (uint32_t)ret;
 	return true;
 }
+
+/* the difference is spread over ten seconds of output, which allows for
+ * corrections down to a few ppm */
+#define COMPENSATION_SECONDS 10
+
+bool audio_resampler_set_compensation(audio_resampler_t *rs, double ratio)
+{
+	if (!rs)
+		return false;
+
+	int distance = (int)rs->output_freq * COMPENSATION_SECONDS;
+	int delta = (int)lround((ratio - 1.0) * (double)distance);
+
+	/* swr starts over every time it's set, so only set it when the
+	 * difference changes or the last one is halfway done */
+	if (rs->compensating && delta == rs->comp_delta && rs->comp_frames < distance / 2)
+		return true;
+
+	int errcode = swr_set_compensation(rs->context, delta, distance);
+	if (errcode < 0) {
+		blog(LOG_ERROR, "swr_set_compensation failed: %d", errcode);
+		return false;
+	}
+
+	rs->compensating = true;
+	rs->comp_delta = delta;
+	rs->comp_frames = 0;
+	return true;
+}
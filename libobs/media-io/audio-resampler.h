@@ -39,6 +39,13 @@ EXPORT void audio_resampler_destroy(audio_resampler_t *resampler);
 EXPORT bool audio_resampler_resample(audio_resampler_t *resampler, uint8_t *output[], uint32_t *out_frames,
 				     uint64_t *ts_offset, const uint8_t *const input[], uint32_t in_frames);
 
+/* stretches the output by the given ratio on top of the sample rate
+ * conversion, e.g. 1.0001 for 100 ppm more output frames.  used to follow
+ * a clock that drifts from the nominal sample rate, so it has to be set
+ * again at least every few seconds.  setting the same ratio again is cheap,
+ * the resampler is only updated when it changes. */
+EXPORT bool audio_resampler_set_compensation(audio_resampler_t *resampler, double ratio);
+
 #ifdef __cplusplus
 }
 #endif
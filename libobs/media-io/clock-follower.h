@@ -0,0 +1,114 @@
+/******************************************************************************
+    Copyright (C) 2026 by OBS Studio contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "../util/c99defs.h"
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Delay-locked loop that lets the ticks of the audio thread follow an
+ * external clock: the difference between the time of the clock and the time
+ * of the samples that were produced steers the length of the ticks, which
+ * tracks the rate of the clock while filtering out jitter in reading it.
+ *
+ * It only does the math, the times are passed in, so it can be driven by a
+ * synthetic time source as well.
+ */
+
+#define CLOCK_DLL_BANDWIDTH 0.1
+#define CLOCK_MAX_ERROR_NS 100000000.0
+
+struct clock_follower {
+	bool active;
+	uint64_t clock_start;
+	uint64_t sys_start;
+	uint64_t ticks;
+	double elapsed;
+	double period;
+	double b;
+	double c;
+
+	/* set by clock_follower_tick if the clock jumped by the given amount,
+	 * and following it started over */
+	bool resynced;
+	double jump;
+};
+
+static inline void clock_follower_reset(struct clock_follower *cf, uint64_t clock_time, uint64_t sys_time)
+{
+	cf->clock_start = clock_time;
+	cf->sys_start = sys_time;
+	cf->ticks = 0;
+	cf->elapsed = 0.0;
+}
+
+static inline double clock_follower_nominal(uint32_t frames, uint32_t rate)
+{
+	return (double)frames * 1000000000.0 / (double)rate;
+}
+
+/* clock_time is the time of the clock at system time prev_time, when the
+ * last tick ended.  returns the system time the next tick ends at. */
+static inline uint64_t clock_follower_tick(struct clock_follower *cf, uint64_t clock_time, uint64_t prev_time,
+					   uint32_t frames, uint32_t rate)
+{
+	const double nominal = clock_follower_nominal(frames, rate);
+	double next = cf->period;
+
+	cf->resynced = false;
+
+	if (!cf->active) {
+		double omega = 2.0 * 3.14159265358979323846 * CLOCK_DLL_BANDWIDTH * (double)frames / (double)rate;
+
+		cf->active = true;
+		cf->b = sqrt(2.0) * omega;
+		cf->c = omega * omega;
+		cf->period = next = nominal;
+		clock_follower_reset(cf, clock_time, prev_time);
+	} else {
+		/* how far the clock is ahead of the produced samples */
+		double error = (double)(int64_t)(clock_time - cf->clock_start) - (double)cf->ticks * nominal;
+
+		if (fabs(error) > CLOCK_MAX_ERROR_NS) {
+			cf->resynced = true;
+			cf->jump = error;
+			clock_follower_reset(cf, clock_time, prev_time);
+		} else {
+			cf->period -= cf->c * error;
+			next = cf->period - cf->b * error;
+		}
+	}
+
+	cf->elapsed += next;
+	cf->ticks++;
+	return cf->sys_start + (uint64_t)cf->elapsed;
+}
+
+/* rate of the clock relative to the system clock */
+static inline double clock_follower_ratio(const struct clock_follower *cf, uint32_t frames, uint32_t rate)
+{
+	return clock_follower_nominal(frames, rate) / cf->period;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -31,20 +31,62 @@
 
 extern profiler_name_store_t *obs_get_profiler_name_store(void);
 
-#define MAX_CONVERT_BUFFERS 3
 #define MAX_CACHE_SIZE 16
 
 struct cached_frame_info {
 	struct video_data frame;
 	int skipped;
 	int count;
+
+	/* number of queued frames still using this cache entry */
+	volatile long refs;
+
+	/* changes every time the entry is reused */
+	uint64_t id;
+};
+
+/* scaling/conversion to one target, shared by all inputs that want that
+ * target, so each distinct target is only computed once per frame.  the
+ * output is kept per cache entry, which can't be reused while an input still
+ * uses it, so inputs can read it without holding the lock. */
+struct converted_frame {
+	struct video_frame frame;
+	uint64_t id;
+	long refs;
 };
 
+struct video_converter {
+	struct video_scale_info info;
+	video_scaler_t *scaler;
+	long refs;
+
+	/* scales from the output of another converter instead of the cache
+	 * when cascaded scaling is enabled */
+	struct video_converter *source;
+
+	/* inputs only hold on to a converted frame for the duration of their
+	 * callback, so only as many frames are allocated as are in use at
+	 * once.  frames nobody holds keep their contents for inputs that are
+	 * behind, until they're needed for a newer frame. */
+	pthread_mutex_t mutex;
+	DARRAY(struct converted_frame *) frames;
+};
+
+/* repeats of the same cache entry are queued as one, and an entry can't be
+ * reused before every input is done with it, so an input never has more
+ * than MAX_CACHE_SIZE queued frames */
+struct queued_frame {
+	struct video_data frame;
+	struct cached_frame_info *cached;
+	int count;
+};
+
+/* each input has a thread of its own, so raw encoders that encode in their
+ * callback run in parallel instead of adding up each other's latency */
 struct video_input {
+	struct video_output *video;
 	struct video_scale_info conversion;
-	video_scaler_t *scaler;
-	struct video_frame frame[MAX_CONVERT_BUFFERS];
-	int cur_frame;
+	struct video_converter *converter;
 
 	// allow outputting at fractions of main composition FPS,
 	// e.g. 60 FPS with frame_rate_divisor = 1 turns into 30 FPS
@@ -58,14 +100,23 @@ struct video_input {
 
 	void (*callback)(void *param, struct video_data *frame);
 	void *param;
-};
 
-static inline void video_input_free(struct video_input *input)
-{
-	for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
-		video_frame_free(&input->frame[i]);
-	video_scaler_destroy(input->scaler);
-}
+	pthread_t thread;
+	bool thread_active;
+	bool stop;
+	/* deliver the frames that are still queued before stopping */
+	bool drain;
+	volatile bool thread_exited;
+
+	pthread_mutex_t queue_mutex;
+	os_sem_t *queued_sem;
+	struct queued_frame queue[MAX_CACHE_SIZE];
+	size_t queue_start;
+	size_t queue_count;
+
+	volatile long total_frames;
+	volatile long lagged_frames;
+};
 
 struct video_output {
 	struct video_output_info info;
@@ -75,18 +126,35 @@ struct video_output {
 	bool stop;
 
 	os_sem_t *update_semaphore;
+	os_event_t *available_event;
 	uint64_t frame_time;
 	volatile long skipped_frames;
 	volatile long total_frames;
 
 	pthread_mutex_t input_mutex;
-	DARRAY(struct video_input) inputs;
+	DARRAY(struct video_input *) inputs;
+	DARRAY(struct video_converter *) converters;
+
+	/* inputs that disconnected from their own callback, and whose
+	 * threads are joined once they've exited */
+	DARRAY(struct video_input *) detached_inputs;
+	bool cascaded_scaling;
 
 	size_t available_frames;
 	size_t first_added;
 	size_t last_added;
 	struct cached_frame_info cache[MAX_CACHE_SIZE];
 
+	/* entries that have been dispatched to all inputs, but may still be
+	 * in use by input threads */
+	size_t first_busy;
+	size_t busy_frames;
+	uint64_t last_id;
+
+	/* when offline, frames are never skipped, locking a frame waits for
+	 * a cache entry to become available instead */
+	volatile bool offline;
+
 	struct video_output *parent;
 
 	volatile bool raw_active;
@@ -95,32 +163,285 @@ struct video_output {
 
 /* ------------------------------------------------------------------------- */
 
-static inline bool scale_video_output(struct video_input *input, struct video_data *data)
+/* must be called with the converter mutex held */
+static struct converted_frame *get_converted_frame(struct video_converter *converter, uint64_t id)
 {
-	bool success = true;
+	struct converted_frame *oldest = NULL;
 
-	if (input->scaler) {
-		struct video_frame *frame;
+	for (size_t i = 0; i < converter->frames.num; i++) {
+		struct converted_frame *frame = converter->frames.array[i];
 
-		if (++input->cur_frame == MAX_CONVERT_BUFFERS)
-			input->cur_frame = 0;
+		if (frame->id == id)
+			return frame;
+		if (!frame->refs && (!oldest || frame->id < oldest->id))
+			oldest = frame;
+	}
 
-		frame = &input->frame[input->cur_frame];
+	if (!oldest) {
+		oldest = bzalloc(sizeof(*oldest));
+		video_frame_init(&oldest->frame, converter->info.format, converter->info.width,
+				 converter->info.height);
+		da_push_back(converter->frames, &oldest);
+	}
 
-		success = video_scaler_scale(input->scaler, frame->data, frame->linesize,
-					     (const uint8_t *const *)data->data, data->linesize);
+	oldest->id = 0;
+	return oldest;
+}
 
-		if (success) {
-			for (size_t i = 0; i < MAX_AV_PLANES; i++) {
-				data->data[i] = frame->data[i];
-				data->linesize[i] = frame->linesize[i];
+static void release_converted_frame(struct video_converter *converter, struct converted_frame *frame)
+{
+	pthread_mutex_lock(&converter->mutex);
+	frame->refs--;
+	pthread_mutex_unlock(&converter->mutex);
+}
+
+/* returns a reference to the converted frame, which has to be released with
+ * release_converted_frame, or NULL if the frame couldn't be converted */
+static struct converted_frame *convert_frame(struct video_output *video, struct video_converter *converter,
+					     struct cached_frame_info *cached)
+{
+	struct converted_frame *frame;
+
+	pthread_mutex_lock(&converter->mutex);
+
+	/* the first input to get here does the work, any other input wanting
+	 * the same target waits for it and uses the result */
+	frame = get_converted_frame(converter, cached->id);
+	if (frame->id != cached->id) {
+		struct converted_frame *source = NULL;
+		struct video_data src = cached->frame;
+		bool success = true;
+
+		if (converter->source) {
+			source = convert_frame(video, converter->source, cached);
+			success = !!source;
+			if (source) {
+				for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+					src.data[i] = source->frame.data[i];
+					src.linesize[i] = source->frame.linesize[i];
+				}
 			}
+		}
+		if (success)
+			success = video_scaler_scale(converter->scaler, frame->frame.data, frame->frame.linesize,
+						     (const uint8_t *const *)src.data, src.linesize);
+		if (source)
+			release_converted_frame(converter->source, source);
+
+		if (success) {
+			frame->id = cached->id;
 		} else {
 			blog(LOG_WARNING, "video-io: Could not scale frame!");
+			frame = NULL;
 		}
 	}
 
-	return success;
+	if (frame)
+		frame->refs++;
+
+	pthread_mutex_unlock(&converter->mutex);
+	return frame;
+}
+
+static inline bool scale_video_output(struct video_input *input, struct cached_frame_info *cached,
+				      struct video_data *data, struct converted_frame **converted)
+{
+	if (!input->converter)
+		return true;
+
+	*converted = convert_frame(input->video, input->converter, cached);
+	if (!*converted)
+		return false;
+
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		data->data[i] = (*converted)->frame.data[i];
+		data->linesize[i] = (*converted)->frame.linesize[i];
+	}
+	return true;
+}
+
+/* makes cache entries available again once no input uses them anymore.
+ * entries are dispatched in order, but inputs can finish with them out of
+ * order, so only the oldest ones are released. */
+static void release_cached_frames(struct video_output *video)
+{
+	while (video->busy_frames && !os_atomic_load_long(&video->cache[video->first_busy].refs)) {
+		video->busy_frames--;
+		if (++video->first_busy == video->info.cache_size)
+			video->first_busy = 0;
+
+		if (++video->available_frames == video->info.cache_size)
+			video->last_added = video->first_added;
+
+		os_event_signal(video->available_event);
+	}
+}
+
+static void release_cached_frame(struct video_output *video, struct cached_frame_info *cached)
+{
+	if (os_atomic_dec_long(&cached->refs) == 0) {
+		pthread_mutex_lock(&video->data_mutex);
+		release_cached_frames(video);
+		pthread_mutex_unlock(&video->data_mutex);
+	}
+}
+
+static void release_converter(struct video_output *video, struct video_converter *converter);
+
+/* must be called with the input mutex held, once the thread has exited */
+static void video_input_destroy(struct video_input *input)
+{
+	/* frames that were never delivered */
+	for (size_t i = 0; i < input->queue_count; i++) {
+		size_t idx = (input->queue_start + i) % MAX_CACHE_SIZE;
+		release_cached_frame(input->video, input->queue[idx].cached);
+	}
+
+	/* converters are shared between inputs and protected by the input
+	 * mutex, so they're released here rather than by the thread */
+	if (input->converter)
+		release_converter(input->video, input->converter);
+
+	os_sem_destroy(input->queued_sem);
+	pthread_mutex_destroy(&input->queue_mutex);
+	bfree(input);
+}
+
+/* joins the threads of inputs that disconnected from their own callback.
+ * must be called with the input mutex held. */
+static void join_detached_inputs(struct video_output *video, bool wait)
+{
+	for (size_t i = video->detached_inputs.num; i > 0; i--) {
+		struct video_input *input = video->detached_inputs.array[i - 1];
+
+		if (!wait && !os_atomic_load_bool(&input->thread_exited))
+			continue;
+
+		pthread_join(input->thread, NULL);
+		video_input_destroy(input);
+		da_erase(video->detached_inputs, i - 1);
+	}
+}
+
+/* frames still queued for the input are delivered before its thread stops
+ * if drain is set, the same as they would have been had the input stayed
+ * connected.  must be called with the input mutex held. */
+static void video_input_free(struct video_input *input, bool drain)
+{
+	bool self = false;
+
+	if (input->thread_active) {
+		/* encoders can disconnect from within their own callback
+		 * when they fail, in which case the thread can't be joined
+		 * until the callback returns */
+		self = pthread_equal(pthread_self(), input->thread);
+
+		/* nothing may be delivered once an input that disconnected
+		 * itself returns from its callback */
+		pthread_mutex_lock(&input->queue_mutex);
+		input->stop = true;
+		input->drain = drain && !self;
+		pthread_mutex_unlock(&input->queue_mutex);
+
+		os_sem_post(input->queued_sem);
+
+		if (self)
+			da_push_back(input->video->detached_inputs, &input);
+		else
+			pthread_join(input->thread, NULL);
+	}
+
+	if (!self)
+		video_input_destroy(input);
+}
+
+static void *video_input_thread(void *param)
+{
+	struct video_input *input = param;
+	uint64_t frame_time = input->video->frame_time * input->frame_rate_divisor;
+
+	os_set_thread_name("video-io: input thread");
+
+	while (os_sem_wait(input->queued_sem) == 0) {
+		struct queued_frame *queued;
+		struct cached_frame_info *cached;
+		struct converted_frame *converted = NULL;
+		struct video_data frame;
+		bool done = false;
+
+		pthread_mutex_lock(&input->queue_mutex);
+
+		if (input->stop && (!input->drain || !input->queue_count)) {
+			pthread_mutex_unlock(&input->queue_mutex);
+			break;
+		}
+		if (!input->queue_count) {
+			pthread_mutex_unlock(&input->queue_mutex);
+			continue;
+		}
+
+		queued = &input->queue[input->queue_start];
+		cached = queued->cached;
+		frame = queued->frame;
+		queued->frame.timestamp += frame_time;
+
+		if (--queued->count == 0) {
+			done = true;
+			if (++input->queue_start == MAX_CACHE_SIZE)
+				input->queue_start = 0;
+			input->queue_count--;
+		}
+
+		pthread_mutex_unlock(&input->queue_mutex);
+
+		if (scale_video_output(input, cached, &frame, &converted))
+			input->callback(input->param, &frame);
+		if (converted)
+			release_converted_frame(input->converter, converted);
+
+		if (done)
+			release_cached_frame(input->video, cached);
+	}
+
+	/* an input whose thread is joined later must not keep cache entries
+	 * busy until then */
+	pthread_mutex_lock(&input->queue_mutex);
+	for (; input->queue_count; input->queue_count--) {
+		release_cached_frame(input->video, input->queue[input->queue_start].cached);
+		if (++input->queue_start == MAX_CACHE_SIZE)
+			input->queue_start = 0;
+	}
+	pthread_mutex_unlock(&input->queue_mutex);
+
+	os_atomic_set_bool(&input->thread_exited, true);
+	return NULL;
+}
+
+static void video_input_queue_frame(struct video_input *input, struct cached_frame_info *cached)
+{
+	pthread_mutex_lock(&input->queue_mutex);
+
+	/* frames queued behind one that hasn't been handled yet */
+	if (input->queue_count)
+		os_atomic_inc_long(&input->lagged_frames);
+
+	size_t last = (input->queue_start + input->queue_count + MAX_CACHE_SIZE - 1) % MAX_CACHE_SIZE;
+
+	if (input->queue_count && input->queue[last].cached == cached) {
+		input->queue[last].count++;
+	} else {
+		size_t idx = (input->queue_start + input->queue_count) % MAX_CACHE_SIZE;
+		input->queue[idx].frame = cached->frame;
+		input->queue[idx].cached = cached;
+		input->queue[idx].count = 1;
+		input->queue_count++;
+		os_atomic_inc_long(&cached->refs);
+	}
+
+	pthread_mutex_unlock(&input->queue_mutex);
+
+	os_atomic_inc_long(&input->total_frames);
+	os_sem_post(input->queued_sem);
 }
 
 static inline bool video_output_cur_frame(struct video_output *video)
@@ -142,8 +463,7 @@ static inline bool video_output_cur_frame(struct video_output *video)
 	pthread_mutex_lock(&video->input_mutex);
 
 	for (size_t i = 0; i < video->inputs.num; i++) {
-		struct video_input *input = video->inputs.array + i;
-		struct video_data frame = frame_info->frame;
+		struct video_input *input = video->inputs.array[i];
 
 		// an explicit counter is used instead of remainder calculation
 		// to allow multiple encoders started at the same time to start on
@@ -155,8 +475,7 @@ static inline bool video_output_cur_frame(struct video_output *video)
 		if (skip)
 			continue;
 
-		if (scale_video_output(input, &frame))
-			input->callback(input->param, &frame);
+		video_input_queue_frame(input, frame_info);
 	}
 
 	pthread_mutex_unlock(&video->input_mutex);
@@ -173,8 +492,8 @@ static inline bool video_output_cur_frame(struct video_output *video)
 		if (++video->first_added == video->info.cache_size)
 			video->first_added = 0;
 
-		if (++video->available_frames == video->info.cache_size)
-			video->last_added = video->first_added;
+		video->busy_frames++;
+		release_cached_frames(video);
 	} else if (skipped) {
 		--frame_info->skipped;
 		os_atomic_inc_long(&video->skipped_frames);
@@ -256,14 +575,18 @@ int video_output_open(video_t **video, struct video_output_info *info)
 		goto fail1;
 	if (os_sem_init(&out->update_semaphore, 0) != 0)
 		goto fail2;
-	if (pthread_create(&out->thread, NULL, video_thread, out) != 0)
+	if (os_event_init(&out->available_event, OS_EVENT_TYPE_AUTO) != 0)
 		goto fail3;
+	if (pthread_create(&out->thread, NULL, video_thread, out) != 0)
+		goto fail4;
 
 	init_cache(out);
 
 	*video = out;
 	return VIDEO_OUTPUT_SUCCESS;
 
+fail4:
+	os_event_destroy(out->available_event);
 fail3:
 	os_sem_destroy(out->update_semaphore);
 fail2:
@@ -284,15 +607,21 @@ void video_output_close(video_t *video)
 
 	pthread_mutex_lock(&video->input_mutex);
 
+	/* their threads still release cache entries on their way out */
+	join_detached_inputs(video, true);
+	da_free(video->detached_inputs);
+
 	for (size_t i = 0; i < video->inputs.num; i++)
-		video_input_free(&video->inputs.array[i]);
+		video_input_free(video->inputs.array[i], false);
 	da_free(video->inputs);
+	da_free(video->converters);
 
 	for (size_t i = 0; i < video->info.cache_size; i++)
 		video_frame_free((struct video_frame *)&video->cache[i]);
 
 	pthread_mutex_unlock(&video->input_mutex);
 	os_sem_destroy(video->update_semaphore);
+	os_event_destroy(video->available_event);
 	pthread_mutex_destroy(&video->data_mutex);
 	pthread_mutex_destroy(&video->input_mutex);
 
@@ -303,7 +632,7 @@ static size_t video_get_input_idx(const video_t *video, void (*callback)(void *p
 				  void *param)
 {
 	for (size_t i = 0; i < video->inputs.num; i++) {
-		struct video_input *input = video->inputs.array + i;
+		struct video_input *input = video->inputs.array[i];
 		if (input->callback == callback && input->param == param)
 			return i;
 	}
@@ -337,35 +666,131 @@ static bool match_space(enum video_colorspace a, enum video_colorspace b)
 	return (a == VIDEO_CS_DEFAULT) || (b == VIDEO_CS_DEFAULT) || (collapse_space(a) == collapse_space(b));
 }
 
+static inline bool same_scale_info(const struct video_scale_info *a, const struct video_scale_info *b)
+{
+	return a->format == b->format && a->width == b->width && a->height == b->height && a->range == b->range &&
+	       a->colorspace == b->colorspace;
+}
+
+/* the smallest existing target that's at least as large as the new one and
+ * only differs in size, so the new one can be scaled from it */
+static struct video_converter *find_cascade_source(struct video_output *video, const struct video_scale_info *info)
+{
+	struct video_converter *source = NULL;
+
+	for (size_t i = 0; i < video->converters.num; i++) {
+		struct video_converter *converter = video->converters.array[i];
+		const struct video_scale_info *ci = &converter->info;
+
+		if (ci->format != info->format || ci->range != info->range || ci->colorspace != info->colorspace)
+			continue;
+		if (ci->width < info->width || ci->height < info->height)
+			continue;
+
+		if (!source || (uint64_t)ci->width * ci->height < (uint64_t)source->info.width * source->info.height)
+			source = converter;
+	}
+
+	return source;
+}
+
+static void video_converter_destroy(struct video_converter *converter)
+{
+	for (size_t i = 0; i < converter->frames.num; i++) {
+		video_frame_free(&converter->frames.array[i]->frame);
+		bfree(converter->frames.array[i]);
+	}
+	da_free(converter->frames);
+	video_scaler_destroy(converter->scaler);
+	pthread_mutex_destroy(&converter->mutex);
+	bfree(converter);
+}
+
+static struct video_converter *get_converter(struct video_output *video, const struct video_scale_info *info)
+{
+	struct video_converter *converter;
+
+	for (size_t i = 0; i < video->converters.num; i++) {
+		converter = video->converters.array[i];
+		if (same_scale_info(&converter->info, info)) {
+			converter->refs++;
+			return converter;
+		}
+	}
+
+	converter = bzalloc(sizeof(*converter));
+	converter->info = *info;
+	converter->refs = 1;
+
+	if (video->cascaded_scaling)
+		converter->source = find_cascade_source(video, info);
+
+	struct video_scale_info from = {.format = video->info.format,
+					.width = video->info.width,
+					.height = video->info.height,
+					.range = video->info.range,
+					.colorspace = video->info.colorspace};
+	if (converter->source)
+		from = converter->source->info;
+
+	if (pthread_mutex_init(&converter->mutex, NULL) != 0) {
+		bfree(converter);
+		return NULL;
+	}
+
+	int ret = video_scaler_create(&converter->scaler, info, &from, VIDEO_SCALE_FAST_BILINEAR);
+	if (ret != VIDEO_SCALER_SUCCESS) {
+		if (ret == VIDEO_SCALER_BAD_CONVERSION)
+			blog(LOG_ERROR, "get_converter: Bad "
+					"scale conversion type");
+		else
+			blog(LOG_ERROR, "get_converter: Failed to "
+					"create scaler");
+
+		video_converter_destroy(converter);
+		return NULL;
+	}
+
+	if (converter->source)
+		converter->source->refs++;
+
+	da_push_back(video->converters, &converter);
+	return converter;
+}
+
+static void release_converter(struct video_output *video, struct video_converter *converter)
+{
+	if (--converter->refs)
+		return;
+
+	da_erase_item(video->converters, &converter);
+
+	if (converter->source)
+		release_converter(video, converter->source);
+	video_converter_destroy(converter);
+}
+
 static inline bool video_input_init(struct video_input *input, struct video_output *video)
 {
+	input->video = video;
+
 	if (input->conversion.width != video->info.width || input->conversion.height != video->info.height ||
 	    input->conversion.format != video->info.format ||
 	    !match_range(input->conversion.range, video->info.range) ||
 	    !match_space(input->conversion.colorspace, video->info.colorspace)) {
-		struct video_scale_info from = {.format = video->info.format,
-						.width = video->info.width,
-						.height = video->info.height,
-						.range = video->info.range,
-						.colorspace = video->info.colorspace};
-
-		int ret = video_scaler_create(&input->scaler, &input->conversion, &from, VIDEO_SCALE_FAST_BILINEAR);
-		if (ret != VIDEO_SCALER_SUCCESS) {
-			if (ret == VIDEO_SCALER_BAD_CONVERSION)
-				blog(LOG_ERROR, "video_input_init: Bad "
-						"scale conversion type");
-			else
-				blog(LOG_ERROR, "video_input_init: Failed to "
-						"create scaler");
-
+		input->converter = get_converter(video, &input->conversion);
+		if (!input->converter)
 			return false;
-		}
-
-		for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
-			video_frame_init(&input->frame[i], input->conversion.format, input->conversion.width,
-					 input->conversion.height);
 	}
 
+	if (pthread_mutex_init(&input->queue_mutex, NULL) != 0)
+		return false;
+	if (os_sem_init(&input->queued_sem, 0) != 0)
+		return false;
+	if (pthread_create(&input->thread, NULL, video_input_thread, input) != 0)
+		return false;
+
+	input->thread_active = true;
 	return true;
 }
 
@@ -407,31 +832,33 @@ bool video_output_connect2(video_t *video, const struct video_scale_info *conver
 
 	pthread_mutex_lock(&video->input_mutex);
 
+	join_detached_inputs(video, false);
+
 	if (video_get_input_idx(video, callback, param) == DARRAY_INVALID) {
-		struct video_input input;
-		memset(&input, 0, sizeof(input));
+		struct video_input *input = bzalloc(sizeof(*input));
+		pthread_mutex_init_value(&input->queue_mutex);
 
-		input.callback = callback;
-		input.param = param;
+		input->callback = callback;
+		input->param = param;
 
-		input.frame_rate_divisor = frame_rate_divisor;
+		input->frame_rate_divisor = frame_rate_divisor;
 
 		if (conversion) {
-			input.conversion = *conversion;
+			input->conversion = *conversion;
 		} else {
-			input.conversion.format = video->info.format;
-			input.conversion.width = video->info.width;
-			input.conversion.height = video->info.height;
-			input.conversion.range = video->info.range;
-			input.conversion.colorspace = video->info.colorspace;
+			input->conversion.format = video->info.format;
+			input->conversion.width = video->info.width;
+			input->conversion.height = video->info.height;
+			input->conversion.range = video->info.range;
+			input->conversion.colorspace = video->info.colorspace;
 		}
 
-		if (input.conversion.width == 0)
-			input.conversion.width = video->info.width;
-		if (input.conversion.height == 0)
-			input.conversion.height = video->info.height;
+		if (input->conversion.width == 0)
+			input->conversion.width = video->info.width;
+		if (input->conversion.height == 0)
+			input->conversion.height = video->info.height;
 
-		success = video_input_init(&input, video);
+		success = video_input_init(input, video);
 		if (success) {
 			if (video->inputs.num == 0) {
 				if (!os_atomic_load_long(&video->gpu_refs)) {
@@ -440,6 +867,8 @@ bool video_output_connect2(video_t *video, const struct video_scale_info *conver
 				os_atomic_set_bool(&video->raw_active, true);
 			}
 			da_push_back(video->inputs, &input);
+		} else {
+			video_input_free(input, false);
 		}
 	}
 
@@ -462,6 +891,16 @@ static void log_skipped(video_t *video)
 		     video->skipped_frames, video->total_frames, percentage_skipped);
 }
 
+static void log_lagged(struct video_input *input)
+{
+	long lagged = os_atomic_load_long(&input->lagged_frames);
+	long total = os_atomic_load_long(&input->total_frames);
+
+	if (lagged)
+		blog(LOG_INFO, "Video input stopped, number of frames delayed due to encoding lag: %ld/%ld (%0.1f%%)",
+		     lagged, total, (double)lagged / (double)total * 100.0);
+}
+
 void video_output_disconnect(video_t *video, void (*callback)(void *param, struct video_data *frame), void *param)
 {
 	if (!video || !callback)
@@ -471,11 +910,16 @@ void video_output_disconnect(video_t *video, void (*callback)(void *param, struc
 
 	pthread_mutex_lock(&video->input_mutex);
 
+	join_detached_inputs(video, false);
+
 	size_t idx = video_get_input_idx(video, callback, param);
 	if (idx != DARRAY_INVALID) {
-		video_input_free(video->inputs.array + idx);
+		struct video_input *input = video->inputs.array[idx];
 		da_erase(video->inputs, idx);
 
+		log_lagged(input);
+		video_input_free(input, true);
+
 		if (video->inputs.num == 0) {
 			os_atomic_set_bool(&video->raw_active, false);
 			if (!os_atomic_load_long(&video->gpu_refs)) {
@@ -487,6 +931,90 @@ void video_output_disconnect(video_t *video, void (*callback)(void *param, struc
 	pthread_mutex_unlock(&video->input_mutex);
 }
 
+struct moved_input {
+	struct video_scale_info conversion;
+	uint32_t frame_rate_divisor;
+	void (*callback)(void *param, struct video_data *frame);
+	void *param;
+};
+
+size_t video_output_move_inputs(video_t *video, video_t *target)
+{
+	DARRAY(struct moved_input) moved;
+	size_t count = 0;
+
+	if (!video || !target)
+		return 0;
+
+	video = get_root(video);
+	target = get_root(target);
+	if (video == target)
+		return 0;
+
+	da_init(moved);
+
+	pthread_mutex_lock(&video->input_mutex);
+
+	for (size_t i = 0; i < video->inputs.num; i++) {
+		struct video_input *input = video->inputs.array[i];
+		struct moved_input *m = da_push_back_new(moved);
+
+		m->conversion = input->conversion;
+		m->frame_rate_divisor = input->frame_rate_divisor;
+		m->callback = input->callback;
+		m->param = input->param;
+
+		video_input_free(input, true);
+	}
+
+	da_free(video->inputs);
+	os_atomic_set_bool(&video->raw_active, false);
+
+	pthread_mutex_unlock(&video->input_mutex);
+
+	for (size_t i = 0; i < moved.num; i++) {
+		struct moved_input *m = moved.array + i;
+		if (video_output_connect2(target, &m->conversion, m->frame_rate_divisor, m->callback, m->param))
+			count++;
+	}
+
+	da_free(moved);
+	return count;
+}
+
+uint32_t video_output_get_input_lagged_frames(video_t *video,
+					      void (*callback)(void *param, struct video_data *frame), void *param)
+{
+	uint32_t lagged = 0;
+
+	if (!video || !callback)
+		return 0;
+
+	video = get_root(video);
+
+	pthread_mutex_lock(&video->input_mutex);
+
+	size_t idx = video_get_input_idx(video, callback, param);
+	if (idx != DARRAY_INVALID)
+		lagged = (uint32_t)os_atomic_load_long(&video->inputs.array[idx]->lagged_frames);
+
+	pthread_mutex_unlock(&video->input_mutex);
+
+	return lagged;
+}
+
+void video_output_set_cascaded_scaling(video_t *video, bool enable)
+{
+	if (!video)
+		return;
+
+	video = get_root(video);
+
+	pthread_mutex_lock(&video->input_mutex);
+	video->cascaded_scaling = enable;
+	pthread_mutex_unlock(&video->input_mutex);
+}
+
 bool video_output_active(const video_t *video)
 {
 	if (!video)
@@ -511,6 +1039,12 @@ bool video_output_lock_frame(video_t *video, struct video_frame *frame, int coun
 
 	pthread_mutex_lock(&video->data_mutex);
 
+	while (video->available_frames == 0 && os_atomic_load_bool(&video->offline) && !video->stop) {
+		pthread_mutex_unlock(&video->data_mutex);
+		os_event_wait(video->available_event);
+		pthread_mutex_lock(&video->data_mutex);
+	}
+
 	if (video->available_frames == 0) {
 		video->cache[video->last_added].count += count;
 		video->cache[video->last_added].skipped += count;
@@ -526,6 +1060,7 @@ bool video_output_lock_frame(video_t *video, struct video_frame *frame, int coun
 		cfi->frame.timestamp = timestamp;
 		cfi->count = count;
 		cfi->skipped = 0;
+		cfi->id = ++video->last_id;
 
 		memcpy(frame, &cfi->frame, sizeof(*frame));
 
@@ -569,10 +1104,21 @@ void video_output_stop(video_t *video)
 	if (!video->stop) {
 		video->stop = true;
 		os_sem_post(video->update_semaphore);
+		os_event_signal(video->available_event);
 		pthread_join(video->thread, &thread_ret);
 	}
 }
 
+void video_output_set_offline(video_t *video, bool offline)
+{
+	if (!video)
+		return;
+
+	video = get_root(video);
+	os_atomic_set_bool(&video->offline, offline);
+	os_event_signal(video->available_event);
+}
+
 bool video_output_stopped(video_t *video)
 {
 	if (!video)
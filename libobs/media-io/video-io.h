@@ -306,6 +306,15 @@ EXPORT bool video_output_connect2(video_t *video, const struct video_scale_info
 EXPORT void video_output_disconnect(video_t *video, void (*callback)(void *param, struct video_data *frame),
 				    void *param);
 
+/* moves all inputs over to another video output, keeping their conversions.
+ * returns the number of inputs that were moved */
+EXPORT size_t video_output_move_inputs(video_t *video, video_t *target);
+
+/* when enabled, new conversions that only differ from an existing one in size
+ * are scaled from its output, e.g. 480p from 720p, instead of from the full
+ * size frame.  cheaper, at the cost of some quality. */
+EXPORT void video_output_set_cascaded_scaling(video_t *video, bool enable);
+
 EXPORT bool video_output_active(const video_t *video);
 
 EXPORT const struct video_output_info *video_output_get_info(const video_t *video);
@@ -313,6 +322,10 @@ EXPORT bool video_output_lock_frame(video_t *video, struct video_frame *frame, i
 EXPORT void video_output_unlock_frame(video_t *video);
 EXPORT uint64_t video_output_get_frame_time(const video_t *video);
 EXPORT void video_output_stop(video_t *video);
+
+/* in offline mode frames are never skipped, video_output_lock_frame waits
+ * for the outputs to catch up instead */
+EXPORT void video_output_set_offline(video_t *video, bool offline);
 EXPORT bool video_output_stopped(video_t *video);
 
 EXPORT enum video_format video_output_get_format(const video_t *video);
@@ -322,6 +335,9 @@ EXPORT double video_output_get_frame_rate(const video_t *video);
 
 EXPORT uint32_t video_output_get_skipped_frames(const video_t *video);
 EXPORT uint32_t video_output_get_total_frames(const video_t *video);
+EXPORT uint32_t video_output_get_input_lagged_frames(video_t *video,
+						     void (*callback)(void *param, struct video_data *frame),
+						     void *param);
 
 extern void video_output_inc_texture_encoders(video_t *video);
 extern void video_output_dec_texture_encoders(video_t *video);
@@ -293,6 +293,27 @@ static void maybe_set_up_gpu_rescale(struct obs_encoder *encoder)
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
 }
 
+static void connect_video(struct obs_encoder *encoder)
+{
+	struct video_scale_info info = {0};
+	get_video_info(encoder, &info);
+
+	if (gpu_encode_available(encoder)) {
+		start_gpu_encode(encoder);
+	} else {
+		start_raw_video(encoder->media, &info, encoder->frame_rate_divisor, receive_video, encoder);
+	}
+}
+
+static void disconnect_video(struct obs_encoder *encoder)
+{
+	if (gpu_encode_available(encoder)) {
+		stop_gpu_encode(encoder);
+	} else {
+		stop_raw_video(encoder->media, receive_video, encoder);
+	}
+}
+
 static void add_connection(struct obs_encoder *encoder)
 {
 	if (encoder->info.type == OBS_ENCODER_AUDIO) {
@@ -301,14 +322,7 @@ static void add_connection(struct obs_encoder *encoder)
 
 		audio_output_connect(encoder->media, encoder->mixer_idx, &audio_info, receive_audio, encoder);
 	} else {
-		struct video_scale_info info = {0};
-		get_video_info(encoder, &info);
-
-		if (gpu_encode_available(encoder)) {
-			start_gpu_encode(encoder);
-		} else {
-			start_raw_video(encoder->media, &info, encoder->frame_rate_divisor, receive_video, encoder);
-		}
+		connect_video(encoder);
 	}
 
 	if (encoder->encoder_group) {
@@ -324,18 +338,8 @@ static void add_connection(struct obs_encoder *encoder)
 }
 
 void obs_encoder_group_actually_destroy(obs_encoder_group_t *group);
-static void remove_connection(struct obs_encoder *encoder, bool shutdown)
+static void release_connection(struct obs_encoder *encoder, bool shutdown)
 {
-	if (encoder->info.type == OBS_ENCODER_AUDIO) {
-		audio_output_disconnect(encoder->media, encoder->mixer_idx, receive_audio, encoder);
-	} else {
-		if (gpu_encode_available(encoder)) {
-			stop_gpu_encode(encoder);
-		} else {
-			stop_raw_video(encoder->media, receive_video, encoder);
-		}
-	}
-
 	if (encoder->encoder_group) {
 		pthread_mutex_lock(&encoder->encoder_group->mutex);
 		if (--encoder->encoder_group->num_encoders_started == 0)
@@ -355,6 +359,17 @@ static void remove_connection(struct obs_encoder *encoder, bool shutdown)
 	set_encoder_active(encoder, false);
 }
 
+static void remove_connection(struct obs_encoder *encoder, bool shutdown)
+{
+	if (encoder->info.type == OBS_ENCODER_AUDIO) {
+		audio_output_disconnect(encoder->media, encoder->mixer_idx, receive_audio, encoder);
+	} else {
+		disconnect_video(encoder);
+	}
+
+	release_connection(encoder, shutdown);
+}
+
 static inline void free_audio_buffers(struct obs_encoder *encoder)
 {
 	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
@@ -1254,19 +1269,24 @@ static inline void send_packet(struct obs_encoder *encoder, struct encoder_callb
 	profile_end(send_packet_name);
 }
 
+static void force_stop_outputs(struct obs_encoder *encoder)
+{
+	pthread_mutex_lock(&encoder->outputs_mutex);
+	for (size_t i = 0; i < encoder->outputs.num; i++) {
+		struct obs_output *output = encoder->outputs.array[i];
+		obs_output_force_stop(output);
+
+		pthread_mutex_lock(&output->interleaved_mutex);
+		output->info.encoded_packet(output->context.data, NULL);
+		pthread_mutex_unlock(&output->interleaved_mutex);
+	}
+	pthread_mutex_unlock(&encoder->outputs_mutex);
+}
+
 void full_stop(struct obs_encoder *encoder)
 {
 	if (encoder) {
-		pthread_mutex_lock(&encoder->outputs_mutex);
-		for (size_t i = 0; i < encoder->outputs.num; i++) {
-			struct obs_output *output = encoder->outputs.array[i];
-			obs_output_force_stop(output);
-
-			pthread_mutex_lock(&output->interleaved_mutex);
-			output->info.encoded_packet(output->context.data, NULL);
-			pthread_mutex_unlock(&output->interleaved_mutex);
-		}
-		pthread_mutex_unlock(&encoder->outputs_mutex);
+		force_stop_outputs(encoder);
 
 		pthread_mutex_lock(&encoder->callbacks_mutex);
 		da_free(encoder->callbacks);
@@ -1276,6 +1296,79 @@ void full_stop(struct obs_encoder *encoder)
 	}
 }
 
+void obs_encoder_begin_video_switch(obs_encoder_t *encoder)
+{
+	pthread_mutex_lock(&encoder->init_mutex);
+
+	if (!encoder_active(encoder))
+		return;
+
+	pthread_mutex_lock(&encoder->pause.mutex);
+	uint64_t last_ts = encoder->pause.last_video_ts;
+	pthread_mutex_unlock(&encoder->pause.mutex);
+
+	encoder->resync_ts = last_ts ? last_ts + video_output_get_frame_time(encoder->media) : 0;
+
+	disconnect_video(encoder);
+}
+
+bool obs_encoder_end_video_switch(obs_encoder_t *encoder, video_t *video)
+{
+	if (!encoder_active(encoder)) {
+		/* it gets created for the new video the next time it starts */
+		obs_encoder_shutdown(encoder);
+		encoder->initialized = false;
+		encoder_set_video(encoder, video);
+
+		pthread_mutex_unlock(&encoder->init_mutex);
+		return true;
+	}
+
+	uint32_t old_timebase_den = encoder->timebase_den;
+
+	/* packets still buffered in the old encoder are dropped, the first
+	 * packet of the new one is a keyframe */
+	encoder->info.destroy(encoder->context.data);
+	encoder->context.data = NULL;
+	encoder_set_video(encoder, video);
+
+	can_reroute = true;
+	encoder->info = encoder->orig_info;
+	encoder->context.data = encoder->orig_info.create(encoder->context.settings, encoder);
+	can_reroute = false;
+
+	if (!encoder->context.data) {
+		blog(LOG_ERROR, "Failed to reinitialize encoder '%s' for the new video settings",
+		     encoder->context.name);
+
+		pthread_mutex_lock(&encoder->callbacks_mutex);
+		da_free(encoder->callbacks);
+		pthread_mutex_unlock(&encoder->callbacks_mutex);
+
+		release_connection(encoder, false);
+		pthread_mutex_unlock(&encoder->init_mutex);
+
+		force_stop_outputs(encoder);
+		return false;
+	}
+
+	/* pts continue in the new time base, so outputs see a gap in the
+	 * timeline rather than a restart */
+	encoder->cur_pts = (int64_t)util_mul_div64(encoder->cur_pts, encoder->timebase_den, old_timebase_den);
+	encoder->frame_rate_divisor_counter = 0;
+
+	/* include the headers of the new encoder with its first packet */
+	pthread_mutex_lock(&encoder->callbacks_mutex);
+	for (size_t i = 0; i < encoder->callbacks.num; i++)
+		encoder->callbacks.array[i].sent_first_packet = false;
+	pthread_mutex_unlock(&encoder->callbacks_mutex);
+
+	connect_video(encoder);
+
+	pthread_mutex_unlock(&encoder->init_mutex);
+	return true;
+}
+
 void send_off_encoder_packet(obs_encoder_t *encoder, bool success, bool received, struct encoder_packet *pkt)
 {
 	if (!success) {
@@ -1421,6 +1514,20 @@ bool video_pause_check(struct pause_data *pause, uint64_t timestamp)
 	return ignore_frame;
 }
 
+void video_resync_check(struct obs_encoder *encoder, uint64_t timestamp)
+{
+	if (!encoder->resync_ts)
+		return;
+
+	if (timestamp > encoder->resync_ts) {
+		uint64_t frame_ns = util_mul_div64(1000000000ULL, encoder->timebase_num, encoder->timebase_den);
+		uint64_t missed = (timestamp - encoder->resync_ts + frame_ns / 2) / frame_ns;
+		encoder->cur_pts += (int64_t)(missed * encoder->timebase_num);
+	}
+
+	encoder->resync_ts = 0;
+}
+
 static const char *receive_video_name = "receive_video";
 static void receive_video(void *param, struct video_data *frame)
 {
@@ -1457,6 +1564,8 @@ static void receive_video(void *param, struct video_data *frame)
 	if (video_pause_check(&encoder->pause, frame->timestamp))
 		goto wait_for_audio;
 
+	video_resync_check(encoder, frame->timestamp);
+
 	memset(&enc_frame, 0, sizeof(struct encoder_frame));
 
 	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
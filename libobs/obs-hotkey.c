@@ -500,8 +500,28 @@ static inline void load_bindings(obs_hotkey_t *hotkey, obs_data_array_t *data)
 
 static inline bool remove_bindings(obs_hotkey_id id);
 
+/* source hotkey bindings are saved with the source, so changing them has to
+ * change the source's save revision.  returns a reference to the source. */
+static inline obs_source_t *get_source_registerer(obs_hotkey_t *hotkey)
+{
+	if (!hotkey || hotkey->registerer_type != OBS_HOTKEY_REGISTERER_SOURCE)
+		return NULL;
+
+	return obs_weak_source_get_source(hotkey->registerer);
+}
+
+static inline void source_bindings_changed(obs_source_t *source)
+{
+	if (source) {
+		obs_source_mark_modified(source);
+		obs_source_release(source);
+	}
+}
+
 void obs_hotkey_load_bindings(obs_hotkey_id id, obs_key_combination_t *combinations, size_t num)
 {
+	obs_source_t *source = NULL;
+
 	if (!lock())
 		return;
 
@@ -514,13 +534,19 @@ void obs_hotkey_load_bindings(obs_hotkey_id id, obs_key_combination_t *combinati
 
 		if (num || changed)
 			hotkey_signal("hotkey_bindings_changed", hotkey);
+
+		source = get_source_registerer(hotkey);
 	}
 
 	unlock();
+
+	source_bindings_changed(source);
 }
 
 void obs_hotkey_load(obs_hotkey_id id, obs_data_array_t *data)
 {
+	obs_source_t *source = NULL;
+
 	if (!lock())
 		return;
 
@@ -529,8 +555,11 @@ void obs_hotkey_load(obs_hotkey_id id, obs_data_array_t *data)
 	if (hotkey) {
 		remove_bindings(id);
 		load_bindings(hotkey, data);
+		source = get_source_registerer(hotkey);
 	}
 	unlock();
+
+	source_bindings_changed(source);
 }
 
 static inline bool enum_load_bindings(void *data, obs_hotkey_t *hotkey)
@@ -590,6 +619,8 @@ void obs_hotkeys_load_source(obs_source_t *source, obs_data_t *hotkeys)
 
 void obs_hotkey_pair_load(obs_hotkey_pair_id id, obs_data_array_t *data0, obs_data_array_t *data1)
 {
+	obs_source_t *source = NULL;
+
 	if ((!data0 && !data1) || !lock())
 		return;
 
@@ -611,8 +642,12 @@ void obs_hotkey_pair_load(obs_hotkey_pair_id id, obs_data_array_t *data0, obs_da
 		load_bindings(p2, data1);
 	}
 
+	source = get_source_registerer(p1 ? p1 : p2);
+
 unlock:
 	unlock();
+
+	source_bindings_changed(source);
 }
 
 static inline void save_modifier(uint32_t modifiers, obs_data_t *data, const char *name, uint32_t flag)
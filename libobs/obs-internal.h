@@ -25,6 +25,7 @@
 #include "util/platform.h"
 #include "util/profiler.h"
 #include "util/task.h"
+#include "util/file-watcher.h"
 #include "util/uthash.h"
 #include "util/array-serializer.h"
 #include "callback/signal.h"
@@ -313,6 +314,17 @@ struct obs_core_video_mix {
 
 	bool encoder_only_mix;
 	long encoder_refs;
+
+	/* every mix is rendered on the ticks of its own frame rate, see
+	 * video_sleep.  only touched by the graphics thread */
+	uint64_t frame_interval_ns;
+	uint64_t next_frame_ts;
+	uint64_t rendered_frame_ts;
+	bool frame_pending;
+	bool frame_due;
+
+	volatile long total_frames;
+	volatile long lagged_frames;
 };
 
 extern struct obs_core_video_mix *obs_create_video_mix(struct obs_video_info *ovi);
@@ -343,6 +355,16 @@ struct obs_core_video {
 	uint32_t lagged_frames;
 	bool thread_initialized;
 
+	/* rendering on a virtual clock, see obs_set_offline_rendering */
+	volatile bool offline;
+	/* signaled by gpu encode threads when they're done with a frame or
+	 * stop, so offline rendering can wait for them */
+	os_event_t *gpu_encode_done;
+
+	/* see obs_set_frame_pacing */
+	volatile long pacing_spin_us;
+	volatile bool pacing_realtime;
+
 	gs_texture_t *transparent_texture;
 
 	gs_effect_t *deinterlace_discard_effect;
@@ -385,6 +407,9 @@ struct obs_core_audio {
 	int max_buffering_ticks;
 	bool fixed_buffer;
 
+	/* frames per tick */
+	uint32_t output_frames;
+
 	pthread_mutex_t monitoring_mutex;
 	DARRAY(struct audio_monitor *) monitors;
 	char *monitoring_device_name;
@@ -392,6 +417,15 @@ struct obs_core_audio {
 
 	pthread_mutex_t task_mutex;
 	struct deque tasks;
+
+	/* the source whose audio the audio thread follows, and how much audio
+	 * it has produced, see obs_set_audio_clock_source */
+	pthread_mutex_t clock_mutex;
+	struct obs_source *clock_source;
+	uint64_t clock_base;
+	uint64_t clock_frames;
+	uint32_t clock_rate;
+	uint64_t clock_ts;
 };
 
 /* user sources, output channels, and displays */
@@ -428,6 +462,11 @@ struct obs_core_data {
 
 	DARRAY(char *) protocols;
 	DARRAY(obs_source_t *) sources_to_tick;
+
+	/* sources loaded lazily are created here when first used */
+	os_task_queue_t *lazy_create_queue;
+	volatile bool lazy_create;
+	volatile bool lazy_create_stopped;
 };
 
 /* user hotkeys */
@@ -496,6 +535,7 @@ struct obs_core {
 	struct obs_core_hotkeys hotkeys;
 
 	os_task_queue_t *destruction_task_thread;
+	os_file_watcher_t *file_watcher;
 
 	obs_task_handler_t ui_task_handler;
 };
@@ -509,6 +549,9 @@ struct obs_graphics_context {
 	uint64_t fps_total_ns;
 	uint32_t fps_total_frames;
 	const char *video_thread_name;
+	bool offline;
+	bool realtime;
+	uint64_t last_display_time;
 };
 
 extern void *obs_graphics_thread(void *param);
@@ -758,6 +801,13 @@ struct obs_source {
 	float *audio_mix_buf[MAX_AUDIO_CHANNELS];
 	struct resample_info sample_info;
 	audio_resampler_t *resampler;
+
+	/* adaptive resampling to follow the audio clock, see
+	 * obs_set_audio_clock_source */
+	bool clock_compensated;
+	double clock_ratio;
+	double clock_drift;
+	double clock_error;
 	pthread_mutex_t audio_actions_mutex;
 	pthread_mutex_t audio_buf_mutex;
 	pthread_mutex_t audio_mutex;
@@ -882,6 +932,18 @@ struct obs_source {
 
 	/* private data */
 	obs_data_t *private_settings;
+
+	/* changes whenever anything saved by obs_save_source changes, other
+	 * than the contents of the settings/private settings objects */
+	volatile long save_revision;
+
+	/* loaded lazily, the type data hasn't been created yet.  whichever
+	 * thread sets create_started creates it, and signals created_event
+	 * once it's been created and loaded. */
+	volatile bool create_pending;
+	volatile bool create_queued;
+	volatile bool create_started;
+	os_event_t *created_event;
 };
 
 extern struct obs_source_info *get_source_info(const char *id);
@@ -903,6 +965,21 @@ extern void audio_monitor_destroy(struct audio_monitor *monitor);
 extern obs_source_t *obs_source_create_set_last_ver(const char *id, const char *name, const char *uuid,
 						    obs_data_t *settings, obs_data_t *hotkey_data,
 						    uint32_t last_obs_ver, bool is_private);
+
+/* Creates a source without calling its type's create callback.  The caller
+ * must then call obs_source_create_data (which may be done from any thread
+ * for types with OBS_SOURCE_CAP_PARALLEL_CREATE) followed by
+ * obs_source_create_end before the source is used. */
+extern obs_source_t *obs_source_create_deferred(const char *id, const char *name, const char *uuid,
+						obs_data_t *settings, obs_data_t *hotkey_data, uint32_t last_obs_ver,
+						bool is_private);
+extern void obs_source_create_data(obs_source_t *source);
+extern void obs_source_create_end(obs_source_t *source);
+
+/* creates and loads the type data of a source loaded lazily on the lazy
+ * creation queue.  does nothing for sources that have already been created. */
+extern void obs_source_queue_create(obs_source_t *source);
+
 extern void obs_source_destroy(struct obs_source *source);
 extern void obs_source_addref(obs_source_t *source);
 
@@ -924,6 +1001,16 @@ static inline void obs_source_dosignal(struct obs_source *source, const char *si
 		signal_handler_signal(source->context.signals, signal_source, &data);
 }
 
+/* filters are saved as part of their parent */
+static inline void obs_source_mark_modified(struct obs_source *source)
+{
+	struct obs_source *parent = source->filter_parent;
+
+	os_atomic_inc_long(&source->save_revision);
+	if (parent)
+		os_atomic_inc_long(&parent->save_revision);
+}
+
 /* maximum timestamp variance in nanoseconds */
 #define MAX_TS_VAR 2000000000ULL
 
@@ -1060,6 +1147,7 @@ struct pause_data {
 };
 
 extern bool video_pause_check(struct pause_data *pause, uint64_t timestamp);
+extern void video_resync_check(struct obs_encoder *encoder, uint64_t timestamp);
 extern bool audio_pause_check(struct pause_data *pause, struct audio_data *data, size_t sample_rate);
 extern void pause_reset(struct pause_data *pause);
 
@@ -1190,6 +1278,10 @@ extern void obs_output_remove_encoder(struct obs_output *output, struct obs_enco
 extern void obs_encoder_packet_create_instance(struct encoder_packet *dst, const struct encoder_packet *src);
 void obs_output_destroy(obs_output_t *output);
 
+/* moves outputs over to a new video output, see obs_reconfigure_video */
+extern bool obs_output_begin_video_switch(obs_output_t *output);
+extern void obs_output_end_video_switch(obs_output_t *output, video_t *video, bool reconnect);
+
 /* ------------------------------------------------------------------------- */
 /* encoders  */
 
@@ -1283,6 +1375,10 @@ struct obs_encoder {
 	uint64_t first_raw_ts;
 	uint64_t start_ts;
 
+	/* timestamp the next frame was expected at when the video was
+	 * reconfigured, frames missed until then still advance cur_pts */
+	uint64_t resync_ts;
+
 	/* track encoders that are part of a gop-aligned multi track group */
 	struct obs_encoder_group *encoder_group;
 
@@ -1323,6 +1419,11 @@ extern void stop_gpu_encode(obs_encoder_t *encoder);
 extern bool do_encode(struct obs_encoder *encoder, struct encoder_frame *frame, const uint64_t *frame_cts);
 extern void send_off_encoder_packet(obs_encoder_t *encoder, bool success, bool received, struct encoder_packet *pkt);
 
+/* moves video encoders over to a new video output, see obs_reconfigure_video.
+ * init_mutex stays locked from the beginning to the end of the switch */
+extern void obs_encoder_begin_video_switch(obs_encoder_t *encoder);
+extern bool obs_encoder_end_video_switch(obs_encoder_t *encoder, video_t *video);
+
 void obs_encoder_destroy(obs_encoder_t *encoder);
 
 /* ------------------------------------------------------------------------- */
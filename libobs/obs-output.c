@@ -510,7 +510,7 @@ void obs_output_stop(obs_output_t *output)
 		obs_output_delay_stop(output);
 	} else if (!stopping(output)) {
 		do_output_signal(output, "stopping");
-		obs_output_actual_stop(output, false, os_gettime_ns());
+		obs_output_actual_stop(output, false, obs_get_time_ns());
 	}
 }
 
@@ -623,7 +623,7 @@ static inline uint64_t get_closest_v_ts(struct pause_data *pause)
 {
 	uint64_t interval = obs->video.video_frame_interval_ns;
 	uint64_t i2 = interval * 2;
-	uint64_t ts = os_gettime_ns();
+	uint64_t ts = obs_get_time_ns();
 
 	return pause->last_video_ts + ((ts - pause->last_video_ts + i2) / interval) * interval;
 }
@@ -2263,6 +2263,26 @@ static void default_raw_video_callback(void *param, struct video_data *frame)
 	output->total_frames++;
 }
 
+bool obs_output_begin_video_switch(obs_output_t *output)
+{
+	/* encoded outputs follow their encoders, only raw outputs are
+	 * connected to the video output themselves */
+	if (flag_encoded(output) || !flag_video(output) || !data_active(output))
+		return false;
+
+	stop_raw_video(output->video, default_raw_video_callback, output);
+	return true;
+}
+
+void obs_output_end_video_switch(obs_output_t *output, video_t *video, bool reconnect)
+{
+	output->video = video;
+
+	if (reconnect)
+		start_raw_video(output->video, obs_output_get_video_conversion(output), 1, default_raw_video_callback,
+				output);
+}
+
 static bool prepare_audio(struct obs_output *output, const struct audio_data *old, struct audio_data *new)
 {
 	if ((output->info.flags & OBS_OUTPUT_VIDEO) == 0) {
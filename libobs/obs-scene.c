@@ -173,6 +173,11 @@ static void *scene_create(obs_data_t *settings, struct obs_source *source)
 				"mutex");
 		goto fail;
 	}
+	if (pthread_rwlock_init(&scene->index_lock, NULL) != 0) {
+		blog(LOG_ERROR, "scene_create: Couldn't initialize index "
+				"lock");
+		goto fail;
+	}
 
 	scene->absolute_coordinates = obs_data_get_bool(obs->data.private_data, "AbsoluteCoordinates");
 
@@ -237,6 +242,8 @@ static void scene_destroy(void *data)
 
 	pthread_mutex_destroy(&scene->video_mutex);
 	pthread_mutex_destroy(&scene->audio_mutex);
+	pthread_rwlock_destroy(&scene->index_lock);
+	da_free(scene->group_items);
 	da_free(scene->mix_sources);
 	bfree(scene);
 }
@@ -292,8 +299,106 @@ static void scene_enum_all_sources(void *data, obs_source_enum_proc_t enum_callb
 	scene_enum_sources(data, enum_callback, param, false);
 }
 
+/* ------------------------------------------------------------------------- */
+/* source name/UUID index */
+
+static inline void scene_index_add_name(struct obs_scene *scene, struct scene_source_index *entry)
+{
+	if (entry->name)
+		HASH_ADD_KEYPTR(hh_name, scene->index_by_name, entry->name, strlen(entry->name), entry);
+}
+
+static inline void scene_index_remove_name(struct obs_scene *scene, struct scene_source_index *entry)
+{
+	if (entry->name)
+		HASH_DELETE(hh_name, scene->index_by_name, entry);
+}
+
+static void scene_index_add(struct obs_scene *scene, struct obs_scene_item *item)
+{
+	struct obs_source *source = item->source;
+	struct scene_source_index *entry;
+
+	pthread_rwlock_wrlock(&scene->index_lock);
+
+	HASH_FIND_UUID(scene->index_by_uuid, source->context.uuid, entry);
+	if (!entry) {
+		entry = bzalloc(sizeof(*entry));
+		entry->source = source;
+		entry->uuid = source->context.uuid;
+		entry->name = bstrdup(source->context.name);
+
+		HASH_ADD_UUID(scene->index_by_uuid, uuid, entry);
+		scene_index_add_name(scene, entry);
+	}
+
+	da_push_back(entry->items, &item);
+	if (item->is_group)
+		da_push_back(scene->group_items, &item);
+
+	pthread_rwlock_unlock(&scene->index_lock);
+}
+
+static void scene_index_remove(struct obs_scene *scene, struct obs_scene_item *item)
+{
+	struct scene_source_index *entry;
+
+	pthread_rwlock_wrlock(&scene->index_lock);
+
+	HASH_FIND_UUID(scene->index_by_uuid, item->source->context.uuid, entry);
+	if (entry) {
+		da_erase_item(entry->items, &item);
+
+		if (!entry->items.num) {
+			HASH_DELETE(hh_uuid, scene->index_by_uuid, entry);
+			scene_index_remove_name(scene, entry);
+			da_free(entry->items);
+			bfree(entry->name);
+			bfree(entry);
+		}
+	}
+
+	if (item->is_group)
+		da_erase_item(scene->group_items, &item);
+
+	pthread_rwlock_unlock(&scene->index_lock);
+}
+
+static void scene_index_rename(struct obs_scene *scene, struct obs_source *source)
+{
+	struct scene_source_index *entry;
+
+	pthread_rwlock_wrlock(&scene->index_lock);
+
+	/* called once per item using the source, only the first one has work */
+	HASH_FIND_UUID(scene->index_by_uuid, source->context.uuid, entry);
+	if (entry && strcmp(entry->name ? entry->name : "", source->context.name ? source->context.name : "") != 0) {
+		scene_index_remove_name(scene, entry);
+		bfree(entry->name);
+		entry->name = bstrdup(source->context.name);
+		scene_index_add_name(scene, entry);
+	}
+
+	pthread_rwlock_unlock(&scene->index_lock);
+}
+
+static inline void set_sceneitem_parent(struct obs_scene_item *item, struct obs_scene *parent)
+{
+	if (item->parent == parent)
+		return;
+
+	if (item->parent)
+		scene_index_remove(item->parent, item);
+	item->parent = parent;
+	scene_index_add(parent, item);
+}
+
+/* ------------------------------------------------------------------------- */
+
 static inline void detach_sceneitem(struct obs_scene_item *item)
 {
+	scene_index_remove(item->parent, item);
+
 	if (item->prev)
 		item->prev->next = item->next;
 	else
@@ -309,6 +414,7 @@ static inline void attach_sceneitem(struct obs_scene *parent, struct obs_scene_i
 {
 	item->prev = prev;
 	item->parent = parent;
+	scene_index_add(parent, item);
 
 	if (prev) {
 		item->next = prev->next;
@@ -1493,7 +1599,7 @@ static void apply_scene_item_audio_actions(struct obs_scene_item *item, float *b
 
 		new_frame_num = util_mul_div64(timestamp - ts, sample_rate, 1000000000ULL);
 
-		if (ts && new_frame_num >= AUDIO_OUTPUT_FRAMES)
+		if (ts && new_frame_num >= obs->audio.output_frames)
 			break;
 
 		da_erase(item->audio_actions, i--);
@@ -1511,7 +1617,7 @@ static void apply_scene_item_audio_actions(struct obs_scene_item *item, float *b
 	}
 
 	if (buf) {
-		for (; frame_num < AUDIO_OUTPUT_FRAMES; frame_num++)
+		for (; frame_num < obs->audio.output_frames; frame_num++)
 			buf[frame_num] = cur_visible ? 1.0f : 0.0f;
 	}
 
@@ -1538,7 +1644,7 @@ static bool apply_scene_item_volume(struct obs_scene_item *item, float *buf, uin
 	pthread_mutex_unlock(&item->actions_mutex);
 
 	if (actions_pending) {
-		uint64_t duration = util_mul_div64(AUDIO_OUTPUT_FRAMES, 1000000000ULL, sample_rate);
+		uint64_t duration = util_mul_div64(obs->audio.output_frames, 1000000000ULL, sample_rate);
 
 		if (!ts || action.timestamp < (ts + duration)) {
 			apply_scene_item_audio_actions(item, buf, ts, sample_rate);
@@ -1662,7 +1768,7 @@ static bool scene_audio_render_internal(struct obs_scene *scene, struct obs_scen
 
 		pos = (size_t)ns_to_audio_frames(sample_rate, source_ts - timestamp);
 
-		if (pos >= AUDIO_OUTPUT_FRAMES) {
+		if (pos >= obs->audio.output_frames) {
 			item = item->next;
 			continue;
 		}
@@ -1672,7 +1778,7 @@ static bool scene_audio_render_internal(struct obs_scene *scene, struct obs_scen
 			continue;
 		}
 
-		size_t count = AUDIO_OUTPUT_FRAMES - pos;
+		size_t count = obs->audio.output_frames - pos;
 
 		/* Update buf so that parent mute state applies to all current
 		 * scene items as well */
@@ -2068,18 +2174,17 @@ obs_scene_t *obs_group_from_source(const obs_source_t *source)
 	return source->context.data;
 }
 
-obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene, const char *name)
+/* the same source can be added to a scene more than once, in which case the
+ * lowest item in the list is returned like before the index existed */
+static obs_sceneitem_t *find_first_item_with_source(obs_scene_t *scene, obs_source_t *source)
 {
 	struct obs_scene_item *item;
 
-	if (!scene)
-		return NULL;
-
 	full_lock(scene);
 
 	item = scene->first_item;
 	while (item) {
-		if (strcmp(item->source->context.name, name) == 0)
+		if (item->source == source)
 			break;
 
 		item = item->next;
@@ -2090,13 +2195,86 @@ obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene, const char *name)
 	return item;
 }
 
+static obs_sceneitem_t *find_indexed_item(struct scene_source_index *entry, bool *multiple)
+{
+	*multiple = entry && entry->items.num > 1;
+	return entry ? entry->items.array[0] : NULL;
+}
+
+obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene, const char *name)
+{
+	struct scene_source_index *entry;
+	struct obs_scene_item *item;
+	bool multiple;
+
+	if (!scene || !name)
+		return NULL;
+
+	pthread_rwlock_rdlock(&scene->index_lock);
+	HASH_FIND(hh_name, scene->index_by_name, name, strlen(name), entry);
+	item = find_indexed_item(entry, &multiple);
+	pthread_rwlock_unlock(&scene->index_lock);
+
+	if (multiple)
+		item = find_first_item_with_source(scene, item->source);
+
+	return item;
+}
+
+obs_sceneitem_t *obs_scene_find_source_by_uuid(obs_scene_t *scene, const char *uuid)
+{
+	struct scene_source_index *entry;
+	struct obs_scene_item *item;
+	bool multiple;
+
+	if (!scene || !uuid || strlen(uuid) != UUID_STR_LENGTH)
+		return NULL;
+
+	pthread_rwlock_rdlock(&scene->index_lock);
+	HASH_FIND_UUID(scene->index_by_uuid, uuid, entry);
+	item = find_indexed_item(entry, &multiple);
+	pthread_rwlock_unlock(&scene->index_lock);
+
+	if (multiple)
+		item = find_first_item_with_source(scene, item->source);
+
+	return item;
+}
+
+/* group indexes are only read here, and nothing waits for another index
+ * lock while holding one for writing, so nesting them can't deadlock */
+static bool groups_contain_source(struct obs_scene *scene, const char *name)
+{
+	bool found = false;
+
+	pthread_rwlock_rdlock(&scene->index_lock);
+	for (size_t i = 0; i < scene->group_items.num && !found; i++) {
+		struct obs_scene *group = scene->group_items.array[i]->source->context.data;
+		struct scene_source_index *entry;
+
+		pthread_rwlock_rdlock(&group->index_lock);
+		HASH_FIND(hh_name, group->index_by_name, name, strlen(name), entry);
+		pthread_rwlock_unlock(&group->index_lock);
+
+		found = entry != NULL;
+	}
+	pthread_rwlock_unlock(&scene->index_lock);
+
+	return found;
+}
+
 obs_sceneitem_t *obs_scene_find_source_recursive(obs_scene_t *scene, const char *name)
 {
 	struct obs_scene_item *item;
 
-	if (!scene)
+	if (!scene || !name)
 		return NULL;
 
+	if (!groups_contain_source(scene, name))
+		return obs_scene_find_source(scene, name);
+
+	/* a group contains the source, so return whichever comes first in
+	 * the item list */
 	full_lock(scene);
 
 	item = scene->first_item;
@@ -2142,7 +2320,24 @@ bool check_sceneitem_exists(obs_scene_t *scene, obs_sceneitem_t *item, void *vp_
 obs_sceneitem_t *obs_scene_sceneitem_from_source(obs_scene_t *scene, obs_source_t *source)
 {
 	struct sceneitem_check check = {source, NULL};
-	obs_scene_enum_items(scene, check_sceneitem_exists, (void *)&check);
+	struct scene_source_index *entry;
+	bool multiple;
+
+	if (!scene || !source)
+		return NULL;
+
+	pthread_rwlock_rdlock(&scene->index_lock);
+	HASH_FIND_UUID(scene->index_by_uuid, source->context.uuid, entry);
+	check.item_out = find_indexed_item(entry, &multiple);
+	if (check.item_out && !multiple)
+		obs_sceneitem_addref(check.item_out);
+	pthread_rwlock_unlock(&scene->index_lock);
+
+	if (multiple) {
+		check.item_out = NULL;
+		obs_scene_enum_items(scene, check_sceneitem_exists, (void *)&check);
+	}
+
 	return check.item_out;
 }
 
@@ -2304,6 +2499,10 @@ static void sceneitem_renamed(void *param, calldata_t *data)
 {
 	obs_sceneitem_t *scene_item = param;
 	const char *name = calldata_string(data, "new_name");
+	obs_scene_t *scene = scene_item->parent;
+
+	if (scene)
+		scene_index_rename(scene, scene_item->source);
 
 	sceneitem_rename_hotkey(scene_item, name);
 }
@@ -2320,7 +2519,7 @@ static obs_sceneitem_t *obs_scene_add_internal(obs_scene_t *scene, obs_source_t
 	struct obs_scene_item *item;
 	pthread_mutex_t mutex;
 
-	struct item_action action = {.visible = true, .timestamp = os_gettime_ns()};
+	struct item_action action = {.visible = true, .timestamp = obs_get_time_ns()};
 
 	if (!scene)
 		return NULL;
@@ -2401,6 +2600,8 @@ static obs_sceneitem_t *obs_scene_add_internal(obs_scene_t *scene, obs_source_t
 		}
 	}
 
+	scene_index_add(scene, item);
+
 	full_unlock(scene);
 
 	if (!scene->source->context.private)
@@ -3092,7 +3293,7 @@ bool obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible)
 {
 	struct calldata cd;
 	uint8_t stack[256];
-	struct item_action action = {.visible = visible, .timestamp = os_gettime_ns()};
+	struct item_action action = {.visible = visible, .timestamp = obs_get_time_ns()};
 
 	if (!item)
 		return false;
@@ -3652,7 +3853,7 @@ obs_sceneitem_t *obs_scene_insert_group(obs_scene_t *scene, const char *name, ob
 		} else {
 			items[idx]->next = NULL;
 		}
-		items[idx]->parent = sub_scene;
+		set_sceneitem_parent(items[idx], sub_scene);
 		apply_group_transform(items[idx], item);
 	}
 	items[0]->prev = NULL;
@@ -3986,7 +4187,7 @@ bool obs_scene_reorder_items2(obs_scene_t *scene, struct obs_sceneitem_order_inf
 
 				sub_item->prev = sub_prev;
 				sub_item->next = NULL;
-				sub_item->parent = sub_scene;
+				set_sceneitem_parent(sub_item, sub_scene);
 
 				if (sub_prev)
 					sub_prev->next = sub_item;
@@ -4007,7 +4208,7 @@ bool obs_scene_reorder_items2(obs_scene_t *scene, struct obs_sceneitem_order_inf
 
 		item->prev = prev;
 		item->next = NULL;
-		item->parent = scene;
+		set_sceneitem_parent(item, scene);
 
 		if (prev)
 			prev->next = item;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "obs.h"
+#include "util/uthash.h"
 #include "graphics/matrix4.h"
 
 /* how obs scene! */
@@ -105,6 +106,18 @@ struct scene_source_mix {
 	float buf[AUDIO_OUTPUT_FRAMES];
 };
 
+/* one entry per distinct source used by a scene's items, indexed by both
+ * source name and UUID so that lookups don't have to walk the item list */
+struct scene_source_index {
+	struct obs_source *source;
+	char *name;
+	const char *uuid;
+	DARRAY(struct obs_scene_item *) items;
+
+	UT_hash_handle hh_name;
+	UT_hash_handle hh_uuid;
+};
+
 struct obs_scene {
 	struct obs_source *source;
 
@@ -123,5 +136,11 @@ struct obs_scene {
 	pthread_mutex_t audio_mutex;
 	struct obs_scene_item *first_item;
 
+	/* guards the index only, never held while taking the scene mutexes */
+	pthread_rwlock_t index_lock;
+	struct scene_source_index *index_by_name;
+	struct scene_source_index *index_by_uuid;
+	DARRAY(struct obs_scene_item *) group_items;
+
 	DARRAY(struct scene_source_mix) mix_sources;
 };
@@ -455,6 +455,8 @@ void obs_source_set_deinterlace_mode(obs_source_t *source, enum obs_deinterlace_
 		source->deinterlace_effect = get_effect(mode);
 		obs_leave_graphics();
 	}
+
+	obs_source_mark_modified(source);
 }
 
 enum obs_deinterlace_mode obs_source_get_deinterlace_mode(const obs_source_t *source)
@@ -469,6 +471,7 @@ void obs_source_set_deinterlace_field_order(obs_source_t *source, enum obs_deint
 		return;
 
 	source->deinterlace_top_first = field_order == OBS_DEINTERLACE_FIELD_ORDER_TOP;
+	obs_source_mark_modified(source);
 }
 
 enum obs_deinterlace_field_order obs_source_get_deinterlace_field_order(const obs_source_t *source)
@@ -355,7 +355,7 @@ bool obs_transition_start(obs_source_t *transition, enum obs_transition_mode mod
 		duration_ms = transition->transition_fixed_duration;
 
 	if (!active || (!same_as_dest && !same_as_source)) {
-		transition->transition_start_time = os_gettime_ns();
+		transition->transition_start_time = obs_get_time_ns();
 		transition->transition_duration = (uint64_t)duration_ms * 1000000ULL;
 	}
 
@@ -866,7 +866,7 @@ static void process_audio(obs_source_t *transition, obs_source_t *child, struct
 	obs_source_get_audio_mix(child, &child_audio);
 	pos = (size_t)ns_to_audio_frames(sample_rate, ts - min_ts);
 
-	if (pos > AUDIO_OUTPUT_FRAMES)
+	if (pos > obs->audio.output_frames)
 		return;
 
 	for (size_t mix_idx = 0; mix_idx < MAX_AUDIO_MIXES; mix_idx++) {
@@ -880,7 +880,7 @@ static void process_audio(obs_source_t *transition, obs_source_t *child, struct
 			float *out = output->data[ch];
 			float *in = input->data[ch];
 
-			mix_child(transition, out + pos, in, AUDIO_OUTPUT_FRAMES - pos, sample_rate, ts, mix);
+			mix_child(transition, out + pos, in, obs->audio.output_frames - pos, sample_rate, ts, mix);
 		}
 	}
 }
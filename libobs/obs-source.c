@@ -268,7 +268,7 @@ static bool obs_source_hotkey_unmute(void *data, obs_hotkey_pair_id id, obs_hotk
 
 static void obs_source_hotkey_push_to_mute(void *data, obs_hotkey_id id, obs_hotkey_t *key, bool pressed)
 {
-	struct audio_action action = {.timestamp = os_gettime_ns(), .type = AUDIO_ACTION_PTM, .set = pressed};
+	struct audio_action action = {.timestamp = obs_get_time_ns(), .type = AUDIO_ACTION_PTM, .set = pressed};
 
 	UNUSED_PARAMETER(id);
 	UNUSED_PARAMETER(key);
@@ -284,7 +284,7 @@ static void obs_source_hotkey_push_to_mute(void *data, obs_hotkey_id id, obs_hot
 
 static void obs_source_hotkey_push_to_talk(void *data, obs_hotkey_id id, obs_hotkey_t *key, bool pressed)
 {
-	struct audio_action action = {.timestamp = os_gettime_ns(), .type = AUDIO_ACTION_PTT, .set = pressed};
+	struct audio_action action = {.timestamp = obs_get_time_ns(), .type = AUDIO_ACTION_PTT, .set = pressed};
 
 	UNUSED_PARAMETER(id);
 	UNUSED_PARAMETER(key);
@@ -318,9 +318,11 @@ static void obs_source_init_audio_hotkeys(struct obs_source *source)
 							      obs_source_hotkey_push_to_talk, source);
 }
 
-static obs_source_t *obs_source_create_internal(const char *id, const char *name, const char *uuid,
-						obs_data_t *settings, obs_data_t *hotkey_data, bool private,
-						uint32_t last_obs_ver)
+/* creates everything except the source type's own data, which is left to
+ * obs_source_create_data so that it can be deferred */
+static obs_source_t *obs_source_create_begin(const char *id, const char *name, const char *uuid,
+					     obs_data_t *settings, obs_data_t *hotkey_data, bool private,
+					     uint32_t last_obs_ver)
 {
 	struct obs_source *source = bzalloc(sizeof(struct obs_source));
 
@@ -365,29 +367,109 @@ static obs_source_t *obs_source_create_internal(const char *id, const char *name
 	if (!private)
 		obs_source_init_audio_hotkeys(source);
 
+	return source;
+
+fail:
+	blog(LOG_ERROR, "obs_source_create failed");
+	obs_source_destroy(source);
+	return NULL;
+}
+
+void obs_source_create_data(obs_source_t *source)
+{
+	const struct obs_source_info *info = &source->info;
+	const char *name = source->context.name;
+
 	/* allow the source to be created even if creation fails so that the
 	 * user's data doesn't become lost */
-	if (info && info->create)
+	if (info->create)
 		source->context.data = info->create(source->context.settings, source);
-	if ((!info || info->create) && !source->context.data)
+	if ((source->owns_info_id || info->create) && !source->context.data)
 		blog(LOG_ERROR, "Failed to create source '%s'!", name);
 
-	blog(LOG_DEBUG, "%ssource '%s' (%s) created", private ? "private " : "", name, id);
+	blog(LOG_DEBUG, "%ssource '%s' (%s) created", source->context.private ? "private " : "", name, info->id);
+}
+
+/* creates and loads a source loaded lazily on the calling thread, unless
+ * another thread already started to */
+static void create_pending(obs_source_t *source)
+{
+	uint64_t start;
+
+	if (os_atomic_set_bool(&source->create_started, true))
+		return;
+
+	start = os_gettime_ns();
+
+	obs_source_create_data(source);
+	os_atomic_set_bool(&source->create_pending, false);
+	obs_source_load2(source);
+	os_event_signal(source->created_event);
+
+	blog(LOG_DEBUG, "source '%s' (%s) created on first use in %.1f ms", source->context.name, source->info.id,
+	     (double)(os_gettime_ns() - start) / 1000000.0);
+}
+
+static void create_pending_task(void *param)
+{
+	obs_source_t *source = param;
+
+	/* the modules are about to be unloaded */
+	if (!os_atomic_load_bool(&obs->data.lazy_create_stopped))
+		create_pending(source);
+
+	obs_source_release(source);
+}
+
+void obs_source_queue_create(obs_source_t *source)
+{
+	obs_source_t *ref;
+
+	if (!os_atomic_load_bool(&source->create_pending))
+		return;
+	if (os_atomic_load_bool(&obs->data.lazy_create_stopped))
+		return;
+	if (os_atomic_set_bool(&source->create_queued, true))
+		return;
+
+	ref = obs_source_get_ref(source);
+	if (ref)
+		os_task_queue_queue_task(obs->data.lazy_create_queue, create_pending_task, ref);
+}
+
+/* a source that's needed right away is created on the calling thread rather
+ * than waiting behind every other source on the lazy creation queue */
+static void wait_created(obs_source_t *source)
+{
+	if (!source->created_event)
+		return;
+
+	create_pending(source);
+	os_event_wait(source->created_event);
+}
 
+void obs_source_create_end(obs_source_t *source)
+{
 	source->flags = source->default_flags;
 	source->enabled = true;
 
 	obs_source_init_finalize(source);
-	if (!private) {
+	if (!source->context.private) {
 		obs_source_dosignal(source, "source_create", NULL);
 	}
+}
 
-	return source;
+static obs_source_t *obs_source_create_internal(const char *id, const char *name, const char *uuid,
+						obs_data_t *settings, obs_data_t *hotkey_data, bool private,
+						uint32_t last_obs_ver)
+{
+	obs_source_t *source = obs_source_create_begin(id, name, uuid, settings, hotkey_data, private, last_obs_ver);
+	if (!source)
+		return NULL;
 
-fail:
-	blog(LOG_ERROR, "obs_source_create failed");
-	obs_source_destroy(source);
-	return NULL;
+	obs_source_create_data(source);
+	obs_source_create_end(source);
+	return source;
 }
 
 obs_source_t *obs_source_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *hotkey_data)
@@ -406,6 +488,12 @@ obs_source_t *obs_source_create_set_last_ver(const char *id, const char *name, c
 	return obs_source_create_internal(id, name, uuid, settings, hotkey_data, is_private, last_obs_ver);
 }
 
+obs_source_t *obs_source_create_deferred(const char *id, const char *name, const char *uuid, obs_data_t *settings,
+					 obs_data_t *hotkey_data, uint32_t last_obs_ver, bool is_private)
+{
+	return obs_source_create_begin(id, name, uuid, settings, hotkey_data, is_private, last_obs_ver);
+}
+
 static char *get_new_filter_name(obs_source_t *dst, const char *name)
 {
 	struct dstr new_name = {0};
@@ -606,6 +694,9 @@ void obs_source_destroy(struct obs_source *source)
 	}
 	pthread_mutex_unlock(&obs->data.audio_sources_mutex);
 
+	if (obs->audio.clock_source == source)
+		obs_set_audio_clock_source(NULL);
+
 	if (source->filter_parent)
 		obs_source_filter_remove_refless(source->filter_parent, source);
 
@@ -693,6 +784,7 @@ static void obs_source_destroy_defer(struct obs_source *source)
 	pthread_mutex_destroy(&source->media_actions_mutex);
 	obs_data_release(source->private_settings);
 	obs_context_data_free(&source->context);
+	os_event_destroy(source->created_event);
 
 	if (source->owns_info_id) {
 		bfree((void *)source->info.id);
@@ -879,6 +971,13 @@ bool obs_source_configurable(const obs_source_t *source)
 
 obs_properties_t *obs_source_properties(const obs_source_t *source)
 {
+	if (!obs_source_valid(source, "obs_source_properties"))
+		return NULL;
+
+	/* properties need the source's data, so wait for a source loaded
+	 * lazily to be created */
+	wait_created((obs_source_t *)source);
+
 	if (!data_valid(source, "obs_source_properties"))
 		return NULL;
 
@@ -928,6 +1027,8 @@ void obs_source_update(obs_source_t *source, obs_data_t *settings)
 		obs_data_apply(source->context.settings, settings);
 	}
 
+	obs_source_mark_modified(source);
+
 	if (source->info.output_flags & OBS_SOURCE_VIDEO) {
 		os_atomic_inc_long(&source->defer_update_count);
 	} else if (source->context.data && source->info.update) {
@@ -1054,6 +1155,7 @@ static void hide_source(obs_source_t *source)
 
 static void activate_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
+	obs_source_queue_create(child);
 	os_atomic_inc_long(&child->activate_refs);
 
 	UNUSED_PARAMETER(parent);
@@ -1070,6 +1172,7 @@ static void deactivate_tree(obs_source_t *parent, obs_source_t *child, void *par
 
 static void show_tree(obs_source_t *parent, obs_source_t *child, void *param)
 {
+	obs_source_queue_create(child);
 	os_atomic_inc_long(&child->show_refs);
 
 	UNUSED_PARAMETER(parent);
@@ -1089,6 +1192,8 @@ void obs_source_activate(obs_source_t *source, enum view_type type)
 	if (!obs_source_valid(source, "obs_source_activate"))
 		return;
 
+	obs_source_queue_create(source);
+
 	os_atomic_inc_long(&source->show_refs);
 	obs_source_enum_active_tree(source, show_tree, NULL);
 
@@ -1217,6 +1322,10 @@ void obs_source_video_tick(obs_source_t *source, float seconds)
 	if (!obs_source_valid(source, "obs_source_video_tick"))
 		return;
 
+	/* show/activate are called once the source has been created */
+	if (os_atomic_load_bool(&source->create_pending))
+		return;
+
 	if (source->info.type == OBS_SOURCE_TYPE_TRANSITION)
 		obs_transition_tick(source, seconds);
 
@@ -1307,6 +1416,54 @@ static inline size_t conv_time_to_frames(const size_t sample_rate, const uint64_
  * possible */
 #define TS_SMOOTHING_THRESHOLD 70000000ULL
 
+/* only compared against, the source may be destroyed once the mutex is
+ * released */
+static inline const obs_source_t *get_audio_clock_source(void)
+{
+	const obs_source_t *source;
+
+	pthread_mutex_lock(&obs->audio.clock_mutex);
+	source = obs->audio.clock_source;
+	pthread_mutex_unlock(&obs->audio.clock_mutex);
+
+	return source;
+}
+
+/* audio runs at the rate of the audio clock, which can differ from the
+ * system clock, see obs_set_audio_clock_source */
+static inline uint64_t audio_clock_frames_to_time(const size_t sample_rate, const size_t frames)
+{
+	uint64_t duration = conv_frames_to_time(sample_rate, frames);
+
+	if (get_audio_clock_source())
+		duration = (uint64_t)((double)duration / audio_output_get_clock_ratio(obs->audio.audio) + 0.5);
+	return duration;
+}
+
+/* sources that don't run on the audio clock are resampled to follow it: a
+ * PI controller steers the resampling so that the timestamps of the audio
+ * stay in line with how much audio the source produced.  the error is low
+ * pass filtered first so jitter in when the audio arrives is ignored */
+#define CLOCK_COMP_KP 0.1
+#define CLOCK_COMP_KI 0.0025
+#define CLOCK_COMP_FILTER_SEC 1.0
+#define CLOCK_COMP_MAX 0.005
+
+static inline double clamp_compensation(double val)
+{
+	return val < -CLOCK_COMP_MAX ? -CLOCK_COMP_MAX : (val > CLOCK_COMP_MAX ? CLOCK_COMP_MAX : val);
+}
+
+static void update_clock_compensation(obs_source_t *source, int64_t error_ns, uint64_t duration_ns)
+{
+	double dt = (double)duration_ns / 1000000000.0;
+	double error = (double)error_ns / 1000000000.0;
+
+	source->clock_error += (error - source->clock_error) * dt / (CLOCK_COMP_FILTER_SEC + dt);
+	source->clock_drift = clamp_compensation(source->clock_drift + CLOCK_COMP_KI * source->clock_error * dt);
+	source->clock_ratio = 1.0 + clamp_compensation(source->clock_drift + CLOCK_COMP_KP * source->clock_error);
+}
+
 static inline void reset_audio_timing(obs_source_t *source, uint64_t timestamp, uint64_t os_time)
 {
 	source->timing_set = true;
@@ -1430,7 +1587,7 @@ static void source_output_audio_data(obs_source_t *source, const struct audio_da
 	size_t sample_rate = audio_output_get_sample_rate(obs->audio.audio);
 	struct audio_data in = *data;
 	uint64_t diff;
-	uint64_t os_time = os_gettime_ns();
+	uint64_t os_time = obs_get_time_ns();
 	int64_t sync_offset;
 	bool using_direct_ts = false;
 	bool push_back = false;
@@ -1455,6 +1612,9 @@ static void source_output_audio_data(obs_source_t *source, const struct audio_da
 		else if (diff < TS_SMOOTHING_THRESHOLD) {
 			if (source->async_unbuffered && source->async_decoupled)
 				source->timing_adjust = os_time - in.timestamp;
+			if (source->clock_compensated)
+				update_clock_compensation(source, (int64_t)(in.timestamp - source->next_audio_ts_min),
+							  conv_frames_to_time(sample_rate, in.frames));
 			in.timestamp = source->next_audio_ts_min;
 		} else {
 			blog(LOG_DEBUG,
@@ -1464,7 +1624,7 @@ static void source_output_audio_data(obs_source_t *source, const struct audio_da
 		}
 	}
 
-	source->next_audio_ts_min = in.timestamp + conv_frames_to_time(sample_rate, in.frames);
+	source->next_audio_ts_min = in.timestamp + audio_clock_frames_to_time(sample_rate, in.frames);
 
 	in.timestamp += source->timing_adjust;
 
@@ -2964,6 +3124,8 @@ void obs_source_filter_add(obs_source_t *source, obs_source_t *filter)
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_mark_modified(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3001,6 +3163,8 @@ static bool obs_source_filter_remove_refless(obs_source_t *source, obs_source_t
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_mark_modified(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3126,8 +3290,10 @@ void obs_source_filter_set_order(obs_source_t *source, obs_source_t *filter, enu
 	success = move_filter_dir(source, filter, movement);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_mark_modified(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 int obs_source_filter_get_index(obs_source_t *source, obs_source_t *filter)
@@ -3171,8 +3337,10 @@ void obs_source_filter_set_index(obs_source_t *source, obs_source_t *filter, siz
 	success = set_filter_index(source, filter, index);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_mark_modified(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 obs_data_t *obs_source_get_settings(const obs_source_t *source)
@@ -3642,7 +3810,7 @@ void obs_source_show_preloaded_video(obs_source_t *source)
 	obs_leave_graphics();
 
 	pthread_mutex_lock(&source->audio_buf_mutex);
-	sys_ts = (source->monitoring_type != OBS_MONITORING_TYPE_MONITOR_ONLY) ? os_gettime_ns() : 0;
+	sys_ts = (source->monitoring_type != OBS_MONITORING_TYPE_MONITOR_ONLY) ? obs_get_time_ns() : 0;
 	reset_audio_timing(source, source->last_frame_ts, sys_ts);
 	reset_audio_data(source, sys_ts);
 	pthread_mutex_unlock(&source->audio_buf_mutex);
@@ -3758,8 +3926,13 @@ static inline void reset_resampler(obs_source_t *source, const struct obs_source
 	source->resampler = NULL;
 	source->resample_offset = 0;
 
+	source->clock_ratio = 1.0;
+	source->clock_drift = 0.0;
+	source->clock_error = 0.0;
+
 	if (source->sample_info.samples_per_sec == obs_info->samples_per_sec &&
-	    source->sample_info.format == obs_info->format && source->sample_info.speakers == obs_info->speakers) {
+	    source->sample_info.format == obs_info->format && source->sample_info.speakers == obs_info->speakers &&
+	    !source->clock_compensated) {
 		source->audio_failed = false;
 		return;
 	}
@@ -3845,15 +4018,44 @@ static void process_audio_balancing(struct obs_source *source, uint32_t frames,
 	}
 }
 
+/* counts the audio of the source that the audio clock follows */
+static void update_audio_clock(obs_source_t *source, const struct obs_source_audio *audio)
+{
+	struct obs_core_audio *core = &obs->audio;
+
+	pthread_mutex_lock(&core->clock_mutex);
+	if (core->clock_source == source) {
+		if (core->clock_rate != audio->samples_per_sec) {
+			if (core->clock_rate)
+				core->clock_base += audio_frames_to_ns(core->clock_rate, core->clock_frames);
+			core->clock_frames = 0;
+			core->clock_rate = audio->samples_per_sec;
+		}
+
+		core->clock_frames += audio->frames;
+		core->clock_ts = os_gettime_ns();
+	}
+	pthread_mutex_unlock(&core->clock_mutex);
+}
+
 /* resamples/remixes new audio to the designated main audio output format */
 static void process_audio(obs_source_t *source, const struct obs_source_audio *audio)
 {
 	uint32_t frames = audio->frames;
 	bool mono_output;
 
+	const obs_source_t *clock_source = get_audio_clock_source();
+	bool compensate = clock_source && clock_source != source;
+
+	if (clock_source == source)
+		update_audio_clock(source, audio);
+
 	if (source->sample_info.samples_per_sec != audio->samples_per_sec ||
-	    source->sample_info.format != audio->format || source->sample_info.speakers != audio->speakers)
+	    source->sample_info.format != audio->format || source->sample_info.speakers != audio->speakers ||
+	    source->clock_compensated != compensate) {
+		source->clock_compensated = compensate;
 		reset_resampler(source, audio);
+	}
 
 	if (source->audio_failed)
 		return;
@@ -3863,6 +4065,9 @@ static void process_audio(obs_source_t *source, const struct obs_source_audio *a
 
 		memset(output, 0, sizeof(output));
 
+		if (source->clock_compensated)
+			audio_resampler_set_compensation(source->resampler, source->clock_ratio);
+
 		audio_resampler_resample(source->resampler, output, &frames, &source->resample_offset, audio->data,
 					 audio->frames);
 
@@ -4117,6 +4322,8 @@ void obs_source_set_name(obs_source_t *source, const char *name)
 			obs_context_data_setname(&source->context, name);
 		}
 
+		obs_source_mark_modified(source);
+
 		calldata_init(&data);
 		calldata_set_ptr(&data, "source", source);
 		calldata_set_string(&data, "new_name", source->context.name);
@@ -4367,7 +4574,7 @@ proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source)
 void obs_source_set_volume(obs_source_t *source, float volume)
 {
 	if (obs_source_valid(source, "obs_source_set_volume")) {
-		struct audio_action action = {.timestamp = os_gettime_ns(), .type = AUDIO_ACTION_VOL, .vol = volume};
+		struct audio_action action = {.timestamp = obs_get_time_ns(), .type = AUDIO_ACTION_VOL, .vol = volume};
 
 		struct calldata data;
 		uint8_t stack[128];
@@ -4387,6 +4594,7 @@ void obs_source_set_volume(obs_source_t *source, float volume)
 		pthread_mutex_unlock(&source->audio_actions_mutex);
 
 		source->user_volume = volume;
+		obs_source_mark_modified(source);
 	}
 }
 
@@ -4408,6 +4616,7 @@ void obs_source_set_sync_offset(obs_source_t *source, int64_t offset)
 		signal_handler_signal(source->context.signals, "audio_sync", &data);
 
 		source->sync_offset = calldata_int(&data, "offset");
+		obs_source_mark_modified(source);
 	}
 }
 
@@ -4648,6 +4857,7 @@ void obs_source_set_flags(obs_source_t *source, uint32_t flags)
 
 	if (flags != source->flags) {
 		source->flags = flags;
+		obs_source_mark_modified(source);
 		signal_flags_updated(source);
 	}
 }
@@ -4687,6 +4897,7 @@ void obs_source_set_audio_mixers(obs_source_t *source, uint32_t mixers)
 	mixers = (uint32_t)calldata_int(&data, "mixers");
 
 	source->audio_mixers = mixers;
+	obs_source_mark_modified(source);
 }
 
 uint32_t obs_source_get_audio_mixers(const obs_source_t *source)
@@ -4866,6 +5077,7 @@ void obs_source_set_enabled(obs_source_t *source, bool enabled)
 		return;
 
 	source->enabled = enabled;
+	obs_source_mark_modified(source);
 
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
@@ -4883,12 +5095,13 @@ void obs_source_set_muted(obs_source_t *source, bool muted)
 {
 	struct calldata data;
 	uint8_t stack[128];
-	struct audio_action action = {.timestamp = os_gettime_ns(), .type = AUDIO_ACTION_MUTE, .set = muted};
+	struct audio_action action = {.timestamp = obs_get_time_ns(), .type = AUDIO_ACTION_MUTE, .set = muted};
 
 	if (!obs_source_valid(source, "obs_source_set_muted"))
 		return;
 
 	source->user_muted = muted;
+	obs_source_mark_modified(source);
 
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
@@ -4950,6 +5163,7 @@ void obs_source_enable_push_to_mute(obs_source_t *source, bool enabled)
 		     enabled ? "enabled" : "disabled");
 
 	source->push_to_mute_enabled = enabled;
+	obs_source_mark_modified(source);
 
 	if (changed)
 		source_signal_push_to_changed(source, "push_to_mute_changed", enabled);
@@ -4976,6 +5190,7 @@ void obs_source_set_push_to_mute_delay(obs_source_t *source, uint64_t delay)
 
 	pthread_mutex_lock(&source->audio_mutex);
 	source->push_to_mute_delay = delay;
+	obs_source_mark_modified(source);
 
 	source_signal_push_to_delay(source, "push_to_mute_delay", delay);
 	pthread_mutex_unlock(&source->audio_mutex);
@@ -5006,6 +5221,7 @@ void obs_source_enable_push_to_talk(obs_source_t *source, bool enabled)
 		     enabled ? "enabled" : "disabled");
 
 	source->push_to_talk_enabled = enabled;
+	obs_source_mark_modified(source);
 
 	if (changed)
 		source_signal_push_to_changed(source, "push_to_talk_changed", enabled);
@@ -5032,6 +5248,7 @@ void obs_source_set_push_to_talk_delay(obs_source_t *source, uint64_t delay)
 
 	pthread_mutex_lock(&source->audio_mutex);
 	source->push_to_talk_delay = delay;
+	obs_source_mark_modified(source);
 
 	source_signal_push_to_delay(source, "push_to_talk_delay", delay);
 	pthread_mutex_unlock(&source->audio_mutex);
@@ -5066,18 +5283,20 @@ static float get_source_volume(obs_source_t *source, uint64_t os_time)
 
 static inline void multiply_output_audio(obs_source_t *source, size_t mix, size_t channels, float vol)
 {
-	register float *out = source->audio_output_buf[mix][0];
-	register float *end = out + AUDIO_OUTPUT_FRAMES * channels;
+	for (size_t ch = 0; ch < channels; ch++) {
+		register float *out = source->audio_output_buf[mix][ch];
+		register float *end = out + obs->audio.output_frames;
 
-	while (out < end)
-		*(out++) *= vol;
+		while (out < end)
+			*(out++) *= vol;
+	}
 }
 
 static inline void multiply_vol_data(obs_source_t *source, size_t mix, size_t channels, float *vol_data)
 {
 	for (size_t ch = 0; ch < channels; ch++) {
 		register float *out = source->audio_output_buf[mix][ch];
-		register float *end = out + AUDIO_OUTPUT_FRAMES;
+		register float *end = out + obs->audio.output_frames;
 		register float *vol = vol_data;
 
 		while (out < end)
@@ -5107,6 +5326,7 @@ static void apply_audio_actions(obs_source_t *source, size_t channels, size_t sa
 {
 	float vol_data[AUDIO_OUTPUT_FRAMES];
 	float cur_vol = get_source_volume(source, source->audio_ts);
+	size_t frames = obs->audio.output_frames;
 	size_t frame_num = 0;
 
 	pthread_mutex_lock(&source->audio_actions_mutex);
@@ -5121,7 +5341,7 @@ static void apply_audio_actions(obs_source_t *source, size_t channels, size_t sa
 
 		new_frame_num = conv_time_to_frames(sample_rate, timestamp - source->audio_ts);
 
-		if (new_frame_num >= AUDIO_OUTPUT_FRAMES)
+		if (new_frame_num >= frames)
 			break;
 
 		da_erase(source->audio_actions, i--);
@@ -5136,7 +5356,7 @@ static void apply_audio_actions(obs_source_t *source, size_t channels, size_t sa
 		cur_vol = get_source_volume(source, timestamp);
 	}
 
-	for (; frame_num < AUDIO_OUTPUT_FRAMES; frame_num++)
+	for (; frame_num < frames; frame_num++)
 		vol_data[frame_num] = cur_vol;
 
 	pthread_mutex_unlock(&source->audio_actions_mutex);
@@ -5162,7 +5382,7 @@ static void apply_audio_volume(obs_source_t *source, uint32_t mixers, size_t cha
 	pthread_mutex_unlock(&source->audio_actions_mutex);
 
 	if (actions_pending) {
-		uint64_t duration = conv_frames_to_time(sample_rate, AUDIO_OUTPUT_FRAMES);
+		uint64_t duration = conv_frames_to_time(sample_rate, obs->audio.output_frames);
 
 		if (action.timestamp < (source->audio_ts + duration)) {
 			apply_audio_actions(source, channels, sample_rate);
@@ -5246,7 +5466,7 @@ static void audio_submix(obs_source_t *source, size_t channels, size_t sample_ra
 		audio.data[i] = (const uint8_t *)audio_data.data[i];
 
 	audio.samples_per_sec = (uint32_t)sample_rate;
-	audio.frames = AUDIO_OUTPUT_FRAMES;
+	audio.frames = obs->audio.output_frames;
 	audio.format = AUDIO_FORMAT_FLOAT_PLANAR;
 	audio.speakers = (enum speaker_layout)channels;
 	audio.timestamp = ts;
@@ -5436,6 +5656,7 @@ void obs_source_set_monitoring_type(obs_source_t *source, enum obs_monitoring_ty
 	}
 
 	source->monitoring_type = type;
+	obs_source_mark_modified(source);
 }
 
 enum obs_monitoring_type obs_source_get_monitoring_type(const obs_source_t *source)
@@ -5519,6 +5740,7 @@ void obs_source_set_balance_value(obs_source_t *source, float balance)
 		signal_handler_signal(source->context.signals, "audio_balance", &data);
 
 		source->balance = (float)calldata_float(&data, "balance");
+		obs_source_mark_modified(source);
 	}
 }
 
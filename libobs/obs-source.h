@@ -203,6 +203,16 @@ enum obs_media_state {
  */
 #define OBS_SOURCE_CAP_DONT_SHOW_PROPERTIES (1 << 16)
 
+/**
+ * Source type's create callback is thread-safe.  When loading sources, create
+ * may then be called from a worker thread, in parallel with other sources.
+ * Scenes and transitions are always created serially.
+ *
+ * Inputs of these types are also the ones created lazily when lazy source
+ * creation is enabled (see obs_set_lazy_source_creation).
+ */
+#define OBS_SOURCE_CAP_PARALLEL_CREATE (1 << 17)
+
 /** @} */
 
 typedef void (*obs_source_enum_proc_t)(obs_source_t *parent, obs_source_t *child, void *param);
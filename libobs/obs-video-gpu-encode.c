@@ -120,6 +120,8 @@ static void *gpu_encode_thread(void *data)
 			if (video_pause_check(&encoder->pause, timestamp))
 				continue;
 
+			video_resync_check(encoder, timestamp);
+
 			if (encoder->reconfigure_requested) {
 				encoder->reconfigure_requested = false;
 				encoder->info.update(encoder->context.data, encoder->context.settings);
@@ -210,6 +212,7 @@ static void *gpu_encode_thread(void *data)
 		/* -------------- */
 
 		os_event_signal(video->gpu_encode_inactive);
+		os_event_signal(obs->video.gpu_encode_done);
 
 		for (size_t i = 0; i < encoders.num; i++)
 			obs_encoder_release(encoders.array[i]);
@@ -277,6 +280,7 @@ void stop_gpu_encoding_thread(struct obs_core_video_mix *video)
 		os_sem_post(video->gpu_encode_semaphore);
 		pthread_join(video->gpu_encode_thread, NULL);
 		video->gpu_encode_thread_initialized = false;
+		os_event_signal(obs->video.gpu_encode_done);
 	}
 }
 
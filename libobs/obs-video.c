@@ -802,62 +802,164 @@ void add_ready_encoder_group(obs_encoder_t *encoder)
 	pthread_mutex_unlock(&obs->video.encoder_group_mutex);
 }
 
-static inline void video_sleep(struct obs_core_video *video, uint64_t *p_time, uint64_t interval_ns)
+/* the next time the graphics thread has to wake up for, which is the next
+ * tick of whichever mix comes first */
+static uint64_t next_wake_time(void)
 {
-	struct obs_vframe_info vframe_info;
-	uint64_t cur_time = *p_time;
-	uint64_t t = cur_time + interval_ns;
-	int count;
+	uint64_t next = UINT64_MAX;
 
-	if (os_sleepto_ns(t)) {
-		*p_time = t;
-		count = 1;
-	} else {
-		const uint64_t udiff = os_gettime_ns() - cur_time;
-		int64_t diff;
-		memcpy(&diff, &udiff, sizeof(diff));
-		const uint64_t clamped_diff = (diff > (int64_t)interval_ns) ? (uint64_t)diff : interval_ns;
-		count = (int)(clamped_diff / interval_ns);
-		*p_time = cur_time + interval_ns * count;
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+		uint64_t t = mix->frame_pending ? mix->rendered_frame_ts + mix->frame_interval_ns : mix->next_frame_ts;
+
+		if (mix->view && t && t < next)
+			next = t;
 	}
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
 
-	video->total_frames += count;
-	video->lagged_frames += count - 1;
+	return next;
+}
 
-	vframe_info.timestamp = cur_time;
-	vframe_info.count = count;
+/* once the clock has passed the tick after a mix's last frame, that frame
+ * is output for every tick of the mix that has passed since, and the mix
+ * becomes due again.  returns the latest tick any mix is due at, or 0 */
+static uint64_t finish_mix_frames(struct obs_core_video *video, uint64_t now)
+{
+	uint64_t latest = 0;
 
-	pthread_mutex_lock(&video->encoder_group_mutex);
-	for (size_t i = 0; i < video->ready_encoder_groups.num; i++) {
-		obs_encoder_t *encoder = obs_weak_encoder_get_encoder(video->ready_encoder_groups.array[i]);
-		obs_weak_encoder_release(video->ready_encoder_groups.array[i]);
-		if (!encoder)
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+		struct obs_vframe_info vframe_info;
+
+		if (!mix->frame_pending || now < mix->rendered_frame_ts + mix->frame_interval_ns)
 			continue;
 
-		if (encoder->encoder_group) {
-			struct obs_encoder_group *group = encoder->encoder_group;
-			pthread_mutex_lock(&group->mutex);
-			if (group->num_encoders_started >= group->encoders.num && !group->start_timestamp)
-				group->start_timestamp = *p_time;
-			pthread_mutex_unlock(&group->mutex);
+		int count = (int)((now - mix->rendered_frame_ts) / mix->frame_interval_ns);
+
+		vframe_info.timestamp = mix->rendered_frame_ts;
+		vframe_info.count = count;
+
+		if (mix->raw_was_active)
+			deque_push_back(&mix->vframe_info_buffer, &vframe_info, sizeof(vframe_info));
+		if (mix->gpu_was_active)
+			deque_push_back(&mix->vframe_info_buffer_gpu, &vframe_info, sizeof(vframe_info));
+
+		os_atomic_set_long(&mix->total_frames, os_atomic_load_long(&mix->total_frames) + count);
+		os_atomic_set_long(&mix->lagged_frames, os_atomic_load_long(&mix->lagged_frames) + count - 1);
+
+		if (mix == obs->video.main_mix) {
+			video->total_frames += count;
+			video->lagged_frames += count - 1;
 		}
-		obs_encoder_release(encoder);
+
+		mix->next_frame_ts = mix->rendered_frame_ts + mix->frame_interval_ns * count;
+		mix->frame_pending = false;
+
+		if (mix->next_frame_ts > latest)
+			latest = mix->next_frame_ts;
 	}
-	da_clear(video->ready_encoder_groups);
-	pthread_mutex_unlock(&video->encoder_group_mutex);
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	return latest;
+}
+
+/* encoder groups start on the next frame of their mix, which is only known
+ * once the mix's last frame has been finished */
+static bool get_group_start_time(video_t *media, uint64_t *start_ts)
+{
+	bool found = false;
+	bool known = true;
 
 	pthread_mutex_lock(&obs->video.mixes_mutex);
 	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
-		struct obs_core_video_mix *video = obs->video.mixes.array[i];
-		bool raw_active = video->raw_was_active;
-		bool gpu_active = video->gpu_was_active;
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+		if (mix->video != media)
+			continue;
 
-		if (raw_active)
-			deque_push_back(&video->vframe_info_buffer, &vframe_info, sizeof(vframe_info));
-		if (gpu_active)
-			deque_push_back(&video->vframe_info_buffer_gpu, &vframe_info, sizeof(vframe_info));
+		found = true;
+		known = !mix->frame_pending;
+		if (known)
+			*start_ts = mix->next_frame_ts;
+		break;
 	}
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	return known || !found;
+}
+
+static const char *video_wake_error_name = "video_wake_error";
+
+static inline bool sleep_to_frame(struct obs_core_video *video, uint64_t t)
+{
+	uint64_t spin_ns = (uint64_t)os_atomic_load_long(&video->pacing_spin_us) * 1000;
+	bool slept = spin_ns ? os_sleepto_ns_spin(t, spin_ns) : os_sleepto_ns(t);
+
+	/* how late the thread woke up, as a histogram in the profiler */
+	if (slept) {
+		uint64_t now = os_gettime_ns();
+		profile_add_time(video_wake_error_name, now > t ? now - t : 0);
+	}
+
+	return slept;
+}
+
+static inline void video_sleep(struct obs_core_video *video, uint64_t *p_time, uint64_t interval_ns, bool offline)
+{
+	uint64_t cur_time = *p_time;
+	uint64_t t = next_wake_time();
+	uint64_t now;
+
+	if (t == UINT64_MAX)
+		t = cur_time + interval_ns;
+	else if (t < cur_time)
+		t = cur_time;
+
+	if (offline) {
+		/* the virtual clock just moves on to the next tick, once the
+		 * audio thread has caught up with it */
+		now = t;
+		audio_output_advance(obs->audio.audio, t);
+
+	} else if (sleep_to_frame(video, t)) {
+		now = t;
+	} else {
+		now = os_gettime_ns();
+		if (now < t)
+			now = t;
+	}
+
+	uint64_t latest = finish_mix_frames(video, now);
+	*p_time = latest ? latest : now;
+
+	pthread_mutex_lock(&video->encoder_group_mutex);
+	for (size_t i = 0; i < video->ready_encoder_groups.num; i++) {
+		obs_weak_encoder_t *weak = video->ready_encoder_groups.array[i];
+		obs_encoder_t *encoder = obs_weak_encoder_get_encoder(weak);
+		uint64_t start_ts = *p_time;
+
+		if (encoder) {
+			if (!get_group_start_time(encoder->media, &start_ts)) {
+				obs_encoder_release(encoder);
+				continue;
+			}
+
+			if (encoder->encoder_group) {
+				struct obs_encoder_group *group = encoder->encoder_group;
+				pthread_mutex_lock(&group->mutex);
+				if (group->num_encoders_started >= group->encoders.num && !group->start_timestamp)
+					group->start_timestamp = start_ts;
+				pthread_mutex_unlock(&group->mutex);
+			}
+			obs_encoder_release(encoder);
+		}
+
+		obs_weak_encoder_release(weak);
+		da_erase(video->ready_encoder_groups, i);
+		i--;
+	}
+	pthread_mutex_unlock(&video->encoder_group_mutex);
 }
 
 static const char *output_frame_gs_context_name = "gs_context(video->graphics)";
@@ -919,7 +1021,12 @@ static inline void output_frames(void)
 	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
 		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
 		if (mix->view) {
+			if (!mix->frame_due)
+				continue;
+
 			output_frame(mix);
+			mix->rendered_frame_ts = mix->next_frame_ts;
+			mix->frame_pending = true;
 		} else {
 			obs->video.mixes.array[i] = NULL;
 			obs_free_video_mix(mix);
@@ -1073,12 +1180,78 @@ static inline void update_active_state(struct obs_core_video_mix *video)
 	video->was_active = active;
 }
 
-static inline void update_active_states(void)
+static void rebase_mix_clocks(uint64_t old_time, uint64_t new_time)
 {
 	pthread_mutex_lock(&obs->video.mixes_mutex);
-	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++)
-		update_active_state(obs->video.mixes.array[i]);
+	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+
+		if (mix->rendered_frame_ts)
+			mix->rendered_frame_ts = mix->rendered_frame_ts - old_time + new_time;
+		if (mix->next_frame_ts)
+			mix->next_frame_ts = mix->next_frame_ts - old_time + new_time;
+	}
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+}
+
+/* mixes are due once the clock has reached their next tick, new mixes
+ * start right away.  returns whether the main mix is due */
+static bool update_due_mixes(uint64_t video_time)
+{
+	bool main_due = false;
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+
+		if (!mix->next_frame_ts)
+			mix->next_frame_ts = video_time;
+
+		mix->frame_due = !mix->frame_pending && mix->next_frame_ts <= video_time;
+		if (!mix->frame_due)
+			continue;
+
+		update_active_state(mix);
+		if (mix == obs->video.main_mix)
+			main_due = true;
+	}
+
+	if (!obs->video.main_mix)
+		main_due = true;
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	return main_due;
+}
+
+/* when rendering offline, texture encoders get every frame instead of the
+ * last one being repeated while they're behind */
+static bool gpu_encoders_ready(void)
+{
+	bool ready = true;
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0, num = obs->video.mixes.num; ready && i < num; i++) {
+		struct obs_core_video_mix *video = obs->video.mixes.array[i];
+		if (!video->gpu_was_active)
+			continue;
+
+		pthread_mutex_lock(&video->gpu_encoder_mutex);
+		ready = video->gpu_encoder_avail_queue.size || !video->gpu_encoder_queue.size ||
+			os_atomic_load_bool(&video->gpu_encode_stop);
+		pthread_mutex_unlock(&video->gpu_encoder_mutex);
+	}
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	return ready;
+}
+
+/* the mixes mutex isn't held while waiting, as starting and stopping
+ * encoders need it.  the event is auto reset and only checked after the
+ * queues, so a frame finished in between isn't missed. */
+static void wait_for_gpu_encoders(void)
+{
+	while (!gpu_encoders_ready())
+		os_event_wait(obs->video.gpu_encode_done);
 }
 
 static inline bool stop_requested(void)
@@ -1098,8 +1271,30 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 {
 	uint64_t frame_start = os_gettime_ns();
 	uint64_t frame_time_ns;
+	bool offline = os_atomic_load_bool(&obs->video.offline);
+
+	/* the frame rate can change while outputs are active, see
+	 * obs_reconfigure_video */
+	context->interval = obs->video.video_frame_interval_ns;
+
+	/* the virtual clock is ahead of the system clock by the time that was
+	 * rendered offline, so start over from the current time */
+	if (context->offline && !offline) {
+		rebase_mix_clocks(obs->video.video_time, frame_start);
+		obs->video.video_time = frame_start;
+		context->last_time = 0;
+	}
+	context->offline = offline;
+
+	bool realtime = os_atomic_load_bool(&obs->video.pacing_realtime);
+	if (context->realtime != realtime) {
+		if (!os_set_thread_realtime(realtime))
+			blog(LOG_WARNING, "Failed to %s realtime scheduling for the graphics thread",
+			     realtime ? "enable" : "disable");
+		context->realtime = realtime;
+	}
 
-	update_active_states();
+	bool main_due = update_due_mixes(obs->video.video_time);
 
 	profile_start(context->video_thread_name);
 	source_profiler_frame_begin();
@@ -1120,14 +1315,22 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 	}
 #endif
 
+	if (offline)
+		wait_for_gpu_encoders();
+
 	source_profiler_render_begin();
 	profile_start(output_frame_name);
 	output_frames();
 	profile_end(output_frame_name);
 
-	profile_start(render_displays_name);
-	render_displays();
-	profile_end(render_displays_name);
+	/* displays are drawn at the rate of the main mix, and there's no
+	 * point in drawing them more often than in real time */
+	if (main_due && (!offline || frame_start - context->last_display_time >= context->interval)) {
+		profile_start(render_displays_name);
+		render_displays();
+		profile_end(render_displays_name);
+		context->last_display_time = frame_start;
+	}
 	source_profiler_render_end();
 
 	execute_graphics_tasks();
@@ -1139,11 +1342,12 @@ bool obs_graphics_thread_loop(struct obs_graphics_context *context)
 
 	profile_reenable_thread();
 
-	video_sleep(&obs->video, &obs->video.video_time, context->interval);
+	video_sleep(&obs->video, &obs->video.video_time, context->interval, offline);
 
 	context->frame_time_total_ns += frame_time_ns;
 	context->fps_total_ns += (obs->video.video_time - context->last_time);
-	context->fps_total_frames++;
+	if (main_due)
+		context->fps_total_frames++;
 
 	if (context->fps_total_ns >= 1000000000ULL) {
 		obs->video.video_fps =
@@ -1186,6 +1390,9 @@ void *obs_graphics_thread(void *param)
 	context.fps_total_frames = 0;
 	context.last_time = 0;
 	context.video_thread_name = video_thread_name;
+	context.offline = false;
+	context.realtime = false;
+	context.last_display_time = 0;
 
 #ifdef __APPLE__
 	while (obs_graphics_thread_loop_autorelease(&context))
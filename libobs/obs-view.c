@@ -232,3 +232,33 @@ void obs_view_enum_video_info(obs_view_t *view, bool (*enum_proc)(void *, struct
 
 	pthread_mutex_unlock(&obs->video.mixes_mutex);
 }
+
+static uint32_t get_view_frames(obs_view_t *view, bool lagged)
+{
+	uint32_t frames = 0;
+
+	if (!view)
+		return 0;
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+
+	size_t idx = find_mix_for_view(view);
+	if (idx != DARRAY_INVALID) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[idx];
+		frames = (uint32_t)os_atomic_load_long(lagged ? &mix->lagged_frames : &mix->total_frames);
+	}
+
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	return frames;
+}
+
+uint32_t obs_view_get_total_frames(obs_view_t *view)
+{
+	return get_view_frames(view, false);
+}
+
+uint32_t obs_view_get_lagged_frames(obs_view_t *view)
+{
+	return get_view_frames(view, true);
+}
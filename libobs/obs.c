@@ -610,17 +610,7 @@ static int obs_init_video_mix(struct obs_video_info *ovi, struct obs_core_video_
 
 	make_video_info(&vi, ovi);
 	video->ovi = *ovi;
-
-	/* main view graphics thread drives all frame output,
-	 * so share FPS settings for aux views */
-	pthread_mutex_lock(&obs->video.mixes_mutex);
-	size_t num = obs->video.mixes.num;
-	if (num && obs->video.main_mix) {
-		struct obs_video_info main_ovi = obs->video.main_mix->ovi;
-		video->ovi.fps_num = main_ovi.fps_num;
-		video->ovi.fps_den = main_ovi.fps_den;
-	}
-	pthread_mutex_unlock(&obs->video.mixes_mutex);
+	video->frame_interval_ns = util_mul_div64(1000000000ULL, ovi->fps_den, ovi->fps_num);
 
 	video->gpu_conversion = ovi->gpu_conversion;
 	video->gpu_was_active = false;
@@ -640,6 +630,8 @@ static int obs_init_video_mix(struct obs_video_info *ovi, struct obs_core_video_
 		return OBS_VIDEO_FAIL;
 	}
 
+	video_output_set_offline(video->video, os_atomic_load_bool(&obs->video.offline));
+
 	if (pthread_mutex_init(&video->gpu_encoder_mutex, NULL) < 0)
 		return OBS_VIDEO_FAIL;
 
@@ -677,6 +669,8 @@ static int obs_init_video(struct obs_video_info *ovi)
 		return OBS_VIDEO_FAIL;
 	if (pthread_mutex_init(&video->mixes_mutex, NULL) < 0)
 		return OBS_VIDEO_FAIL;
+	if (os_event_init(&video->gpu_encode_done, OS_EVENT_TYPE_AUTO) != 0)
+		return OBS_VIDEO_FAIL;
 
 	if (!obs_view_add2(&obs->data.main_view, ovi))
 		return OBS_VIDEO_FAIL;
@@ -809,6 +803,9 @@ static void obs_free_video(void)
 	pthread_mutex_destroy(&obs->video.mixes_mutex);
 	pthread_mutex_init_value(&obs->video.mixes_mutex);
 
+	os_event_destroy(obs->video.gpu_encode_done);
+	obs->video.gpu_encode_done = NULL;
+
 	for (size_t i = 0; i < obs->video.ready_encoder_groups.num; i++) {
 		obs_weak_encoder_release(obs->video.ready_encoder_groups.array[i]);
 	}
@@ -865,6 +862,8 @@ static bool obs_init_audio(struct audio_output_info *ai)
 		return false;
 	if (pthread_mutex_init(&audio->task_mutex, NULL) != 0)
 		return false;
+	if (pthread_mutex_init(&audio->clock_mutex, NULL) != 0)
+		return false;
 
 	struct obs_task_info audio_init = {.task = set_audio_thread};
 	deque_push_back(&audio->tasks, &audio_init, sizeof(audio_init));
@@ -873,9 +872,10 @@ static bool obs_init_audio(struct audio_output_info *ai)
 	audio->monitoring_device_id = bstrdup("default");
 
 	errorcode = audio_output_open(&audio->audio, ai);
-	if (errorcode == AUDIO_OUTPUT_SUCCESS)
+	if (errorcode == AUDIO_OUTPUT_SUCCESS) {
+		audio_output_set_offline(audio->audio, os_atomic_load_bool(&obs->video.offline));
 		return true;
-	else if (errorcode == AUDIO_OUTPUT_INVALIDPARAM)
+	} else if (errorcode == AUDIO_OUTPUT_INVALIDPARAM)
 		blog(LOG_ERROR, "Invalid audio parameters specified");
 	else
 		blog(LOG_ERROR, "Could not open audio output");
@@ -909,6 +909,7 @@ static void obs_free_audio(void)
 	deque_free(&audio->tasks);
 	pthread_mutex_destroy(&audio->task_mutex);
 	pthread_mutex_destroy(&audio->monitoring_mutex);
+	pthread_mutex_destroy(&audio->clock_mutex);
 
 	memset(audio, 0, sizeof(struct obs_core_audio));
 }
@@ -940,6 +941,10 @@ static bool obs_init_data(void)
 	if (!obs_view_init(&data->main_view))
 		goto fail;
 
+	data->lazy_create_queue = os_task_queue_create();
+	if (!data->lazy_create_queue)
+		goto fail;
+
 	data->sources = NULL;
 	data->public_sources = NULL;
 	data->private_data = obs_data_create();
@@ -1164,6 +1169,7 @@ static bool obs_init(const char *locale, const char *module_config_path, profile
 
 	pthread_mutex_init_value(&obs->audio.monitoring_mutex);
 	pthread_mutex_init_value(&obs->audio.task_mutex);
+	pthread_mutex_init_value(&obs->audio.clock_mutex);
 	pthread_mutex_init_value(&obs->video.task_mutex);
 	pthread_mutex_init_value(&obs->video.encoder_group_mutex);
 	pthread_mutex_init_value(&obs->video.mixes_mutex);
@@ -1188,6 +1194,10 @@ static bool obs_init(const char *locale, const char *module_config_path, profile
 	if (!obs->destruction_task_thread)
 		return false;
 
+	obs->file_watcher = os_file_watcher_create();
+	if (!obs->file_watcher)
+		return false;
+
 	if (module_config_path)
 		obs->module_config_path = bstrdup(module_config_path);
 	obs->locale = bstrdup(locale);
@@ -1315,6 +1325,15 @@ void obs_shutdown(void)
 
 	obs_wait_for_destroy_queue();
 
+	/* sources still waiting to be created lazily are left uncreated, the
+	 * queue has to be drained before the modules are unloaded.  its tasks
+	 * hold references to their sources, so releasing them can queue more
+	 * destruction. */
+	os_atomic_set_bool(&obs->data.lazy_create_stopped, true);
+	os_task_queue_destroy(obs->data.lazy_create_queue);
+	obs->data.lazy_create_queue = NULL;
+	obs_wait_for_destroy_queue();
+
 	for (size_t i = 0; i < obs->source_types.num; i++) {
 		struct obs_source_info *item = &obs->source_types.array[i];
 		if (item->type_data && item->free_type_data)
@@ -1357,6 +1376,7 @@ void obs_shutdown(void)
 	obs->first_module = NULL;
 
 	obs_free_data();
+	os_file_watcher_destroy(obs->file_watcher);
 	obs_free_audio();
 	obs_free_video();
 	os_task_queue_destroy(obs->destruction_task_thread);
@@ -1506,6 +1526,216 @@ int obs_reset_video(struct obs_video_info *ovi)
 	return obs_init_video(ovi);
 }
 
+struct mix_switch {
+	struct obs_core_video_mix *old_mix;
+	struct obs_core_video_mix *new_mix;
+};
+
+static inline video_t *switch_target(const struct mix_switch *switches, size_t num, video_t *video)
+{
+	for (size_t i = 0; i < num; i++) {
+		if (switches[i].old_mix->video == video)
+			return switches[i].new_mix->video;
+	}
+
+	return NULL;
+}
+
+static void free_mix_switches(struct mix_switch *switches, size_t num, bool old)
+{
+	for (size_t i = 0; i < num; i++)
+		obs_free_video_mix(old ? switches[i].old_mix : switches[i].new_mix);
+}
+
+int obs_reconfigure_video(struct obs_video_info *ovi)
+{
+	DARRAY(struct mix_switch) switches;
+	DARRAY(obs_encoder_t *) encoders;
+	DARRAY(obs_output_t *) outputs;
+	DARRAY(bool) reconnect;
+	size_t failed = 0;
+
+	if (!obs)
+		return OBS_VIDEO_FAIL;
+
+	/* nothing to keep running, so just reset */
+	if (!obs->video.main_mix || !obs_video_active())
+		return obs_reset_video(ovi);
+
+	if (!size_valid(ovi->output_width, ovi->output_height) || !size_valid(ovi->base_width, ovi->base_height))
+		return OBS_VIDEO_INVALID_PARAM;
+	if (!ovi->fps_num || !ovi->fps_den)
+		return OBS_VIDEO_INVALID_PARAM;
+
+	ovi->output_width &= 0xFFFFFFFC;
+	ovi->output_height &= 0xFFFFFFFE;
+
+	uint64_t start_time = os_gettime_ns();
+
+	da_init(switches);
+	da_init(encoders);
+	da_init(outputs);
+	da_init(reconnect);
+
+	/* ------------------------------------------- */
+	/* build the replacement mixes while the current ones keep rendering */
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	struct obs_core_video_mix *main_mix = obs->video.main_mix;
+
+	for (size_t i = 0; i < obs->video.mixes.num; i++) {
+		struct obs_core_video_mix *mix = obs->video.mixes.array[i];
+		if (!mix->view || mix->view != main_mix->view)
+			continue;
+
+		struct mix_switch *sw = da_push_back_new(switches);
+		sw->old_mix = mix;
+	}
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	for (size_t i = 0; i < switches.num; i++) {
+		struct mix_switch *sw = switches.array + i;
+		struct obs_core_video_mix *old_mix = sw->old_mix;
+		struct obs_video_info mix_ovi;
+
+		/* encoder scaling mixes keep their own output settings */
+		if (old_mix == main_mix) {
+			mix_ovi = *ovi;
+		} else {
+			mix_ovi = old_mix->ovi;
+			mix_ovi.base_width = ovi->base_width;
+			mix_ovi.base_height = ovi->base_height;
+			mix_ovi.fps_num = ovi->fps_num;
+			mix_ovi.fps_den = ovi->fps_den;
+		}
+
+		sw->new_mix = obs_create_video_mix(&mix_ovi);
+		if (!sw->new_mix) {
+			blog(LOG_ERROR, "obs_reconfigure_video: Failed to create video mix");
+			free_mix_switches(switches.array, i, false);
+			da_free(switches);
+			return OBS_VIDEO_FAIL;
+		}
+
+		sw->new_mix->view = old_mix->view;
+		sw->new_mix->encoder_only_mix = old_mix->encoder_only_mix;
+		sw->new_mix->encoder_refs = old_mix->encoder_refs;
+	}
+
+	/* ------------------------------------------- */
+	/* find everything that's connected to the current mixes */
+
+	pthread_mutex_lock(&obs->data.encoders_mutex);
+	for (obs_encoder_t *encoder = obs->data.first_encoder; encoder;
+	     encoder = (obs_encoder_t *)encoder->context.next) {
+		if (encoder->info.type != OBS_ENCODER_VIDEO)
+			continue;
+		if (!switch_target(switches.array, switches.num, encoder->media))
+			continue;
+
+		obs_encoder_t *ref = obs_encoder_get_ref(encoder);
+		if (ref)
+			da_push_back(encoders, &ref);
+	}
+	pthread_mutex_unlock(&obs->data.encoders_mutex);
+
+	pthread_mutex_lock(&obs->data.outputs_mutex);
+	for (obs_output_t *output = obs->data.first_output; output; output = (obs_output_t *)output->context.next) {
+		if (!switch_target(switches.array, switches.num, output->video))
+			continue;
+
+		obs_output_t *ref = obs_output_get_ref(output);
+		if (ref)
+			da_push_back(outputs, &ref);
+	}
+	pthread_mutex_unlock(&obs->data.outputs_mutex);
+
+	/* ------------------------------------------- */
+	/* switch over, outputs don't get any frames from here on until their
+	 * encoders are connected to the new mixes */
+
+	uint64_t switch_start = os_gettime_ns();
+
+	for (size_t i = 0; i < encoders.num; i++)
+		obs_encoder_begin_video_switch(encoders.array[i]);
+
+	for (size_t i = 0; i < outputs.num; i++) {
+		bool connected = obs_output_begin_video_switch(outputs.array[i]);
+		da_push_back(reconnect, &connected);
+	}
+
+	/* anything left are raw video callbacks */
+	for (size_t i = 0; i < switches.num; i++) {
+		struct mix_switch *sw = switches.array + i;
+		long moved = (long)video_output_move_inputs(sw->old_mix->video, sw->new_mix->video);
+		os_atomic_set_long(&sw->new_mix->raw_active, moved);
+	}
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0; i < switches.num; i++) {
+		struct mix_switch *sw = switches.array + i;
+		size_t idx = da_find(obs->video.mixes, &sw->old_mix, 0);
+		if (idx != DARRAY_INVALID)
+			obs->video.mixes.array[idx] = sw->new_mix;
+		else
+			da_push_back(obs->video.mixes, &sw->new_mix);
+
+		if (sw->old_mix == obs->video.main_mix)
+			obs->video.main_mix = sw->new_mix;
+	}
+
+	obs->video.video_frame_interval_ns = util_mul_div64(1000000000ULL, ovi->fps_den, ovi->fps_num);
+	obs->video.video_half_frame_interval_ns = util_mul_div64(500000000ULL, ovi->fps_den, ovi->fps_num);
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	for (size_t i = 0; i < encoders.num; i++) {
+		obs_encoder_t *encoder = encoders.array[i];
+		video_t *video = switch_target(switches.array, switches.num, encoder->media);
+
+		if (!obs_encoder_end_video_switch(encoder, video))
+			failed++;
+	}
+
+	for (size_t i = 0; i < outputs.num; i++) {
+		obs_output_t *output = outputs.array[i];
+		video_t *video = switch_target(switches.array, switches.num, output->video);
+
+		obs_output_end_video_switch(output, video, reconnect.array[i]);
+	}
+
+	uint64_t switch_gap = os_gettime_ns() - switch_start;
+
+	/* ------------------------------------------- */
+	/* nothing refers to the old mixes anymore */
+
+	free_mix_switches(switches.array, switches.num, true);
+
+	for (size_t i = 0; i < encoders.num; i++)
+		obs_encoder_release(encoders.array[i]);
+	for (size_t i = 0; i < outputs.num; i++)
+		obs_output_release(outputs.array[i]);
+
+	blog(LOG_INFO, "---------------------------------");
+	blog(LOG_INFO,
+	     "video settings reconfigured:\n"
+	     "\tbase resolution:   %dx%d\n"
+	     "\toutput resolution: %dx%d\n"
+	     "\tfps:               %d/%d\n"
+	     "\tformat:            %s\n"
+	     "\tencoders switched: %zu (%zu failed)\n"
+	     "\tswitch gap:        %.2f ms (%.2f ms total)",
+	     ovi->base_width, ovi->base_height, ovi->output_width, ovi->output_height, ovi->fps_num, ovi->fps_den,
+	     get_video_format_name(ovi->output_format), encoders.num, failed, (double)switch_gap / 1000000.0,
+	     (double)(os_gettime_ns() - start_time) / 1000000.0);
+
+	da_free(switches);
+	da_free(encoders);
+	da_free(outputs);
+	da_free(reconnect);
+
+	return failed ? OBS_VIDEO_FAIL : OBS_VIDEO_SUCCESS;
+}
+
 #ifndef SEC_TO_MSEC
 #define SEC_TO_MSEC 1000
 #endif
@@ -1513,42 +1743,58 @@ int obs_reset_video(struct obs_video_info *ovi)
 bool obs_reset_audio2(const struct obs_audio_info2 *oai)
 {
 	struct obs_core_audio *audio = &obs->audio;
-	struct audio_output_info ai;
+	struct audio_output_info ai = {0};
 
 	/* don't allow changing of audio settings if active. */
 	if (!obs || (audio->audio && audio_output_active(audio->audio)))
 		return false;
 
+	/* the graphics thread drives the audio thread when rendering
+	 * offline, so the audio output can't go away under it */
+	if (os_atomic_load_bool(&obs->video.offline)) {
+		blog(LOG_WARNING, "Cannot reset audio while rendering offline");
+		return false;
+	}
+
 	obs_free_audio();
 	if (!oai)
 		return true;
 
+	uint32_t frames = oai->output_frames ? oai->output_frames : AUDIO_OUTPUT_FRAMES;
+	if (frames < MIN_AUDIO_OUTPUT_FRAMES || frames > AUDIO_OUTPUT_FRAMES) {
+		blog(LOG_WARNING, "Invalid audio block size %u, using %d", frames, AUDIO_OUTPUT_FRAMES);
+		frames = AUDIO_OUTPUT_FRAMES;
+	}
+	audio->output_frames = frames;
+
 	if (oai->max_buffering_ms) {
 		uint32_t max_frames = oai->max_buffering_ms * oai->samples_per_sec / SEC_TO_MSEC;
-		max_frames += (AUDIO_OUTPUT_FRAMES - 1);
-		audio->max_buffering_ticks = max_frames / AUDIO_OUTPUT_FRAMES;
+		max_frames += (frames - 1);
+		audio->max_buffering_ticks = max_frames / frames;
 	} else {
-		audio->max_buffering_ticks = 45;
+		/* same amount of time regardless of the block size */
+		audio->max_buffering_ticks = 45 * AUDIO_OUTPUT_FRAMES / frames;
 	}
 	audio->fixed_buffer = oai->fixed_buffering;
 
-	int max_buffering_ms =
-		audio->max_buffering_ticks * AUDIO_OUTPUT_FRAMES * SEC_TO_MSEC / (int)oai->samples_per_sec;
+	int max_buffering_ms = audio->max_buffering_ticks * (int)frames * SEC_TO_MSEC / (int)oai->samples_per_sec;
 
 	ai.name = "Audio";
 	ai.samples_per_sec = oai->samples_per_sec;
 	ai.format = AUDIO_FORMAT_FLOAT_PLANAR;
 	ai.speakers = oai->speakers;
 	ai.input_callback = audio_callback;
+	ai.output_frames = frames;
 
 	blog(LOG_INFO, "---------------------------------");
 	blog(LOG_INFO,
 	     "audio settings reset:\n"
 	     "\tsamples per sec: %d\n"
 	     "\tspeakers:        %d\n"
+	     "\tblock size:      %d frames\n"
 	     "\tmax buffering:   %d milliseconds\n"
 	     "\tbuffering type:  %s",
-	     (int)ai.samples_per_sec, (int)ai.speakers, max_buffering_ms,
+	     (int)ai.samples_per_sec, (int)ai.speakers, (int)frames, max_buffering_ms,
 	     oai->fixed_buffering ? "fixed" : "dynamically increasing");
 
 	return obs_init_audio(&ai);
@@ -1609,6 +1855,56 @@ bool obs_get_audio_info(struct obs_audio_info *oai)
 	return true;
 }
 
+static uint64_t source_clock_time(void *param)
+{
+	struct obs_core_audio *audio = param;
+	uint64_t time;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	time = audio->clock_base;
+	if (audio->clock_rate)
+		time += audio_frames_to_ns(audio->clock_rate, audio->clock_frames);
+
+	/* between packets the clock runs at the rate of the system clock, the
+	 * audio thread filters out the resulting jitter */
+	time += os_gettime_ns() - audio->clock_ts;
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	return time;
+}
+
+bool obs_set_audio_clock_source(obs_source_t *source)
+{
+	struct obs_core_audio *audio = &obs->audio;
+
+	if (!audio->audio)
+		return false;
+	if (source && (source->info.output_flags & OBS_SOURCE_AUDIO) == 0)
+		return false;
+
+	pthread_mutex_lock(&audio->clock_mutex);
+	audio->clock_source = source;
+	audio->clock_base = os_gettime_ns();
+	audio->clock_ts = audio->clock_base;
+	audio->clock_frames = 0;
+	audio->clock_rate = 0;
+	pthread_mutex_unlock(&audio->clock_mutex);
+
+	struct audio_output_clock clock = {
+		.get_time = source_clock_time,
+		.param = audio,
+	};
+	audio_output_set_clock(audio->audio, source ? &clock : NULL);
+
+	blog(LOG_INFO, "Audio clock: %s", source ? obs_source_get_name(source) : "system");
+	return true;
+}
+
+double obs_get_audio_clock_ratio(void)
+{
+	return audio_output_get_clock_ratio(obs->audio.audio);
+}
+
 bool obs_enum_source_types(size_t idx, const char **id)
 {
 	if (idx >= obs->source_types.num)
@@ -2105,9 +2401,8 @@ gs_texture_t *obs_get_main_texture(void)
 	return video->render_texture;
 }
 
-static obs_source_t *obs_load_source_type(obs_data_t *source_data, bool is_private)
+static obs_source_t *obs_load_source_begin(obs_data_t *source_data, bool is_private)
 {
-	obs_data_array_t *filters = obs_data_get_array(source_data, "filters");
 	obs_source_t *source;
 	const char *name = obs_data_get_string(source_data, "name");
 	const char *uuid = obs_data_get_string(source_data, "uuid");
@@ -2115,30 +2410,43 @@ static obs_source_t *obs_load_source_type(obs_data_t *source_data, bool is_priva
 	const char *v_id = obs_data_get_string(source_data, "versioned_id");
 	obs_data_t *settings = obs_data_get_obj(source_data, "settings");
 	obs_data_t *hotkeys = obs_data_get_obj(source_data, "hotkeys");
-	double volume;
-	double balance;
-	int64_t sync;
 	uint32_t prev_ver;
-	uint32_t caps;
-	uint32_t flags;
-	uint32_t mixers;
-	int di_order;
-	int di_mode;
-	int monitoring_type;
 
 	prev_ver = (uint32_t)obs_data_get_int(source_data, "prev_ver");
 
 	if (!*v_id)
 		v_id = id;
 
-	source = obs_source_create_set_last_ver(v_id, name, uuid, settings, hotkeys, prev_ver, is_private);
+	source = obs_source_create_deferred(v_id, name, uuid, settings, hotkeys, prev_ver, is_private);
 
-	if (source->owns_info_id) {
+	if (source && source->owns_info_id) {
 		bfree((void *)source->info.unversioned_id);
 		source->info.unversioned_id = bstrdup(id);
 	}
 
 	obs_data_release(hotkeys);
+	obs_data_release(settings);
+
+	return source;
+}
+
+static obs_source_t *obs_load_source_type(obs_data_t *source_data, bool is_private);
+
+static void obs_load_source_end(obs_source_t *source, obs_data_t *source_data)
+{
+	obs_data_array_t *filters = obs_data_get_array(source_data, "filters");
+	double volume;
+	double balance;
+	int64_t sync;
+	uint32_t prev_ver;
+	uint32_t caps;
+	uint32_t flags;
+	uint32_t mixers;
+	int di_order;
+	int di_mode;
+	int monitoring_type;
+
+	prev_ver = (uint32_t)obs_data_get_int(source_data, "prev_ver");
 
 	caps = obs_source_get_output_flags(source);
 
@@ -2219,8 +2527,17 @@ static obs_source_t *obs_load_source_type(obs_data_t *source_data, bool is_priva
 
 		obs_data_array_release(filters);
 	}
+}
 
-	obs_data_release(settings);
+static obs_source_t *obs_load_source_type(obs_data_t *source_data, bool is_private)
+{
+	obs_source_t *source = obs_load_source_begin(source_data, is_private);
+
+	if (source) {
+		obs_source_create_data(source);
+		obs_source_create_end(source);
+		obs_load_source_end(source, source_data);
+	}
 
 	return source;
 }
@@ -2235,49 +2552,247 @@ obs_source_t *obs_load_private_source(obs_data_t *source_data)
 	return obs_load_source_type(source_data, true);
 }
 
+void obs_set_lazy_source_creation(bool enable)
+{
+	os_atomic_set_bool(&obs->data.lazy_create, enable);
+}
+
+bool obs_get_lazy_source_creation(void)
+{
+	return os_atomic_load_bool(&obs->data.lazy_create);
+}
+
+struct source_load_job {
+	obs_data_t *source_data;
+	obs_source_t *source;
+	uint64_t create_ns;
+	uint64_t load_ns;
+	bool parallel;
+	bool lazy;
+};
+
+struct source_load_stats {
+	const char *id;
+	size_t count;
+	size_t parallel;
+	size_t lazy;
+	uint64_t create_ns;
+	uint64_t load_ns;
+};
+
+struct parallel_create {
+	struct source_load_job **jobs;
+	size_t count;
+	volatile long next;
+};
+
+static inline bool can_create_in_parallel(obs_source_t *source)
+{
+	/* scenes and transitions reference other sources, so they are only
+	 * ever created once everything before them has been */
+	return (source->info.output_flags & OBS_SOURCE_CAP_PARALLEL_CREATE) != 0 &&
+	       source->info.type != OBS_SOURCE_TYPE_SCENE && source->info.type != OBS_SOURCE_TYPE_TRANSITION;
+}
+
+/* inputs whose type data can be created from any thread can wait until
+ * they're first used */
+static inline bool can_create_lazily(obs_source_t *source)
+{
+	return source->info.type == OBS_SOURCE_TYPE_INPUT && can_create_in_parallel(source);
+}
+
+static void create_job_source(struct source_load_job *job)
+{
+	uint64_t start = os_gettime_ns();
+	obs_source_create_data(job->source);
+	job->create_ns = os_gettime_ns() - start;
+}
+
+static void *parallel_create_thread(void *param)
+{
+	struct parallel_create *pc = param;
+
+	for (;;) {
+		size_t idx = (size_t)os_atomic_inc_long(&pc->next) - 1;
+		if (idx >= pc->count)
+			break;
+
+		create_job_source(pc->jobs[idx]);
+	}
+
+	return NULL;
+}
+
+static void create_sources_parallel(struct parallel_create *pc)
+{
+	DARRAY(pthread_t) threads;
+	size_t num_threads;
+
+	da_init(threads);
+
+	num_threads = (size_t)os_get_logical_cores();
+	if (num_threads > pc->count)
+		num_threads = pc->count;
+
+	/* the calling thread takes part as well */
+	for (size_t i = 1; i < num_threads; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, parallel_create_thread, pc) == 0)
+			da_push_back(threads, &thread);
+	}
+
+	parallel_create_thread(pc);
+
+	for (size_t i = 0; i < threads.num; i++)
+		pthread_join(threads.array[i], NULL);
+
+	da_free(threads);
+}
+
+static void log_load_stats(struct source_load_job *jobs, size_t count, uint64_t total_ns)
+{
+	DARRAY(struct source_load_stats) stats;
+	size_t parallel = 0;
+	size_t lazy = 0;
+
+	da_init(stats);
+
+	for (size_t i = 0; i < count; i++) {
+		struct source_load_job *job = &jobs[i];
+		struct source_load_stats *type = NULL;
+
+		if (!job->source)
+			continue;
+
+		for (size_t j = 0; j < stats.num; j++) {
+			if (strcmp(stats.array[j].id, job->source->info.id) == 0) {
+				type = &stats.array[j];
+				break;
+			}
+		}
+
+		if (!type) {
+			type = da_push_back_new(stats);
+			type->id = job->source->info.id;
+		}
+
+		type->count++;
+		type->create_ns += job->create_ns;
+		type->load_ns += job->load_ns;
+		if (job->parallel) {
+			type->parallel++;
+			parallel++;
+		}
+		if (job->lazy) {
+			type->lazy++;
+			lazy++;
+		}
+	}
+
+	blog(LOG_INFO, "Loaded %zu sources in %.1f ms (%zu created in parallel, %zu deferred until first use)", count,
+	     (double)total_ns / 1000000.0, parallel, lazy);
+
+	for (size_t i = 0; i < stats.num; i++) {
+		struct source_load_stats *type = &stats.array[i];
+		blog(LOG_INFO, "    %s: %zu (%zu parallel, %zu deferred), create: %.1f ms, load: %.1f ms", type->id,
+		     type->count, type->parallel, type->lazy, (double)type->create_ns / 1000000.0,
+		     (double)type->load_ns / 1000000.0);
+	}
+
+	da_free(stats);
+}
+
 void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *private_data)
 {
 	struct obs_core_data *data = &obs->data;
-	DARRAY(obs_source_t *) sources;
+	struct parallel_create pc = {0};
+	DARRAY(struct source_load_job) jobs;
+	DARRAY(struct source_load_job *) parallel_jobs;
+	uint64_t start = os_gettime_ns();
+	bool lazy_create = os_atomic_load_bool(&data->lazy_create);
 	size_t count;
 	size_t i;
 
-	da_init(sources);
+	da_init(jobs);
+	da_init(parallel_jobs);
 
 	count = obs_data_array_count(array);
-	da_reserve(sources, count);
+	da_resize(jobs, count);
+
+	/* sources aren't visible to anything else until they're finished, so
+	 * the type data of sources that allow it can be created on worker
+	 * threads without holding the sources mutex */
+	for (i = 0; i < count; i++) {
+		struct source_load_job *job = &jobs.array[i];
+
+		job->source_data = obs_data_array_item(array, i);
+		job->source = obs_load_source_begin(job->source_data, false);
+		if (!job->source)
+			continue;
+
+		/* sources created lazily are created and loaded on the lazy
+		 * creation queue once they're first shown or activated */
+		job->lazy = lazy_create && can_create_lazily(job->source);
+		job->parallel = !job->lazy && can_create_in_parallel(job->source);
+
+		if (job->lazy) {
+			job->source->create_pending = true;
+			os_event_init(&job->source->created_event, OS_EVENT_TYPE_MANUAL);
+		} else if (job->parallel)
+			da_push_back(parallel_jobs, &job);
+	}
+
+	if (parallel_jobs.num) {
+		pc.jobs = parallel_jobs.array;
+		pc.count = parallel_jobs.num;
+		create_sources_parallel(&pc);
+	}
 
 	pthread_mutex_lock(&data->sources_mutex);
 
+	/* everything else is created serially in the original order, so
+	 * every source exists before any of them are loaded */
 	for (i = 0; i < count; i++) {
-		obs_data_t *source_data = obs_data_array_item(array, i);
-		obs_source_t *source = obs_load_source(source_data);
+		struct source_load_job *job = &jobs.array[i];
 
-		da_push_back(sources, &source);
+		if (!job->source)
+			continue;
 
-		obs_data_release(source_data);
+		if (!job->parallel && !job->lazy)
+			create_job_source(job);
+		obs_source_create_end(job->source);
+		obs_load_source_end(job->source, job->source_data);
 	}
 
 	/* tell sources that we want to load */
-	for (i = 0; i < sources.num; i++) {
-		obs_source_t *source = sources.array[i];
-		obs_data_t *source_data = obs_data_array_item(array, i);
+	for (i = 0; i < count; i++) {
+		struct source_load_job *job = &jobs.array[i];
+		obs_source_t *source = job->source;
+
 		if (source) {
+			uint64_t load_start = os_gettime_ns();
+
 			if (source->info.type == OBS_SOURCE_TYPE_TRANSITION)
-				obs_transition_load(source, source_data);
+				obs_transition_load(source, job->source_data);
 			obs_source_load2(source);
+			job->load_ns = os_gettime_ns() - load_start;
+
 			if (cb)
 				cb(private_data, source);
 		}
-		obs_data_release(source_data);
 	}
 
-	for (i = 0; i < sources.num; i++)
-		obs_source_release(sources.array[i]);
+	log_load_stats(jobs.array, count, os_gettime_ns() - start);
+
+	for (i = 0; i < count; i++) {
+		obs_source_release(jobs.array[i].source);
+		obs_data_release(jobs.array[i].source_data);
+	}
 
 	pthread_mutex_unlock(&data->sources_mutex);
 
-	da_free(sources);
+	da_free(parallel_jobs);
+	da_free(jobs);
 }
 
 obs_data_t *obs_save_source(obs_source_t *source)
@@ -2376,6 +2891,30 @@ obs_data_t *obs_save_source(obs_source_t *source)
 	return source_data;
 }
 
+static bool saves_untracked_data(obs_source_t *source)
+{
+	bool untracked = !!source->info.save;
+
+	pthread_mutex_lock(&source->filter_mutex);
+	for (size_t i = 0; !untracked && i < source->filters.num; i++)
+		untracked = !!source->filters.array[i]->info.save;
+	pthread_mutex_unlock(&source->filter_mutex);
+
+	return untracked;
+}
+
+long obs_source_get_save_revision(obs_source_t *source)
+{
+	if (!obs_source_valid(source, "obs_source_get_save_revision"))
+		return 0;
+
+	/* whatever a save callback stores can change at any time */
+	if (saves_untracked_data(source))
+		return os_atomic_inc_long(&source->save_revision);
+
+	return os_atomic_load_long(&source->save_revision);
+}
+
 obs_data_array_t *obs_save_sources_filtered(obs_save_source_filter_cb cb, void *data_)
 {
 	struct obs_core_data *data = &obs->data;
@@ -2724,6 +3263,56 @@ uint64_t obs_get_video_frame_time(void)
 	return obs->video.video_time;
 }
 
+uint64_t obs_get_time_ns(void)
+{
+	if (obs && os_atomic_load_bool(&obs->video.offline))
+		return obs->video.video_time;
+
+	return os_gettime_ns();
+}
+
+bool obs_set_offline_rendering(bool offline)
+{
+	if (!obs)
+		return false;
+	if (offline == os_atomic_load_bool(&obs->video.offline))
+		return true;
+
+	if (obs_video_active()) {
+		blog(LOG_WARNING, "Cannot change offline rendering while outputs are active");
+		return false;
+	}
+
+	pthread_mutex_lock(&obs->video.mixes_mutex);
+	for (size_t i = 0, num = obs->video.mixes.num; i < num; i++)
+		video_output_set_offline(obs->video.mixes.array[i]->video, offline);
+	os_atomic_set_bool(&obs->video.offline, offline);
+	pthread_mutex_unlock(&obs->video.mixes_mutex);
+
+	audio_output_set_offline(obs->audio.audio, offline);
+
+	blog(LOG_INFO, "Offline rendering %s", offline ? "enabled" : "disabled");
+	return true;
+}
+
+bool obs_offline_rendering_active(void)
+{
+	return obs && os_atomic_load_bool(&obs->video.offline);
+}
+
+void obs_set_frame_pacing(uint32_t spin_us, bool realtime)
+{
+	if (!obs)
+		return;
+
+	/* applied by the graphics thread on its next frame */
+	os_atomic_set_long(&obs->video.pacing_spin_us, (long)spin_us);
+	os_atomic_set_bool(&obs->video.pacing_realtime, realtime);
+
+	blog(LOG_INFO, "Frame pacing: %" PRIu32 " us spin, realtime scheduling %s", spin_us,
+	     realtime ? "requested" : "off");
+}
+
 double obs_get_active_fps(void)
 {
 	return obs->video.video_fps;
@@ -3197,6 +3786,22 @@ static void set_ui_thread(void *unused)
 	UNUSED_PARAMETER(unused);
 }
 
+os_file_watch_t *obs_watch_file(const char *path, os_file_watch_cb callback, void *param)
+{
+	if (!obs)
+		return NULL;
+
+	return os_file_watcher_add(obs->file_watcher, path, callback, param);
+}
+
+void obs_unwatch_file(os_file_watch_t *watch)
+{
+	if (!obs)
+		return;
+
+	os_file_watcher_remove(obs->file_watcher, watch);
+}
+
 void obs_set_ui_task_handler(obs_task_handler_t handler)
 {
 	obs->ui_task_handler = handler;
@@ -21,6 +21,7 @@
 #include "util/bmem.h"
 #include "util/profiler.h"
 #include "util/text-lookup.h"
+#include "util/file-watcher.h"
 #include "graphics/graphics.h"
 #include "graphics/vec2.h"
 #include "graphics/vec3.h"
@@ -214,6 +215,10 @@ struct obs_audio_info2 {
 
 	uint32_t max_buffering_ms;
 	bool fixed_buffering;
+
+	/* frames per audio tick, from MIN_AUDIO_OUTPUT_FRAMES to
+	 * AUDIO_OUTPUT_FRAMES.  0 for AUDIO_OUTPUT_FRAMES */
+	uint32_t output_frames;
 };
 
 /**
@@ -417,6 +422,30 @@ EXPORT profiler_name_store_t *obs_get_profiler_name_store(void);
  */
 EXPORT int obs_reset_video(struct obs_video_info *ovi);
 
+/**
+ * Changes base/output resolution, format or fps while outputs are active.
+ * The new video mixes are created next to the current ones and swapped in
+ * between two frames.  Active video encoders are reinitialized for the new
+ * settings and continue their timeline with a keyframe, so outputs see a
+ * short gap instead of having to be restarted.  The gap is logged.
+ *
+ * If no output is active, this is the same as obs_reset_video.
+ *
+ * @note The graphics module and adapter are kept as they are.
+ * @note Outputs must be able to handle new stream parameters mid-stream,
+ *       which usually means they should be restarted anyway if the frame
+ *       rate changes.
+ *
+ * @param   ovi  Pointer to an obs_video_info structure containing the
+ *               new video settings
+ * @return       OBS_VIDEO_SUCCESS if successful
+ *               OBS_VIDEO_INVALID_PARAM if a parameter is invalid
+ *               OBS_VIDEO_FAIL if the new video mixes couldn't be created,
+ *               or an encoder failed to reinitialize, in which case its
+ *               outputs are stopped
+ */
+EXPORT int obs_reconfigure_video(struct obs_video_info *ovi);
+
 /**
  * Sets base audio output format/channels/samples/etc
  *
@@ -440,6 +469,20 @@ EXPORT void obs_set_video_levels(float sdr_white_level, float hdr_nominal_peak_l
 /** Gets the current audio settings, returns false if no audio */
 EXPORT bool obs_get_audio_info(struct obs_audio_info *oai);
 
+/**
+ * Runs audio on the sample clock of an audio source, e.g. an audio device
+ * capture, instead of the system clock.  The audio of all other sources is
+ * then resampled to follow that clock, so that drift between devices doesn't
+ * lead to audio being dropped or buffered.  NULL returns to the system clock,
+ * as does resetting audio.
+ *
+ * @return false if there's no audio, or the source has no audio
+ */
+EXPORT bool obs_set_audio_clock_source(obs_source_t *source);
+
+/** Gets the rate of the audio clock relative to the system clock */
+EXPORT double obs_get_audio_clock_ratio(void);
+
 /**
  * Opens a plugin module directly from a specific path.
  *
@@ -748,6 +791,14 @@ EXPORT gs_texture_t *obs_get_main_texture(void);
 /** Saves a source to settings data */
 EXPORT obs_data_t *obs_save_source(obs_source_t *source);
 
+/**
+ * Returns a revision number of the data obs_save_source returns, which
+ * changes whenever that data changes, except for changes made directly to the
+ * source's settings or private settings objects.  Sources (or filters) that
+ * save data in a save callback, like scenes, return a new revision every time.
+ */
+EXPORT long obs_source_get_save_revision(obs_source_t *source);
+
 /** Loads a source from settings data */
 EXPORT obs_source_t *obs_load_source(obs_data_t *data);
 
@@ -768,6 +819,16 @@ typedef void (*obs_load_source_cb)(void *private_data, obs_source_t *source);
 /** Loads sources from a data array */
 EXPORT void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *private_data);
 
+/**
+ * Enables lazy creation of sources loaded with obs_load_sources.  Inputs of
+ * types with OBS_SOURCE_CAP_PARALLEL_CREATE then only keep their settings
+ * until they're first shown or activated, at which point they're created and
+ * loaded on a worker thread, or until their properties are requested, which
+ * creates them on the calling thread.
+ */
+EXPORT void obs_set_lazy_source_creation(bool enable);
+EXPORT bool obs_get_lazy_source_creation(void);
+
 /** Saves sources to a data array */
 EXPORT obs_data_array_t *obs_save_sources(void);
 
@@ -824,6 +885,35 @@ EXPORT void obs_remove_raw_audio_callback(size_t mix_idx, audio_output_callback_
 
 EXPORT uint64_t obs_get_video_frame_time(void);
 
+/**
+ * Gets the current time of the libobs clock.  This is the system time, or the
+ * time of the frame being rendered when rendering offline.  Use this instead
+ * of os_gettime_ns for timestamps that have to line up with video and audio.
+ */
+EXPORT uint64_t obs_get_time_ns(void);
+
+/**
+ * Renders offline: instead of following the system clock, video and audio are
+ * rendered as fast as possible on a virtual clock, and no frames are dropped
+ * when outputs fall behind, so recordings are the same on every run.
+ *
+ * Cannot be changed while outputs are active.  Audio cannot be reset while
+ * rendering offline.
+ */
+EXPORT bool obs_set_offline_rendering(bool offline);
+EXPORT bool obs_offline_rendering_active(void);
+
+/**
+ * Sets how precisely the graphics thread wakes up for each frame.  With
+ * spin_us set, it sleeps until that long before the frame and busy-waits the
+ * rest.  If realtime is set, the graphics thread asks for realtime scheduling,
+ * which usually requires elevated privileges.
+ *
+ * The wake-up error of each frame is recorded in the profiler as
+ * "video_wake_error".
+ */
+EXPORT void obs_set_frame_pacing(uint32_t spin_us, bool realtime);
+
 EXPORT double obs_get_active_fps(void);
 EXPORT uint64_t obs_get_average_frame_time_ns(void);
 EXPORT uint64_t obs_get_frame_interval_ns(void);
@@ -852,6 +942,15 @@ EXPORT bool obs_in_task_thread(enum obs_task_type type);
 
 EXPORT bool obs_wait_for_destroy_queue(void);
 
+/**
+ * Watches a file for changes.  The callback is called from the file watcher
+ * thread, and must not add or remove watches.  Returns NULL on failure.
+ */
+EXPORT os_file_watch_t *obs_watch_file(const char *path, os_file_watch_cb callback, void *param);
+
+/** Stops watching a file.  The callback will not be called once this returns. */
+EXPORT void obs_unwatch_file(os_file_watch_t *watch);
+
 typedef void (*obs_task_handler_t)(obs_task_t task, void *param, bool wait);
 EXPORT void obs_set_ui_task_handler(obs_task_handler_t handler);
 
@@ -891,7 +990,10 @@ EXPORT void obs_view_render(obs_view_t *view);
 /** Adds a view to the main render loop, with current obs_get_video_info state */
 EXPORT video_t *obs_view_add(obs_view_t *view);
 
-/** Adds a view to the main render loop, with custom video settings */
+/**
+ * Adds a view to the main render loop, with custom video settings.  The view
+ * is rendered at its own frame rate, on the ticks of that rate.
+ */
 EXPORT video_t *obs_view_add2(obs_view_t *view, struct obs_video_info *ovi);
 
 /** Removes a view from the main render loop */
@@ -903,6 +1005,12 @@ OBS_DEPRECATED EXPORT bool obs_view_get_video_info(obs_view_t *view, struct obs_
 /** Enumerate the video info of all mixes using the specified view context */
 EXPORT void obs_view_enum_video_info(obs_view_t *view, bool (*enum_proc)(void *, struct obs_video_info *), void *param);
 
+/** Gets the number of frames rendered for the view, including lagged ones */
+EXPORT uint32_t obs_view_get_total_frames(obs_view_t *view);
+
+/** Gets the number of frames of the view that were missed due to rendering lag */
+EXPORT uint32_t obs_view_get_lagged_frames(obs_view_t *view);
+
 /* ------------------------------------------------------------------------- */
 /* Display context */
 
@@ -1594,6 +1702,9 @@ EXPORT obs_sceneitem_t *obs_scene_find_source(obs_scene_t *scene, const char *na
 
 EXPORT obs_sceneitem_t *obs_scene_find_source_recursive(obs_scene_t *scene, const char *name);
 
+/** Determines whether a source is within a scene by the source's UUID */
+EXPORT obs_sceneitem_t *obs_scene_find_source_by_uuid(obs_scene_t *scene, const char *uuid);
+
 EXPORT obs_sceneitem_t *obs_scene_find_sceneitem_by_id(obs_scene_t *scene, int64_t id);
 
 /** Gets scene by name, increments the reference */
@@ -0,0 +1,517 @@
+/******************************************************************************
+    Copyright (C) 2026 by OBS Studio contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <sys/stat.h>
+
+#include "file-watcher.h"
+#include "platform.h"
+#include "threading.h"
+#include "darray.h"
+#include "dstr.h"
+#include "base.h"
+#include "bmem.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#define INOTIFY_MASK                                                                                        \
+	(IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_CREATE | IN_DELETE | \
+	 IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+#define POLL_INTERVAL_NS 1000000000ULL
+#define DEBOUNCE_NS 100000000ULL
+
+struct os_file_watch {
+	char *path;
+	const char *file;
+	os_file_watch_cb callback;
+	void *param;
+
+	/* inotify watch descriptor of the parent directory, or -1 if polled */
+	int wd;
+
+	bool exists;
+	time_t mtime;
+	int64_t size;
+
+	bool pending;
+	uint64_t pending_time;
+	bool removed;
+};
+
+struct watch_dir {
+	int wd;
+	long refs;
+};
+
+struct os_file_watcher {
+	pthread_t thread;
+	bool thread_active;
+	volatile bool stop;
+	os_event_t *stop_event;
+
+	/* protects the watch list, held by the watcher thread while reading
+	 * events */
+	pthread_mutex_t mutex;
+	/* held while calling callbacks, so removal can wait for them */
+	pthread_mutex_t callback_mutex;
+
+	DARRAY(struct os_file_watch *) watches;
+	DARRAY(struct os_file_watch *) ready;
+
+	int inotify_fd;
+	int wake_fds[2];
+	DARRAY(struct watch_dir) dirs;
+};
+
+static void update_file_state(struct os_file_watch *watch, bool *changed)
+{
+	struct stat st;
+	bool exists = os_stat(watch->path, &st) == 0;
+	time_t mtime = exists ? st.st_mtime : 0;
+	int64_t size = exists ? (int64_t)st.st_size : 0;
+
+	if (changed)
+		*changed = exists != watch->exists || mtime != watch->mtime || size != watch->size;
+
+	watch->exists = exists;
+	watch->mtime = mtime;
+	watch->size = size;
+}
+
+static inline void mark_pending(struct os_file_watch *watch, uint64_t now)
+{
+	watch->pending = true;
+	watch->pending_time = now;
+}
+
+/* ------------------------------------------------------------------------- */
+/* inotify */
+
+#ifdef __linux__
+static bool init_inotify(struct os_file_watcher *fw)
+{
+	fw->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fw->inotify_fd == -1)
+		return false;
+
+	if (pipe(fw->wake_fds) != 0) {
+		close(fw->inotify_fd);
+		fw->inotify_fd = -1;
+		return false;
+	}
+
+	fcntl(fw->wake_fds[0], F_SETFL, O_NONBLOCK);
+	return true;
+}
+
+static void free_inotify(struct os_file_watcher *fw)
+{
+	if (fw->inotify_fd == -1)
+		return;
+
+	close(fw->inotify_fd);
+	close(fw->wake_fds[0]);
+	close(fw->wake_fds[1]);
+}
+
+static void attach_watch(struct os_file_watcher *fw, struct os_file_watch *watch)
+{
+	struct dstr dir = {0};
+	int wd;
+
+	if (fw->inotify_fd == -1)
+		return;
+
+	if (watch->file != watch->path)
+		dstr_ncopy(&dir, watch->path, watch->file - watch->path);
+	else
+		dstr_copy(&dir, ".");
+
+	wd = inotify_add_watch(fw->inotify_fd, dir.array, INOTIFY_MASK);
+	dstr_free(&dir);
+
+	if (wd == -1)
+		return;
+
+	watch->wd = wd;
+
+	for (size_t i = 0; i < fw->dirs.num; i++) {
+		if (fw->dirs.array[i].wd == wd) {
+			fw->dirs.array[i].refs++;
+			return;
+		}
+	}
+
+	struct watch_dir *item = da_push_back_new(fw->dirs);
+	item->wd = wd;
+	item->refs = 1;
+}
+
+static void detach_watch(struct os_file_watcher *fw, struct os_file_watch *watch)
+{
+	if (watch->wd == -1)
+		return;
+
+	for (size_t i = 0; i < fw->dirs.num; i++) {
+		struct watch_dir *item = &fw->dirs.array[i];
+		if (item->wd != watch->wd)
+			continue;
+
+		if (--item->refs == 0) {
+			inotify_rm_watch(fw->inotify_fd, item->wd);
+			da_erase(fw->dirs, i);
+		}
+		break;
+	}
+
+	watch->wd = -1;
+}
+
+/* falls back to polling for everything in a directory that's gone away */
+static void drop_dir(struct os_file_watcher *fw, int wd, uint64_t now)
+{
+	inotify_rm_watch(fw->inotify_fd, wd);
+
+	for (size_t i = 0; i < fw->dirs.num; i++) {
+		if (fw->dirs.array[i].wd == wd) {
+			da_erase(fw->dirs, i);
+			break;
+		}
+	}
+
+	for (size_t i = 0; i < fw->watches.num; i++) {
+		struct os_file_watch *watch = fw->watches.array[i];
+		if (watch->wd == wd) {
+			watch->wd = -1;
+			update_file_state(watch, NULL);
+			mark_pending(watch, now);
+		}
+	}
+}
+
+static void read_inotify_events(struct os_file_watcher *fw)
+{
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	uint64_t now = os_gettime_ns();
+	ssize_t len;
+
+	pthread_mutex_lock(&fw->mutex);
+
+	while ((len = read(fw->inotify_fd, buf, sizeof(buf))) > 0) {
+		char *ptr = buf;
+
+		while (ptr < buf + len) {
+			const struct inotify_event *event = (const struct inotify_event *)ptr;
+			ptr += sizeof(*event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				for (size_t i = 0; i < fw->watches.num; i++)
+					mark_pending(fw->watches.array[i], now);
+				continue;
+			}
+
+			if (event->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+				drop_dir(fw, event->wd, now);
+				continue;
+			}
+
+			if (!event->len)
+				continue;
+
+			for (size_t i = 0; i < fw->watches.num; i++) {
+				struct os_file_watch *watch = fw->watches.array[i];
+				if (watch->wd == event->wd && strcmp(watch->file, event->name) == 0)
+					mark_pending(watch, now);
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&fw->mutex);
+}
+
+static void wait_for_events(struct os_file_watcher *fw, uint64_t timeout_ns)
+{
+	int timeout_ms = (int)(timeout_ns / 1000000);
+	struct pollfd fds[2] = {
+		{fw->inotify_fd, POLLIN, 0},
+		{fw->wake_fds[0], POLLIN, 0},
+	};
+
+	if (fw->inotify_fd == -1) {
+		os_event_timedwait(fw->stop_event, (unsigned long)timeout_ms);
+		return;
+	}
+
+	if (poll(fds, 2, timeout_ms) > 0 && (fds[0].revents & POLLIN))
+		read_inotify_events(fw);
+}
+
+static void wake_thread(struct os_file_watcher *fw)
+{
+	if (fw->inotify_fd != -1) {
+		char c = 0;
+		ssize_t unused = write(fw->wake_fds[1], &c, 1);
+		UNUSED_PARAMETER(unused);
+	}
+}
+#else
+static bool init_inotify(struct os_file_watcher *fw)
+{
+	UNUSED_PARAMETER(fw);
+	return false;
+}
+
+static void free_inotify(struct os_file_watcher *fw)
+{
+	UNUSED_PARAMETER(fw);
+}
+
+static void attach_watch(struct os_file_watcher *fw, struct os_file_watch *watch)
+{
+	UNUSED_PARAMETER(fw);
+	UNUSED_PARAMETER(watch);
+}
+
+static void detach_watch(struct os_file_watcher *fw, struct os_file_watch *watch)
+{
+	UNUSED_PARAMETER(fw);
+	UNUSED_PARAMETER(watch);
+}
+
+static void wait_for_events(struct os_file_watcher *fw, uint64_t timeout_ns)
+{
+	os_event_timedwait(fw->stop_event, (unsigned long)(timeout_ns / 1000000));
+}
+
+static void wake_thread(struct os_file_watcher *fw)
+{
+	UNUSED_PARAMETER(fw);
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+static void poll_watches(struct os_file_watcher *fw, uint64_t now)
+{
+	pthread_mutex_lock(&fw->mutex);
+
+	for (size_t i = 0; i < fw->watches.num; i++) {
+		struct os_file_watch *watch = fw->watches.array[i];
+		bool changed;
+
+		if (watch->wd != -1)
+			continue;
+
+		/* the directory may have been created since */
+		attach_watch(fw, watch);
+
+		update_file_state(watch, &changed);
+		if (changed)
+			mark_pending(watch, now);
+	}
+
+	pthread_mutex_unlock(&fw->mutex);
+}
+
+static uint64_t get_wait_time(struct os_file_watcher *fw, uint64_t now, uint64_t next_poll)
+{
+	uint64_t wait = next_poll > now ? next_poll - now : 0;
+
+	pthread_mutex_lock(&fw->mutex);
+	for (size_t i = 0; i < fw->watches.num; i++) {
+		struct os_file_watch *watch = fw->watches.array[i];
+		if (watch->pending) {
+			uint64_t due = watch->pending_time + DEBOUNCE_NS;
+			uint64_t pending_wait = due > now ? due - now : 0;
+			if (pending_wait < wait)
+				wait = pending_wait;
+		}
+	}
+	pthread_mutex_unlock(&fw->mutex);
+
+	return wait;
+}
+
+static void dispatch_callbacks(struct os_file_watcher *fw, uint64_t now)
+{
+	pthread_mutex_lock(&fw->callback_mutex);
+	pthread_mutex_lock(&fw->mutex);
+
+	for (size_t i = 0; i < fw->watches.num; i++) {
+		struct os_file_watch *watch = fw->watches.array[i];
+		if (watch->pending && now - watch->pending_time >= DEBOUNCE_NS) {
+			watch->pending = false;
+			da_push_back(fw->ready, &watch);
+		}
+	}
+
+	pthread_mutex_unlock(&fw->mutex);
+
+	for (size_t i = 0; i < fw->ready.num; i++) {
+		struct os_file_watch *watch = fw->ready.array[i];
+		bool removed;
+
+		pthread_mutex_lock(&fw->mutex);
+		removed = watch->removed;
+		pthread_mutex_unlock(&fw->mutex);
+
+		if (!removed)
+			watch->callback(watch->param, watch->path);
+	}
+
+	da_resize(fw->ready, 0);
+	pthread_mutex_unlock(&fw->callback_mutex);
+}
+
+static void *file_watcher_thread(void *param)
+{
+	struct os_file_watcher *fw = param;
+	uint64_t next_poll = os_gettime_ns() + POLL_INTERVAL_NS;
+
+	os_set_thread_name("file watcher");
+
+	while (!os_atomic_load_bool(&fw->stop)) {
+		uint64_t now = os_gettime_ns();
+
+		wait_for_events(fw, get_wait_time(fw, now, next_poll));
+		if (os_atomic_load_bool(&fw->stop))
+			break;
+
+		now = os_gettime_ns();
+		if (now >= next_poll) {
+			poll_watches(fw, now);
+			next_poll = now + POLL_INTERVAL_NS;
+		}
+
+		dispatch_callbacks(fw, now);
+	}
+
+	return NULL;
+}
+
+os_file_watcher_t *os_file_watcher_create(void)
+{
+	struct os_file_watcher *fw = bzalloc(sizeof(*fw));
+
+	fw->inotify_fd = -1;
+	pthread_mutex_init_value(&fw->mutex);
+	pthread_mutex_init_value(&fw->callback_mutex);
+
+	if (pthread_mutex_init(&fw->mutex, NULL) != 0)
+		goto fail;
+	if (pthread_mutex_init(&fw->callback_mutex, NULL) != 0)
+		goto fail;
+	if (os_event_init(&fw->stop_event, OS_EVENT_TYPE_MANUAL) != 0)
+		goto fail;
+
+	if (!init_inotify(fw))
+		blog(LOG_INFO, "File watcher: inotify unavailable, polling for changes");
+
+	if (pthread_create(&fw->thread, NULL, file_watcher_thread, fw) != 0)
+		goto fail;
+
+	fw->thread_active = true;
+	return fw;
+
+fail:
+	os_file_watcher_destroy(fw);
+	return NULL;
+}
+
+void os_file_watcher_destroy(os_file_watcher_t *fw)
+{
+	if (!fw)
+		return;
+
+	if (fw->thread_active) {
+		os_atomic_set_bool(&fw->stop, true);
+		os_event_signal(fw->stop_event);
+		wake_thread(fw);
+		pthread_join(fw->thread, NULL);
+	}
+
+	for (size_t i = 0; i < fw->watches.num; i++) {
+		bfree(fw->watches.array[i]->path);
+		bfree(fw->watches.array[i]);
+	}
+
+	free_inotify(fw);
+	da_free(fw->watches);
+	da_free(fw->ready);
+	da_free(fw->dirs);
+	os_event_destroy(fw->stop_event);
+	pthread_mutex_destroy(&fw->callback_mutex);
+	pthread_mutex_destroy(&fw->mutex);
+	bfree(fw);
+}
+
+os_file_watch_t *os_file_watcher_add(os_file_watcher_t *fw, const char *path, os_file_watch_cb callback, void *param)
+{
+	struct os_file_watch *watch;
+	const char *slash;
+
+	if (!fw || !path || !*path || !callback)
+		return NULL;
+
+	watch = bzalloc(sizeof(*watch));
+	watch->path = bstrdup(path);
+	watch->callback = callback;
+	watch->param = param;
+	watch->wd = -1;
+
+	slash = strrchr(watch->path, '/');
+#ifdef _WIN32
+	const char *backslash = strrchr(watch->path, '\\');
+	if (backslash > slash)
+		slash = backslash;
+#endif
+	watch->file = slash ? slash + 1 : watch->path;
+
+	update_file_state(watch, NULL);
+
+	pthread_mutex_lock(&fw->mutex);
+	attach_watch(fw, watch);
+	da_push_back(fw->watches, &watch);
+	pthread_mutex_unlock(&fw->mutex);
+
+	return watch;
+}
+
+void os_file_watcher_remove(os_file_watcher_t *fw, os_file_watch_t *watch)
+{
+	if (!fw || !watch)
+		return;
+
+	pthread_mutex_lock(&fw->mutex);
+	da_erase_item(fw->watches, &watch);
+	detach_watch(fw, watch);
+	watch->removed = true;
+	pthread_mutex_unlock(&fw->mutex);
+
+	/* wait for any callbacks that are in progress */
+	pthread_mutex_lock(&fw->callback_mutex);
+	pthread_mutex_unlock(&fw->callback_mutex);
+
+	bfree(watch->path);
+	bfree(watch);
+}
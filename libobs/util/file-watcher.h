@@ -0,0 +1,53 @@
+/******************************************************************************
+    Copyright (C) 2026 by OBS Studio contributors
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "c99defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Watches files for changes on a background thread.  inotify is used where
+ * available, and files that can't be watched that way (no inotify, or their
+ * directory doesn't exist yet) are polled about once a second instead.
+ *
+ * Bursts of changes to a file are coalesced into a single callback.
+ * Callbacks are called from the watcher thread, and must not add or remove
+ * watches.  Once os_file_watcher_remove returns, the callback of that watch
+ * is guaranteed not to be running or to be called again.
+ */
+
+struct os_file_watcher;
+struct os_file_watch;
+typedef struct os_file_watcher os_file_watcher_t;
+typedef struct os_file_watch os_file_watch_t;
+
+typedef void (*os_file_watch_cb)(void *param, const char *path);
+
+EXPORT os_file_watcher_t *os_file_watcher_create(void);
+EXPORT void os_file_watcher_destroy(os_file_watcher_t *fw);
+
+EXPORT os_file_watch_t *os_file_watcher_add(os_file_watcher_t *fw, const char *path, os_file_watch_cb callback,
+					    void *param);
+EXPORT void os_file_watcher_remove(os_file_watcher_t *fw, os_file_watch_t *watch);
+
+#ifdef __cplusplus
+}
+#endif
@@ -224,6 +224,24 @@ bool os_sleepto_ns(uint64_t time_target)
 	if (time_target < current)
 		return false;
 
+#if !defined(__APPLE__)
+	/* sleep on the same clock as os_gettime_ns to an absolute deadline, so
+	 * interruptions and scheduling delays don't accumulate into drift */
+	struct timespec abs_req;
+	abs_req.tv_sec = time_target / 1000000000;
+	abs_req.tv_nsec = time_target % 1000000000;
+
+	int ret;
+	while ((ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &abs_req, NULL)) == EINTR)
+		;
+	if (ret == 0)
+		return true;
+
+	/* fall back to a relative sleep if the clock can't be slept on */
+	current = os_gettime_ns();
+	if (time_target < current)
+		return false;
+#endif
 	time_target -= current;
 
 	struct timespec req, remain;
@@ -240,6 +258,23 @@ bool os_sleepto_ns(uint64_t time_target)
 	return true;
 }
 
+bool os_sleepto_ns_spin(uint64_t time_target, uint64_t spin_ns)
+{
+	uint64_t current = os_gettime_ns();
+	if (time_target < current)
+		return false;
+
+	/* the scheduler can wake us late, so sleep until shortly before the
+	 * target and busy-wait the rest */
+	if (time_target - current > spin_ns)
+		os_sleepto_ns(time_target - spin_ns);
+
+	while (os_gettime_ns() < time_target)
+		;
+
+	return true;
+}
+
 bool os_sleepto_ns_fast(uint64_t time_target)
 {
 	uint64_t current = os_gettime_ns();
@@ -424,6 +424,13 @@ bool os_sleepto_ns(uint64_t time_target)
 	return stall;
 }
 
+bool os_sleepto_ns_spin(uint64_t time_target, uint64_t spin_ns)
+{
+	/* os_sleepto_ns already spins through the final millisecond */
+	UNUSED_PARAMETER(spin_ns);
+	return os_sleepto_ns(time_target);
+}
+
 bool os_sleepto_ns_fast(uint64_t time_target)
 {
 	uint64_t current = os_gettime_ns();
@@ -96,6 +96,13 @@ EXPORT void os_end_high_performance(os_performance_token_t *);
  */
 EXPORT bool os_sleepto_ns(uint64_t time_target);
 EXPORT bool os_sleepto_ns_fast(uint64_t time_target);
+
+/**
+ * Sleeps until spin_ns before the target time, then busy-waits until the
+ * target is reached, trading CPU time for a more accurate wake-up.  Returns
+ * false if already at or past target time.
+ */
+EXPORT bool os_sleepto_ns_spin(uint64_t time_target, uint64_t spin_ns);
 EXPORT void os_sleep_ms(uint32_t duration);
 
 EXPORT uint64_t os_gettime_ns(void);
@@ -429,6 +429,33 @@ void profile_end(const char *name)
 	merge_context(call);
 }
 
+void profile_add_time(const char *name, uint64_t time_ns)
+{
+	uint64_t end = os_gettime_ns();
+	if (!thread_enabled)
+		return;
+
+	profile_call new_call = {
+		.name = name,
+#ifdef TRACK_OVERHEAD
+		.overhead_start = end,
+		.overhead_end = end,
+#endif
+		.start_time = end - time_ns,
+		.end_time = end,
+		.parent = thread_context,
+	};
+
+	if (new_call.parent) {
+		da_push_back(new_call.parent->children, &new_call);
+		return;
+	}
+
+	profile_call *call = bmalloc(sizeof(profile_call));
+	memcpy(call, &new_call, sizeof(profile_call));
+	merge_context(call);
+}
+
 static int profiler_time_entry_compare(const void *first, const void *second)
 {
 	int64_t diff = ((profiler_time_entry *)second)->time_delta - ((profiler_time_entry *)first)->time_delta;
@@ -19,6 +19,10 @@ EXPORT void profile_register_root(const char *name, uint64_t expected_time_betwe
 EXPORT void profile_start(const char *name);
 EXPORT void profile_end(const char *name);
 
+/* records a call that took the given time without timing it, for values
+ * measured elsewhere that should show up in the profiler's histograms */
+EXPORT void profile_add_time(const char *name, uint64_t time_ns);
+
 EXPORT void profile_reenable_thread(void);
 
 /* ------------------------------------------------------------------------- */
@@ -271,3 +271,16 @@ void os_set_thread_name(const char *name)
 	}
 #endif
 }
+
+bool os_set_thread_realtime(bool enable)
+{
+	struct sched_param param = {0};
+	int policy = SCHED_OTHER;
+
+	if (enable) {
+		policy = SCHED_FIFO;
+		param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+	}
+
+	return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+}
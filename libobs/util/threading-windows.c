@@ -210,3 +210,9 @@ void os_set_thread_name(const char *name)
 		FreeLibrary(hModule);
 	}
 }
+
+bool os_set_thread_realtime(bool enable)
+{
+	int priority = enable ? THREAD_PRIORITY_HIGHEST : THREAD_PRIORITY_NORMAL;
+	return !!SetThreadPriority(GetCurrentThread(), priority);
+}
@@ -92,6 +92,13 @@ EXPORT int os_sem_wait(os_sem_t *sem);
 
 EXPORT void os_set_thread_name(const char *name);
 
+/**
+ * Asks the scheduler to run the current thread ahead of normal threads
+ * (SCHED_FIFO on POSIX systems), or returns it to normal scheduling.  This
+ * usually requires elevated privileges, and returns false if it's refused.
+ */
+EXPORT bool os_set_thread_realtime(bool enable);
+
 #ifdef _MSC_VER
 #define THREAD_LOCAL __declspec(thread)
 #else
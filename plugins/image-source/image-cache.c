@@ -0,0 +1,384 @@
+#include <obs-module.h>
+#include <util/threading.h>
+#include <util/platform.h>
+#include <util/darray.h>
+
+#include <sys/stat.h>
+#include <inttypes.h>
+
+#include "image-cache.h"
+
+/* images nothing is using anymore are kept around for sources that load the
+ * same file later (slideshows, sources unloaded while hidden) until the cache
+ * reaches its memory limit */
+#define DEFAULT_MEMORY_LIMIT_MB 256
+#define UPLOAD_BUDGET_PER_FRAME (32 * 1024 * 1024)
+#define MAX_DECODE_WORKERS 4
+
+struct image_cache_entry {
+	char *path;
+	int64_t mtime;
+	int64_t file_size;
+	enum gs_image_alpha_mode alpha_mode;
+
+	long refs;
+	uint64_t last_used;
+	bool cached;
+
+	os_event_t *decoded;
+	bool failed;
+
+	/* the pixel data is freed once the texture has been created from it */
+	uint8_t *data;
+	gs_texture_t *texture;
+	enum gs_color_format format;
+	enum gs_color_space space;
+	uint32_t cx;
+	uint32_t cy;
+	size_t size;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	DARRAY(struct image_cache_entry *) entries;
+	size_t mem_usage;
+	size_t memory_limit;
+	uint64_t use_counter;
+
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+
+	os_task_queue_t *workers[MAX_DECODE_WORKERS];
+	size_t num_workers;
+	volatile long next_worker;
+
+	uint64_t upload_frame_time;
+	size_t upload_size;
+} cache;
+
+void image_cache_init(void)
+{
+	int cores = os_get_logical_cores() / 2;
+
+	pthread_mutex_init(&cache.mutex, NULL);
+	cache.memory_limit = (size_t)DEFAULT_MEMORY_LIMIT_MB * 1024 * 1024;
+
+	cache.num_workers = cores < 1 ? 1 : (cores > MAX_DECODE_WORKERS ? MAX_DECODE_WORKERS : (size_t)cores);
+	for (size_t i = 0; i < cache.num_workers; i++)
+		cache.workers[i] = os_task_queue_create();
+}
+
+static void entry_free(struct image_cache_entry *entry)
+{
+	if (entry->texture) {
+		obs_enter_graphics();
+		gs_texture_destroy(entry->texture);
+		obs_leave_graphics();
+	}
+
+	os_event_destroy(entry->decoded);
+	bfree(entry->data);
+	bfree(entry->path);
+	bfree(entry);
+}
+
+static void log_stats(void)
+{
+	uint64_t lookups = cache.hits + cache.misses;
+
+	if (!lookups)
+		return;
+
+	blog(LOG_INFO,
+	     "[image_source] image cache: %" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate), %" PRIu64
+	     " evictions, %zu images using %zu MB",
+	     cache.hits, cache.misses, (double)cache.hits * 100.0 / (double)lookups, cache.evictions,
+	     cache.entries.num, cache.mem_usage / (1024 * 1024));
+}
+
+void image_cache_free(void)
+{
+	for (size_t i = 0; i < cache.num_workers; i++)
+		os_task_queue_destroy(cache.workers[i]);
+
+	log_stats();
+
+	for (size_t i = 0; i < cache.entries.num; i++)
+		entry_free(cache.entries.array[i]);
+	da_free(cache.entries);
+
+	pthread_mutex_destroy(&cache.mutex);
+	memset(&cache, 0, sizeof(cache));
+}
+
+void image_cache_queue_task(os_task_t task, void *param)
+{
+	long idx = os_atomic_inc_long(&cache.next_worker);
+	os_task_queue_queue_task(cache.workers[(size_t)idx % cache.num_workers], task, param);
+}
+
+/* removed entries are freed when their last reference is released */
+static void remove_entry(size_t idx)
+{
+	struct image_cache_entry *entry = cache.entries.array[idx];
+
+	cache.mem_usage -= entry->size;
+	entry->cached = false;
+	da_erase(cache.entries, idx);
+}
+
+typedef DARRAY(struct image_cache_entry *) entry_list_t;
+
+/* entries are freed after unlocking the cache, because destroying their
+ * textures requires the graphics context */
+static void free_entries(entry_list_t *list)
+{
+	for (size_t i = 0; i < list->num; i++)
+		entry_free(list->array[i]);
+	da_free(*list);
+}
+
+/* evicts the least recently used unreferenced images until the cache fits
+ * its memory limit.  images still in use can push it over the limit. */
+static void evict_entries(entry_list_t *evicted)
+{
+	while (cache.mem_usage > cache.memory_limit) {
+		size_t oldest = DARRAY_INVALID;
+
+		for (size_t i = 0; i < cache.entries.num; i++) {
+			struct image_cache_entry *entry = cache.entries.array[i];
+			if (entry->refs)
+				continue;
+			if (oldest == DARRAY_INVALID || entry->last_used < cache.entries.array[oldest]->last_used)
+				oldest = i;
+		}
+
+		if (oldest == DARRAY_INVALID)
+			break;
+
+		da_push_back(*evicted, &cache.entries.array[oldest]);
+		remove_entry(oldest);
+		cache.evictions++;
+	}
+}
+
+/* modification time in nanoseconds where the platform has it, so that files
+ * rewritten within the same second aren't mistaken for the cached image */
+static inline int64_t get_mtime(const struct stat *st)
+{
+#if defined(__APPLE__)
+	return (int64_t)st->st_mtimespec.tv_sec * 1000000000 + st->st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+	return (int64_t)st->st_mtime * 1000000000;
+#else
+	return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#endif
+}
+
+static struct image_cache_entry *find_entry(const char *path, const struct stat *st,
+					    enum gs_image_alpha_mode alpha_mode)
+{
+	for (size_t i = 0; i < cache.entries.num; i++) {
+		struct image_cache_entry *entry = cache.entries.array[i];
+		if (entry->mtime == get_mtime(st) && entry->file_size == (int64_t)st->st_size &&
+		    entry->alpha_mode == alpha_mode && strcmp(entry->path, path) == 0)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void decode_entry(struct image_cache_entry *entry)
+{
+	entry_list_t evicted = {0};
+
+	entry->data = gs_create_texture_file_data3(entry->path, entry->alpha_mode, &entry->format, &entry->cx,
+						   &entry->cy, &entry->space);
+	if (entry->data)
+		entry->size = (size_t)entry->cx * entry->cy * gs_get_format_bpp(entry->format) / 8;
+	else
+		blog(LOG_WARNING, "Failed to load file '%s'", entry->path);
+
+	pthread_mutex_lock(&cache.mutex);
+	if (entry->data) {
+		/* a reload may have replaced the entry while it was decoding */
+		if (entry->cached) {
+			cache.mem_usage += entry->size;
+			evict_entries(&evicted);
+		}
+	} else {
+		/* don't cache failures, the file may become readable later */
+		size_t idx = da_find(cache.entries, &entry, 0);
+		entry->failed = true;
+		if (idx != DARRAY_INVALID)
+			remove_entry(idx);
+	}
+	pthread_mutex_unlock(&cache.mutex);
+
+	os_event_signal(entry->decoded);
+	free_entries(&evicted);
+}
+
+static struct image_cache_entry *get_entry(const char *path, enum gs_image_alpha_mode alpha_mode, bool reload)
+{
+	entry_list_t replaced = {0};
+	struct image_cache_entry *entry;
+	struct stat st;
+	bool decode = false;
+
+	if (!path || !*path || os_stat(path, &st) != 0)
+		return NULL;
+
+	pthread_mutex_lock(&cache.mutex);
+	entry = find_entry(path, &st, alpha_mode);
+
+	/* a changed file can still look the same where modification times
+	 * only have second resolution, so reloads never use the cached image */
+	if (entry && reload) {
+		size_t idx = da_find(cache.entries, &entry, 0);
+
+		if (!entry->refs)
+			da_push_back(replaced, &entry);
+		remove_entry(idx);
+		entry = NULL;
+	}
+
+	if (!entry) {
+		entry = bzalloc(sizeof(*entry));
+		entry->path = bstrdup(path);
+		entry->mtime = get_mtime(&st);
+		entry->file_size = (int64_t)st.st_size;
+		entry->alpha_mode = alpha_mode;
+		entry->cached = true;
+		os_event_init(&entry->decoded, OS_EVENT_TYPE_MANUAL);
+		da_push_back(cache.entries, &entry);
+		decode = true;
+		cache.misses++;
+	} else {
+		cache.hits++;
+	}
+	entry->refs++;
+	entry->last_used = ++cache.use_counter;
+	pthread_mutex_unlock(&cache.mutex);
+
+	free_entries(&replaced);
+
+	/* if another worker is already decoding this image, wait for it
+	 * instead of decoding it a second time */
+	if (decode)
+		decode_entry(entry);
+	else
+		os_event_wait(entry->decoded);
+
+	if (entry->failed) {
+		image_cache_release(entry);
+		return NULL;
+	}
+
+	return entry;
+}
+
+struct image_cache_entry *image_cache_get(const char *path, enum gs_image_alpha_mode alpha_mode)
+{
+	return get_entry(path, alpha_mode, false);
+}
+
+struct image_cache_entry *image_cache_reload(const char *path, enum gs_image_alpha_mode alpha_mode)
+{
+	return get_entry(path, alpha_mode, true);
+}
+
+void image_cache_release(struct image_cache_entry *entry)
+{
+	entry_list_t evicted = {0};
+
+	if (!entry)
+		return;
+
+	pthread_mutex_lock(&cache.mutex);
+	if (--entry->refs == 0) {
+		if (entry->cached)
+			evict_entries(&evicted);
+		else
+			da_push_back(evicted, &entry);
+	}
+	pthread_mutex_unlock(&cache.mutex);
+
+	free_entries(&evicted);
+}
+
+void image_cache_entry_get_info(const struct image_cache_entry *entry, enum gs_color_format *format, uint32_t *cx,
+				uint32_t *cy, enum gs_color_space *space)
+{
+	*format = entry->format;
+	*cx = entry->cx;
+	*cy = entry->cy;
+	*space = entry->space;
+}
+
+size_t image_cache_entry_get_size(const struct image_cache_entry *entry)
+{
+	return entry->size;
+}
+
+gs_texture_t *image_cache_entry_get_texture(const struct image_cache_entry *entry)
+{
+	return entry->texture;
+}
+
+gs_texture_t *image_cache_entry_create_texture(struct image_cache_entry *entry)
+{
+	if (!entry->texture && entry->data) {
+		entry->texture =
+			gs_texture_create(entry->cx, entry->cy, entry->format, 1, (const uint8_t **)&entry->data, 0);
+		bfree(entry->data);
+		entry->data = NULL;
+	}
+
+	return entry->texture;
+}
+
+void image_cache_set_memory_limit(size_t limit)
+{
+	entry_list_t evicted = {0};
+
+	pthread_mutex_lock(&cache.mutex);
+	cache.memory_limit = limit;
+	evict_entries(&evicted);
+	pthread_mutex_unlock(&cache.mutex);
+
+	free_entries(&evicted);
+}
+
+void image_cache_get_stats(struct image_cache_stats *stats)
+{
+	pthread_mutex_lock(&cache.mutex);
+	stats->hits = cache.hits;
+	stats->misses = cache.misses;
+	stats->evictions = cache.evictions;
+	stats->entries = cache.entries.num;
+	stats->mem_usage = cache.mem_usage;
+	stats->memory_limit = cache.memory_limit;
+	pthread_mutex_unlock(&cache.mutex);
+}
+
+bool image_cache_reserve_upload(size_t size)
+{
+	uint64_t frame_time = obs_get_video_frame_time();
+	bool reserved = true;
+
+	pthread_mutex_lock(&cache.mutex);
+	if (cache.upload_frame_time != frame_time) {
+		cache.upload_frame_time = frame_time;
+		cache.upload_size = 0;
+	}
+
+	if (cache.upload_size && cache.upload_size + size > UPLOAD_BUDGET_PER_FRAME)
+		reserved = false;
+	else
+		cache.upload_size += size;
+	pthread_mutex_unlock(&cache.mutex);
+
+	return reserved;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <graphics/graphics.h>
+#include <util/task.h>
+
+/*
+ * Still images shared by all image sources (including slideshow slides),
+ * keyed by path, modification time, file size and alpha mode.  Each image is
+ * decoded once on a small pool of worker threads, and all sources using it
+ * share a single texture, created on the graphics thread a limited amount per
+ * frame.
+ *
+ * Images no source references anymore stay cached until the cache exceeds
+ * its memory limit, then the least recently used ones are evicted.
+ */
+
+struct image_cache_entry;
+
+struct image_cache_stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	size_t entries;
+	size_t mem_usage;
+	size_t memory_limit;
+};
+
+extern void image_cache_init(void);
+extern void image_cache_free(void);
+
+/* runs a task on one of the decode workers */
+extern void image_cache_queue_task(os_task_t task, void *param);
+
+/* returns the decoded image, decoding it if it isn't cached yet (blocks, so
+ * call from a decode worker).  returns NULL if the file can't be decoded. */
+extern struct image_cache_entry *image_cache_get(const char *path, enum gs_image_alpha_mode alpha_mode);
+/* same as image_cache_get, but always decodes the file again, replacing any
+ * cached image of it.  for files that are known to have changed. */
+extern struct image_cache_entry *image_cache_reload(const char *path, enum gs_image_alpha_mode alpha_mode);
+extern void image_cache_release(struct image_cache_entry *entry);
+
+extern void image_cache_entry_get_info(const struct image_cache_entry *entry, enum gs_color_format *format,
+				       uint32_t *cx, uint32_t *cy, enum gs_color_space *space);
+extern size_t image_cache_entry_get_size(const struct image_cache_entry *entry);
+
+/* graphics thread only.  the texture belongs to the entry, and stays valid
+ * for as long as the entry is referenced. */
+extern gs_texture_t *image_cache_entry_get_texture(const struct image_cache_entry *entry);
+extern gs_texture_t *image_cache_entry_create_texture(struct image_cache_entry *entry);
+
+/* reserves part of the current frame's texture upload budget, returns false
+ * if the upload should wait until the next frame.  the first upload of a
+ * frame is always allowed, so images larger than the budget still load. */
+extern bool image_cache_reserve_upload(size_t size);
+
+extern void image_cache_set_memory_limit(size_t limit);
+extern void image_cache_get_stats(struct image_cache_stats *stats);
@@ -3,7 +3,8 @@
 #include <util/threading.h>
 #include <util/platform.h>
 #include <util/dstr.h>
-#include <sys/stat.h>
+
+#include "image-cache.h"
 
 #define blog(log_level, format, ...) \
 	blog(log_level, "[image_source: '%s'] " format, obs_source_get_name(context->source), ##__VA_ARGS__)
@@ -19,24 +20,43 @@ struct image_source {
 	bool persistent;
 	bool is_slide;
 	bool linear_alpha;
-	time_t file_timestamp;
-	float update_time_elapsed;
 	uint64_t last_time;
 	bool active;
 	bool restart_gif;
 	volatile bool file_decoded;
 	volatile bool texture_loaded;
 
+	/* images are decoded on the image cache workers.  load_id changes
+	 * every time the image is unloaded so decodes that finish after that
+	 * are thrown away. */
+	pthread_mutex_t load_mutex;
+	long load_id;
 	gs_image_file4_t if4;
+	struct image_cache_entry *entry;
+
+	/* decoded on the image cache workers when the file changes, swapped
+	 * in on the next tick.  reload_id changes with every change and every
+	 * discard, only the decode of the latest change is kept. */
+	os_file_watch_t *watch;
+	pthread_mutex_t reload_mutex;
+	long reload_id;
+	gs_image_file4_t reload_if4;
+	struct image_cache_entry *reload_entry;
+	volatile bool reload_ready;
 };
 
-static time_t get_modified_timestamp(const char *filename)
-{
-	struct stat stats;
-	if (os_stat(filename, &stats) != 0)
-		return -1;
-	return stats.st_mtime;
-}
+struct decode_job {
+	obs_weak_source_t *weak;
+	struct image_source *context;
+};
+
+struct reload_job {
+	obs_weak_source_t *weak;
+	struct image_source *context;
+	char *file;
+	enum gs_image_alpha_mode alpha_mode;
+	long reload_id;
+};
 
 static const char *image_source_get_name(void *unused)
 {
@@ -44,57 +64,293 @@ static const char *image_source_get_name(void *unused)
 	return obs_module_text("ImageInput");
 }
 
-void image_source_preload_image(void *data)
+static inline enum gs_image_alpha_mode get_alpha_mode(struct image_source *context)
 {
-	struct image_source *context = data;
-	if (os_atomic_load_bool(&context->file_decoded))
+	return context->linear_alpha ? GS_IMAGE_ALPHA_PREMULTIPLY_SRGB : GS_IMAGE_ALPHA_PREMULTIPLY;
+}
+
+static inline bool is_gif(const char *file)
+{
+	size_t len = strlen(file);
+	return len > 4 && astrcmpi(file + len - 4, ".gif") == 0;
+}
+
+/* still images come from the image cache, in which case entry is set, and
+ * the texture is shared with every other source showing the same image.
+ * gifs are decoded per source because they're animated. */
+static void image_source_decode(const char *file, enum gs_image_alpha_mode alpha_mode, bool reload,
+				gs_image_file4_t *if4, struct image_cache_entry **entry)
+{
+	*entry = NULL;
+
+	if (is_gif(file)) {
+		gs_image_file4_init(if4, file, alpha_mode);
 		return;
+	}
 
-	context->file_timestamp = get_modified_timestamp(context->file);
-	gs_image_file4_init(&context->if4, context->file,
-			    context->linear_alpha ? GS_IMAGE_ALPHA_PREMULTIPLY_SRGB : GS_IMAGE_ALPHA_PREMULTIPLY);
-	os_atomic_set_bool(&context->file_decoded, true);
+	memset(if4, 0, sizeof(*if4));
+	*entry = reload ? image_cache_reload(file, alpha_mode) : image_cache_get(file, alpha_mode);
+	if (*entry) {
+		struct gs_image_file *image = &if4->image3.image2.image;
+
+		image_cache_entry_get_info(*entry, &image->format, &image->cx, &image->cy, &if4->space);
+		image->loaded = true;
+		if4->image3.image2.mem_usage = image_cache_entry_get_size(*entry);
+		if4->image3.alpha_mode = alpha_mode;
+	}
+}
+
+static void image_source_free_image(gs_image_file4_t *if4, struct image_cache_entry *entry)
+{
+	image_cache_release(entry);
+
+	obs_enter_graphics();
+	gs_image_file4_free(if4);
+	obs_leave_graphics();
 }
 
-static void image_source_load_texture(void *data)
+void image_source_preload_image(void *data)
 {
 	struct image_source *context = data;
-	if (os_atomic_load_bool(&context->texture_loaded))
+	enum gs_image_alpha_mode alpha_mode;
+	struct image_cache_entry *entry;
+	gs_image_file4_t if4;
+	long load_id;
+	char *file;
+	bool stale;
+
+	pthread_mutex_lock(&context->load_mutex);
+	if (os_atomic_load_bool(&context->file_decoded) || !context->file || !*context->file) {
+		pthread_mutex_unlock(&context->load_mutex);
 		return;
+	}
+
+	load_id = context->load_id;
+	file = bstrdup(context->file);
+	alpha_mode = get_alpha_mode(context);
+	pthread_mutex_unlock(&context->load_mutex);
+
+	image_source_decode(file, alpha_mode, false, &if4, &entry);
+	bfree(file);
+
+	pthread_mutex_lock(&context->load_mutex);
+	stale = load_id != context->load_id || os_atomic_load_bool(&context->file_decoded);
+	if (!stale) {
+		context->if4 = if4;
+		context->entry = entry;
+		os_atomic_set_bool(&context->file_decoded, true);
+	}
+	pthread_mutex_unlock(&context->load_mutex);
+
+	if (stale)
+		image_source_free_image(&if4, entry);
+}
+
+static void decode_task(void *param)
+{
+	struct decode_job *job = param;
+
+	obs_source_t *source = obs_weak_source_get_source(job->weak);
+	if (source) {
+		image_source_preload_image(job->context);
+		obs_source_release(source);
+	}
+
+	obs_weak_source_release(job->weak);
+	bfree(job);
+}
+
+static inline gs_texture_t *get_texture(struct image_source *context)
+{
+	return context->entry ? image_cache_entry_get_texture(context->entry)
+			      : context->if4.image3.image2.image.texture;
+}
+
+/* returns false if the texture has to wait for the upload budget of a later
+ * frame */
+static bool image_source_load_texture(struct image_source *context)
+{
+	struct gs_image_file *image = &context->if4.image3.image2.image;
+	bool upload;
+	bool loaded = false;
+
+	pthread_mutex_lock(&context->load_mutex);
+	if (!os_atomic_load_bool(&context->file_decoded) || os_atomic_load_bool(&context->texture_loaded)) {
+		loaded = os_atomic_load_bool(&context->texture_loaded);
+		goto unlock;
+	}
+
+	/* images another source already uploaded are free */
+	upload = !context->entry || !image_cache_entry_get_texture(context->entry);
+	if (upload && !image_cache_reserve_upload((size_t)context->if4.image3.image2.mem_usage))
+		goto unlock;
 
 	debug("loading texture '%s'", context->file);
 
 	obs_enter_graphics();
-	gs_image_file4_init_texture(&context->if4);
+	if (context->entry)
+		image_cache_entry_create_texture(context->entry);
+	else
+		gs_image_file4_init_texture(&context->if4);
 	obs_leave_graphics();
 
-	if (!context->if4.image3.image2.image.loaded)
+	if (!image->loaded || !get_texture(context))
 		warn("failed to load texture '%s'", context->file);
-	context->update_time_elapsed = 0;
 	os_atomic_set_bool(&context->texture_loaded, true);
+	loaded = true;
+
+unlock:
+	pthread_mutex_unlock(&context->load_mutex);
+	return loaded;
 }
 
 static void image_source_unload(void *data)
 {
 	struct image_source *context = data;
+	struct image_cache_entry *entry;
+	gs_image_file4_t if4;
+
+	pthread_mutex_lock(&context->load_mutex);
+	context->load_id++;
 	os_atomic_set_bool(&context->file_decoded, false);
 	os_atomic_set_bool(&context->texture_loaded, false);
 
-	obs_enter_graphics();
-	gs_image_file4_free(&context->if4);
-	obs_leave_graphics();
+	if4 = context->if4;
+	entry = context->entry;
+	memset(&context->if4, 0, sizeof(context->if4));
+	context->entry = NULL;
+	pthread_mutex_unlock(&context->load_mutex);
+
+	image_source_free_image(&if4, entry);
 }
 
+static void image_source_discard_reload(struct image_source *context);
+
 static void image_source_load(struct image_source *context)
 {
+	image_source_discard_reload(context);
 	image_source_unload(context);
 
 	if (context->file && *context->file) {
-		image_source_preload_image(context);
-		image_source_load_texture(context);
+		struct decode_job *job = bmalloc(sizeof(*job));
+		job->weak = obs_source_get_weak_source(context->source);
+		job->context = context;
+		image_cache_queue_task(decode_task, job);
 	}
 }
 
+static void reload_task(void *param)
+{
+	struct reload_job *job = param;
+	struct image_source *context = job->context;
+	struct image_cache_entry *entry;
+	gs_image_file4_t if4;
+	bool stale;
+
+	obs_source_t *source = obs_weak_source_get_source(job->weak);
+	if (!source)
+		goto free;
+
+	image_source_decode(job->file, job->alpha_mode, true, &if4, &entry);
+
+	pthread_mutex_lock(&context->reload_mutex);
+	stale = job->reload_id != context->reload_id;
+	if (!stale) {
+		if (context->reload_ready)
+			image_source_free_image(&context->reload_if4, context->reload_entry);
+		context->reload_if4 = if4;
+		context->reload_entry = entry;
+		os_atomic_set_bool(&context->reload_ready, true);
+	}
+	pthread_mutex_unlock(&context->reload_mutex);
+
+	if (stale)
+		image_source_free_image(&if4, entry);
+
+	obs_source_release(source);
+
+free:
+	obs_weak_source_release(job->weak);
+	bfree(job->file);
+	bfree(job);
+}
+
+/* called on the file watcher thread, which is shared by every watched file,
+ * so decoding is left to the image cache workers */
+static void image_source_file_changed(void *data, const char *path)
+{
+	struct image_source *context = data;
+	struct reload_job *job;
+
+	/* sources that aren't loaded pick up the new file when they are */
+	if (!os_atomic_load_bool(&context->file_decoded))
+		return;
+
+	debug("'%s' changed, reloading", path);
+
+	job = bmalloc(sizeof(*job));
+	job->weak = obs_source_get_weak_source(context->source);
+	job->context = context;
+	job->file = bstrdup(path);
+
+	pthread_mutex_lock(&context->load_mutex);
+	job->alpha_mode = get_alpha_mode(context);
+	pthread_mutex_unlock(&context->load_mutex);
+
+	pthread_mutex_lock(&context->reload_mutex);
+	job->reload_id = ++context->reload_id;
+	pthread_mutex_unlock(&context->reload_mutex);
+
+	image_cache_queue_task(reload_task, job);
+}
+
+static void image_source_apply_reload(struct image_source *context)
+{
+	struct image_cache_entry *entry;
+	gs_image_file4_t if4;
+
+	pthread_mutex_lock(&context->reload_mutex);
+	if4 = context->reload_if4;
+	entry = context->reload_entry;
+	memset(&context->reload_if4, 0, sizeof(context->reload_if4));
+	context->reload_entry = NULL;
+	os_atomic_set_bool(&context->reload_ready, false);
+	pthread_mutex_unlock(&context->reload_mutex);
+
+	image_source_unload(context);
+
+	pthread_mutex_lock(&context->load_mutex);
+	context->if4 = if4;
+	context->entry = entry;
+	os_atomic_set_bool(&context->file_decoded, true);
+	pthread_mutex_unlock(&context->load_mutex);
+}
+
+static void image_source_discard_reload(struct image_source *context)
+{
+	pthread_mutex_lock(&context->reload_mutex);
+	context->reload_id++;
+	if (context->reload_ready) {
+		image_source_free_image(&context->reload_if4, context->reload_entry);
+		context->reload_entry = NULL;
+		os_atomic_set_bool(&context->reload_ready, false);
+	}
+	pthread_mutex_unlock(&context->reload_mutex);
+}
+
+static void image_source_watch_file(struct image_source *context, const char *file)
+{
+	if (context->file && strcmp(context->file, file) == 0)
+		return;
+
+	obs_unwatch_file(context->watch);
+	context->watch = NULL;
+	image_source_discard_reload(context);
+
+	if (*file)
+		context->watch = obs_watch_file(file, image_source_file_changed, context);
+}
+
 static void image_source_update(void *data, obs_data_t *settings)
 {
 	struct image_source *context = data;
@@ -103,11 +359,15 @@ static void image_source_update(void *data, obs_data_t *settings)
 	const bool linear_alpha = obs_data_get_bool(settings, "linear_alpha");
 	const bool is_slide = obs_data_get_bool(settings, "is_slide");
 
+	image_source_watch_file(context, file);
+
+	pthread_mutex_lock(&context->load_mutex);
 	if (context->file)
 		bfree(context->file);
 	context->file = bstrdup(file);
-	context->persistent = !unload;
 	context->linear_alpha = linear_alpha;
+	pthread_mutex_unlock(&context->load_mutex);
+	context->persistent = !unload;
 	context->is_slide = is_slide;
 
 	if (is_slide)
@@ -169,6 +429,8 @@ static void *image_source_create(obs_data_t *settings, obs_source_t *source)
 {
 	struct image_source *context = bzalloc(sizeof(struct image_source));
 	context->source = source;
+	pthread_mutex_init(&context->load_mutex, NULL);
+	pthread_mutex_init(&context->reload_mutex, NULL);
 
 	image_source_update(context, settings);
 	return context;
@@ -178,8 +440,12 @@ static void image_source_destroy(void *data)
 {
 	struct image_source *context = data;
 
+	obs_unwatch_file(context->watch);
+	image_source_discard_reload(context);
 	image_source_unload(context);
 
+	pthread_mutex_destroy(&context->load_mutex);
+	pthread_mutex_destroy(&context->reload_mutex);
 	if (context->file)
 		bfree(context->file);
 	bfree(context);
@@ -197,16 +463,22 @@ static uint32_t image_source_getheight(void *data)
 	return context->if4.image3.image2.image.cy;
 }
 
+/* the image can be unloaded from the UI thread, so render and tick hold the
+ * load mutex for as long as they use it */
 static void image_source_render(void *data, gs_effect_t *effect)
 {
 	struct image_source *context = data;
 	if (!os_atomic_load_bool(&context->texture_loaded))
 		return;
 
+	pthread_mutex_lock(&context->load_mutex);
+
 	struct gs_image_file *const image = &context->if4.image3.image2.image;
-	gs_texture_t *const texture = image->texture;
-	if (!texture)
+	gs_texture_t *const texture = get_texture(context);
+	if (!texture) {
+		pthread_mutex_unlock(&context->load_mutex);
 		return;
+	}
 
 	const bool previous = gs_framebuffer_srgb_enabled();
 	gs_enable_framebuffer_srgb(true);
@@ -222,32 +494,25 @@ static void image_source_render(void *data, gs_effect_t *effect)
 	gs_blend_state_pop();
 
 	gs_enable_framebuffer_srgb(previous);
+
+	pthread_mutex_unlock(&context->load_mutex);
 }
 
 static void image_source_tick(void *data, float seconds)
 {
 	struct image_source *context = data;
-	if (!os_atomic_load_bool(&context->texture_loaded)) {
-		if (os_atomic_load_bool(&context->file_decoded))
-			image_source_load_texture(context);
-		else
-			return;
-	}
 
-	uint64_t frame_time = obs_get_video_frame_time();
+	UNUSED_PARAMETER(seconds);
 
-	context->update_time_elapsed += seconds;
+	if (os_atomic_load_bool(&context->reload_ready))
+		image_source_apply_reload(context);
 
-	if (obs_source_showing(context->source)) {
-		if (context->update_time_elapsed >= 1.0f) {
-			time_t t = get_modified_timestamp(context->file);
-			context->update_time_elapsed = 0.0f;
+	if (!os_atomic_load_bool(&context->texture_loaded) && !image_source_load_texture(context))
+		return;
 
-			if (context->file_timestamp != t) {
-				image_source_load(context);
-			}
-		}
-	}
+	uint64_t frame_time = obs_get_video_frame_time();
+
+	pthread_mutex_lock(&context->load_mutex);
 
 	if (obs_source_showing(context->source)) {
 		if (!context->active) {
@@ -265,7 +530,7 @@ static void image_source_tick(void *data, float seconds)
 			context->active = false;
 		}
 
-		return;
+		goto unlock;
 	}
 
 	if (context->last_time && context->if4.image3.image2.image.is_animated_gif) {
@@ -280,6 +545,9 @@ static void image_source_tick(void *data, float seconds)
 	}
 
 	context->last_time = frame_time;
+
+unlock:
+	pthread_mutex_unlock(&context->load_mutex);
 }
 
 static const char *image_filter =
@@ -356,14 +624,19 @@ static enum gs_color_space image_source_get_color_space(void *data, size_t count
 	UNUSED_PARAMETER(preferred_spaces);
 
 	struct image_source *const s = data;
-	gs_image_file4_t *const if4 = &s->if4;
-	return if4->image3.image2.image.texture ? if4->space : GS_CS_SRGB;
+	enum gs_color_space space;
+
+	pthread_mutex_lock(&s->load_mutex);
+	space = get_texture(s) ? s->if4.space : GS_CS_SRGB;
+	pthread_mutex_unlock(&s->load_mutex);
+
+	return space;
 }
 
 static struct obs_source_info image_source_info = {
 	.id = "image_source",
 	.type = OBS_SOURCE_TYPE_INPUT,
-	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_SRGB,
+	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_SRGB | OBS_SOURCE_CAP_PARALLEL_CREATE,
 	.get_name = image_source_get_name,
 	.create = image_source_create,
 	.destroy = image_source_destroy,
@@ -395,8 +668,43 @@ extern struct obs_source_info color_source_info_v1;
 extern struct obs_source_info color_source_info_v2;
 extern struct obs_source_info color_source_info_v3;
 
+static void set_memory_limit_proc(void *unused, calldata_t *cd)
+{
+	long long megabytes = calldata_int(cd, "megabytes");
+	if (megabytes < 0)
+		megabytes = 0;
+
+	image_cache_set_memory_limit((size_t)megabytes * 1024 * 1024);
+
+	UNUSED_PARAMETER(unused);
+}
+
+static void get_stats_proc(void *unused, calldata_t *cd)
+{
+	struct image_cache_stats stats;
+	image_cache_get_stats(&stats);
+
+	calldata_set_int(cd, "hits", (long long)stats.hits);
+	calldata_set_int(cd, "misses", (long long)stats.misses);
+	calldata_set_int(cd, "evictions", (long long)stats.evictions);
+	calldata_set_int(cd, "images", (long long)stats.entries);
+	calldata_set_int(cd, "memory_usage", (long long)stats.mem_usage);
+	calldata_set_int(cd, "memory_limit", (long long)stats.memory_limit);
+
+	UNUSED_PARAMETER(unused);
+}
+
 bool obs_module_load(void)
 {
+	image_cache_init();
+
+	proc_handler_t *ph = obs_get_proc_handler();
+	proc_handler_add(ph, "void image_cache_set_memory_limit(int megabytes)", set_memory_limit_proc, NULL);
+	proc_handler_add(ph,
+			 "void image_cache_get_stats(out int hits, out int misses, out int evictions, "
+			 "out int images, out int memory_usage, out int memory_limit)",
+			 get_stats_proc, NULL);
+
 	obs_register_source(&image_source_info);
 	obs_register_source(&color_source_info_v1);
 	obs_register_source(&color_source_info_v2);
@@ -405,3 +713,8 @@ bool obs_module_load(void)
 	obs_register_source(&slideshow_info_mk2);
 	return true;
 }
+
+void obs_module_unload(void)
+{
+	image_cache_free();
+}
@@ -783,6 +783,8 @@ static inline bool ss_audio_render_(obs_source_t *transition, uint64_t *ts_out,
 		return false;
 
 	obs_source_get_audio_mix(transition, &child_audio);
+	uint32_t frames = audio_output_get_output_frames(obs_get_audio());
+
 	for (size_t mix = 0; mix < MAX_AUDIO_MIXES; mix++) {
 		if ((mixers & (1 << mix)) == 0)
 			continue;
@@ -791,7 +793,7 @@ static inline bool ss_audio_render_(obs_source_t *transition, uint64_t *ts_out,
 			float *out = audio_output->output[mix].data[ch];
 			float *in = child_audio.output[mix].data[ch];
 
-			memcpy(out, in, AUDIO_OUTPUT_FRAMES * sizeof(float));
+			memcpy(out, in, frames * sizeof(float));
 		}
 	}
 
@@ -1044,7 +1046,7 @@ struct obs_source_info slideshow_info = {
 	.id = "slideshow",
 	.type = OBS_SOURCE_TYPE_INPUT,
 	.output_flags = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW | OBS_SOURCE_COMPOSITE |
-			OBS_SOURCE_CONTROLLABLE_MEDIA | OBS_SOURCE_CAP_OBSOLETE,
+			OBS_SOURCE_CONTROLLABLE_MEDIA | OBS_SOURCE_CAP_OBSOLETE | OBS_SOURCE_CAP_PARALLEL_CREATE,
 	.get_name = ss_getname,
 	.create = ss_create,
 	.destroy = ss_destroy,
@@ -24,6 +24,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define blog(level, msg, ...) blog(level, "jack-input: " msg, ##__VA_ARGS__)
 
+/* how much audio can be queued up for the capture thread */
+#define RING_BUFFER_MS 500
+#define MAX_PACKETS 256
+
+struct jack_packet {
+	uint64_t timestamp;
+	uint32_t frames;
+	uint32_t samples_per_sec;
+	bool guessed_timestamp;
+};
+
 /**
  * Get obs speaker layout from number of channels
  *
@@ -58,6 +69,11 @@ static enum speaker_layout jack_channels_to_obs_speakers(uint_fast32_t channels)
 	return SPEAKERS_UNKNOWN;
 }
 
+/**
+ * Runs in the realtime thread of JACK, so it must not block or allocate: the
+ * audio is only copied into the rings for the capture thread, and dropped if
+ * the capture thread fell too far behind.
+ */
 int jack_process_callback(jack_nframes_t nframes, void *arg)
 {
 	struct jack_data *data = (struct jack_data *)arg;
@@ -70,30 +86,216 @@ int jack_process_callback(jack_nframes_t nframes, void *arg)
 	if (data == 0)
 		return 0;
 
-	struct obs_source_audio out;
-	out.speakers = jack_channels_to_obs_speakers(data->channels);
-	out.samples_per_sec = jack_get_sample_rate(data->jack_client);
-	/* format is always 32 bit float for jack */
-	out.format = AUDIO_FORMAT_FLOAT_PLANAR;
+	struct jack_packet packet = {
+		.frames = nframes,
+		.samples_per_sec = jack_get_sample_rate(data->jack_client),
+	};
+
+	if (!jack_get_cycle_times(data->jack_client, &current_frames, &current_usecs, &next_usecs, &period_usecs)) {
+		packet.timestamp = now - (int64_t)(period_usecs * 1000);
+	} else {
+		packet.timestamp = now - util_mul_div64(nframes, 1000000000ULL, packet.samples_per_sec);
+		packet.guessed_timestamp = true;
+	}
+
+	size_t size = nframes * sizeof(float);
+	bool fits = jack_ringbuffer_write_space(data->packet_ring) >= sizeof(packet);
+	for (unsigned int i = 0; fits && i < data->channels; ++i)
+		fits = jack_ringbuffer_write_space(data->rings[i]) >= size;
+
+	if (!fits) {
+		os_atomic_inc_long(&data->dropped_packets);
+		return 0;
+	}
 
 	for (unsigned int i = 0; i < data->channels; ++i) {
 		jack_default_audio_sample_t *jack_buffer =
 			(jack_default_audio_sample_t *)jack_port_get_buffer(data->jack_ports[i], nframes);
-		out.data[i] = (uint8_t *)jack_buffer;
+		jack_ringbuffer_write(data->rings[i], (const char *)jack_buffer, size);
 	}
 
-	out.frames = nframes;
-	if (!jack_get_cycle_times(data->jack_client, &current_frames, &current_usecs, &next_usecs, &period_usecs)) {
-		out.timestamp = now - (int64_t)(period_usecs * 1000);
-	} else {
-		out.timestamp = now - util_mul_div64(nframes, 1000000000ULL, data->samples_per_sec);
-		blog(LOG_WARNING, "jack_get_cycle_times error: guessing timestamp");
+	/* the packet info goes in last, once its audio is there to be read */
+	jack_ringbuffer_write(data->packet_ring, (const char *)&packet, sizeof(packet));
+	os_sem_post(data->capture_sem);
+	return 0;
+}
+
+static int jack_xrun_callback(void *arg)
+{
+	struct jack_data *data = (struct jack_data *)arg;
+
+	os_atomic_inc_long(&data->xruns);
+	return 0;
+}
+
+/**
+ * Adds the time from the audio arriving at each port until it was handed to
+ * libobs, including the capture latency of whatever is connected to the port
+ */
+static void update_port_stats(struct jack_data *data, const struct jack_packet *packet)
+{
+	uint64_t handoff = os_gettime_ns() - packet->timestamp;
+
+	for (unsigned int i = 0; i < data->channels; ++i) {
+		struct jack_port_stats *stats = &data->port_stats[i];
+		jack_latency_range_t range;
+
+		jack_port_get_latency_range(data->jack_ports[i], JackCaptureLatency, &range);
+
+		uint64_t latency = handoff + util_mul_div64(range.max, 1000000000ULL, packet->samples_per_sec);
+		stats->packets++;
+		stats->latency_total_ns += latency;
+		if (latency > stats->latency_max_ns)
+			stats->latency_max_ns = latency;
+	}
+}
+
+static void output_packet(struct jack_data *data, const struct jack_packet *packet)
+{
+	size_t size = packet->frames * sizeof(float);
+
+	if (packet->frames > data->capture_buffer_frames) {
+		for (unsigned int i = 0; i < data->channels; ++i) {
+			bfree(data->capture_buffers[i]);
+			data->capture_buffers[i] = bmalloc(size);
+		}
+		data->capture_buffer_frames = packet->frames;
+	}
+
+	struct obs_source_audio out = {
+		.speakers = jack_channels_to_obs_speakers(data->channels),
+		.samples_per_sec = packet->samples_per_sec,
+		/* format is always 32 bit float for jack */
+		.format = AUDIO_FORMAT_FLOAT_PLANAR,
+		.frames = packet->frames,
+		.timestamp = packet->timestamp,
+	};
+
+	for (unsigned int i = 0; i < data->channels; ++i) {
+		jack_ringbuffer_read(data->rings[i], (char *)data->capture_buffers[i], size);
+		out.data[i] = (uint8_t *)data->capture_buffers[i];
 	}
 
-	/* FIXME: this function is not realtime-safe, we should do something
-	 * about this */
 	obs_source_output_audio(data->source, &out);
-	return 0;
+	update_port_stats(data, packet);
+}
+
+static void *capture_thread(void *vptr)
+{
+	struct jack_data *data = (struct jack_data *)vptr;
+	bool warned = false;
+
+	os_set_thread_name("jack-input: capture thread");
+
+	while (os_sem_wait(data->capture_sem) == 0) {
+		if (os_atomic_load_bool(&data->capture_stop))
+			break;
+
+		struct jack_packet packet;
+		if (jack_ringbuffer_read_space(data->packet_ring) < sizeof(packet))
+			continue;
+		jack_ringbuffer_read(data->packet_ring, (char *)&packet, sizeof(packet));
+
+		if (packet.guessed_timestamp && !warned) {
+			blog(LOG_WARNING, "jack_get_cycle_times error: guessing timestamp");
+			warned = true;
+		}
+
+		output_packet(data, &packet);
+	}
+
+	return NULL;
+}
+
+static bool init_capture(struct jack_data *data)
+{
+	size_t ring_size = jack_get_sample_rate(data->jack_client) * RING_BUFFER_MS / 1000 * sizeof(float);
+
+	data->rings = (jack_ringbuffer_t **)bzalloc(sizeof(jack_ringbuffer_t *) * data->channels);
+	for (unsigned int i = 0; i < data->channels; ++i) {
+		data->rings[i] = jack_ringbuffer_create(ring_size);
+		if (!data->rings[i])
+			return false;
+		jack_ringbuffer_mlock(data->rings[i]);
+	}
+
+	data->packet_ring = jack_ringbuffer_create(MAX_PACKETS * sizeof(struct jack_packet));
+	if (!data->packet_ring)
+		return false;
+	jack_ringbuffer_mlock(data->packet_ring);
+
+	data->port_stats = bzalloc(sizeof(struct jack_port_stats) * data->channels);
+	os_atomic_set_long(&data->xruns, 0);
+	os_atomic_set_long(&data->dropped_packets, 0);
+
+	if (os_sem_init(&data->capture_sem, 0) != 0)
+		return false;
+
+	os_atomic_set_bool(&data->capture_stop, false);
+	if (pthread_create(&data->capture_thread, NULL, capture_thread, data) != 0)
+		return false;
+
+	data->capture_thread_active = true;
+	return true;
+}
+
+static void stop_capture(struct jack_data *data)
+{
+	if (!data->capture_thread_active)
+		return;
+
+	os_atomic_set_bool(&data->capture_stop, true);
+	os_sem_post(data->capture_sem);
+	pthread_join(data->capture_thread, NULL);
+	data->capture_thread_active = false;
+}
+
+static void log_stats(struct jack_data *data)
+{
+	if (!data->port_stats)
+		return;
+
+	blog(LOG_INFO, "'%s': %ld xruns, %ld packets dropped", obs_source_get_name(data->source),
+	     os_atomic_load_long(&data->xruns), os_atomic_load_long(&data->dropped_packets));
+
+	for (unsigned int i = 0; i < data->channels; ++i) {
+		const struct jack_port_stats *stats = &data->port_stats[i];
+		if (!stats->packets)
+			continue;
+
+		blog(LOG_INFO, "'%s' in_%u: %.2f ms average latency, %.2f ms max", obs_source_get_name(data->source),
+		     i + 1, (double)(stats->latency_total_ns / stats->packets) / 1000000.0,
+		     (double)stats->latency_max_ns / 1000000.0);
+	}
+}
+
+static void free_capture(struct jack_data *data)
+{
+	if (data->rings) {
+		for (unsigned int i = 0; i < data->channels; ++i) {
+			if (data->rings[i])
+				jack_ringbuffer_free(data->rings[i]);
+		}
+		bfree(data->rings);
+		data->rings = NULL;
+	}
+
+	if (data->packet_ring) {
+		jack_ringbuffer_free(data->packet_ring);
+		data->packet_ring = NULL;
+	}
+
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		bfree(data->capture_buffers[i]);
+		data->capture_buffers[i] = NULL;
+	}
+	data->capture_buffer_frames = 0;
+
+	os_sem_destroy(data->capture_sem);
+	data->capture_sem = NULL;
+
+	bfree(data->port_stats);
+	data->port_stats = NULL;
 }
 
 int_fast32_t jack_init(struct jack_data *data)
@@ -130,11 +332,19 @@ int_fast32_t jack_init(struct jack_data *data)
 		}
 	}
 
+	if (!init_capture(data)) {
+		blog(LOG_ERROR, "Could not start capture thread");
+		goto error;
+	}
+
 	if (jack_set_process_callback(data->jack_client, jack_process_callback, data) != 0) {
 		blog(LOG_ERROR, "jack_set_process_callback Error");
 		goto error;
 	}
 
+	if (jack_set_xrun_callback(data->jack_client, jack_xrun_callback, data) != 0)
+		blog(LOG_WARNING, "jack_set_xrun_callback Error");
+
 	if (jack_activate(data->jack_client) != 0) {
 		blog(LOG_ERROR, "jack_activate Error:"
 				"Could not activate JACK client!");
@@ -155,6 +365,12 @@ void deactivate_jack(struct jack_data *data)
 	pthread_mutex_lock(&data->jack_mutex);
 
 	if (data->jack_client) {
+		/* the process callback has to stop before the capture thread
+		 * and the ports go away */
+		jack_deactivate(data->jack_client);
+		stop_capture(data);
+		log_stats(data);
+
 		jack_client_close(data->jack_client);
 		if (data->jack_ports != NULL) {
 			bfree(data->jack_ports);
@@ -162,5 +378,8 @@ void deactivate_jack(struct jack_data *data)
 		}
 		data->jack_client = NULL;
 	}
+
+	stop_capture(data);
+	free_capture(data);
 	pthread_mutex_unlock(&data->jack_mutex);
 }
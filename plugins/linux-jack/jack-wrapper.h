@@ -18,9 +18,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <jack/jack.h>
+#include <jack/ringbuffer.h>
 #include <obs.h>
 #include <util/threading.h>
 
+/* how long audio captured on each port takes to get to libobs */
+struct jack_port_stats {
+	uint64_t packets;
+	uint64_t latency_total_ns;
+	uint64_t latency_max_ns;
+};
+
 struct jack_data {
 	obs_source_t *source;
 
@@ -38,6 +46,22 @@ struct jack_data {
 	jack_port_t **jack_ports;
 
 	pthread_mutex_t jack_mutex;
+
+	/* the JACK process thread only copies audio into these preallocated
+	 * lock-free rings, one per port plus one for the packet info, and the
+	 * capture thread hands it to libobs from there */
+	jack_ringbuffer_t **rings;
+	jack_ringbuffer_t *packet_ring;
+	os_sem_t *capture_sem;
+	pthread_t capture_thread;
+	bool capture_thread_active;
+	volatile bool capture_stop;
+	float *capture_buffers[MAX_AV_PLANES];
+	uint32_t capture_buffer_frames;
+
+	struct jack_port_stats *port_stats;
+	volatile long xruns;
+	volatile long dropped_packets;
 };
 
 /**
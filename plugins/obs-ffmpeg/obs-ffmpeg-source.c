@@ -41,11 +41,13 @@ struct ffmpeg_source {
 	char *input_format;
 	char *ffmpeg_options;
 	int buffering_mb;
+	int cache_budget_mb;
 	int speed_percent;
 	bool is_looping;
 	bool is_local_file;
 	bool is_hw_decoding;
 	bool full_decode;
+	bool shared_decode;
 	bool is_clear_on_media_end;
 	bool restart_on_activate;
 	bool close_when_inactive;
@@ -98,6 +100,7 @@ static bool is_local_file_modified(obs_properties_t *props, obs_property_t *prop
 	obs_property_t *input_format = obs_properties_get(props, "input_format");
 	obs_property_t *local_file = obs_properties_get(props, "local_file");
 	obs_property_t *looping = obs_properties_get(props, "looping");
+	obs_property_t *shared_decode = obs_properties_get(props, "shared_decode");
 	obs_property_t *buffering = obs_properties_get(props, "buffering_mb");
 	obs_property_t *seekable = obs_properties_get(props, "seekable");
 	obs_property_t *speed = obs_properties_get(props, "speed_percent");
@@ -107,6 +110,7 @@ static bool is_local_file_modified(obs_properties_t *props, obs_property_t *prop
 	obs_property_set_visible(buffering, !enabled);
 	obs_property_set_visible(local_file, enabled);
 	obs_property_set_visible(looping, enabled);
+	obs_property_set_visible(shared_decode, enabled);
 	obs_property_set_visible(speed, enabled);
 	obs_property_set_visible(seekable, !enabled);
 	obs_property_set_visible(reconnect_delay_sec, !enabled);
@@ -118,11 +122,13 @@ static void ffmpeg_source_defaults(obs_data_t *settings)
 {
 	obs_data_set_default_bool(settings, "is_local_file", true);
 	obs_data_set_default_bool(settings, "looping", false);
+	obs_data_set_default_bool(settings, "shared_decode", false);
 	obs_data_set_default_bool(settings, "clear_on_media_end", true);
 	obs_data_set_default_bool(settings, "restart_on_activate", true);
 	obs_data_set_default_bool(settings, "linear_alpha", false);
 	obs_data_set_default_int(settings, "reconnect_delay_sec", 10);
 	obs_data_set_default_int(settings, "buffering_mb", 2);
+	obs_data_set_default_int(settings, "cache_budget_mb", 1024);
 	obs_data_set_default_int(settings, "speed_percent", 100);
 	obs_data_set_default_bool(settings, "log_changes", true);
 }
@@ -174,6 +180,9 @@ static obs_properties_t *ffmpeg_source_getproperties(void *data)
 
 	obs_properties_add_bool(props, "looping", obs_module_text("Looping"));
 
+	prop = obs_properties_add_bool(props, "shared_decode", obs_module_text("SharedDecode"));
+	obs_property_set_long_description(prop, obs_module_text("SharedDecode.ToolTip"));
+
 	obs_properties_add_bool(props, "restart_on_activate", obs_module_text("RestartWhenActivated"));
 
 	prop = obs_properties_add_int_slider(props, "buffering_mb", obs_module_text("BufferingMB"), 0, 16, 1);
@@ -230,11 +239,14 @@ static void dump_source_info(struct ffmpeg_source *s, const char *input, const c
 		"\trestart_on_activate:     %s\n"
 		"\tclose_when_inactive:     %s\n"
 		"\tfull_decode:             %s\n"
+		"\tshared_decode:           %s\n"
+		"\tcache_budget_mb:         %d\n"
 		"\tffmpeg_options:          %s",
 		input ? input : "(null)", input_format ? input_format : "(null)", s->speed_percent,
 		s->is_looping ? "yes" : "no", s->is_linear_alpha ? "yes" : "no", s->is_hw_decoding ? "yes" : "no",
 		s->is_clear_on_media_end ? "yes" : "no", s->restart_on_activate ? "yes" : "no",
-		s->close_when_inactive ? "yes" : "no", s->full_decode ? "yes" : "no", s->ffmpeg_options);
+		s->close_when_inactive ? "yes" : "no", s->full_decode ? "yes" : "no", s->shared_decode ? "yes" : "no",
+		s->cache_budget_mb, s->ffmpeg_options);
 }
 
 static void get_frame(void *opaque, struct obs_source_frame *f)
@@ -309,6 +321,8 @@ static void ffmpeg_source_open(struct ffmpeg_source *s)
 			.reconnecting = s->reconnecting,
 			.request_preload = s->is_stinger,
 			.full_decode = s->full_decode,
+			.shared_decode = s->shared_decode && s->is_looping,
+			.cache_budget = (int64_t)s->cache_budget_mb * 1024 * 1024,
 		};
 
 		s->media = media_playback_create(&info);
@@ -384,6 +398,11 @@ static void ffmpeg_source_tick(void *data, float seconds)
 			pthread_mutex_unlock(&s->reconnect_mutex);
 		}
 	}
+
+	/* when rendering offline, the media has to be caught up with the
+	 * next frame before it is rendered, as the clock doesn't wait */
+	if (s->media && obs_offline_rendering_active())
+		media_playback_advance(s->media, obs_get_time_ns() + obs_get_frame_interval_ns());
 }
 
 #define RIST_PROTO "rist"
@@ -407,6 +426,7 @@ static void ffmpeg_source_update(void *data, obs_data_t *settings)
 	bool is_linear_alpha;
 	int speed_percent;
 	bool is_looping;
+	bool shared_decode;
 
 	bfree(s->input_format);
 
@@ -434,9 +454,11 @@ static void ffmpeg_source_update(void *data, obs_data_t *settings)
 	if (speed_percent < 1 || speed_percent > 200)
 		speed_percent = 100;
 	ffmpeg_options = obs_data_get_string(settings, "ffmpeg_options");
+	shared_decode = obs_data_get_bool(settings, "shared_decode");
 
 	/* Restart media source if these properties are changed */
 	if (s->is_hw_decoding != is_hw_decoding || s->range != range || s->speed_percent != speed_percent ||
+	    s->shared_decode != shared_decode ||
 	    (s->ffmpeg_options && strcmp(s->ffmpeg_options, ffmpeg_options) != 0))
 		should_restart_media = true;
 
@@ -456,6 +478,7 @@ static void ffmpeg_source_update(void *data, obs_data_t *settings)
 	s->input_format = input_format ? bstrdup(input_format) : NULL;
 	s->is_hw_decoding = is_hw_decoding;
 	s->full_decode = obs_data_get_bool(settings, "full_decode");
+	s->shared_decode = shared_decode;
 	s->is_clear_on_media_end = obs_data_get_bool(settings, "clear_on_media_end");
 	s->restart_on_activate = !astrcmpi_n(input, RIST_PROTO, sizeof(RIST_PROTO) - 1)
 					 ? false
@@ -464,6 +487,7 @@ static void ffmpeg_source_update(void *data, obs_data_t *settings)
 	is_linear_alpha = obs_data_get_bool(settings, "linear_alpha");
 	s->is_linear_alpha = is_linear_alpha;
 	s->buffering_mb = (int)obs_data_get_int(settings, "buffering_mb");
+	s->cache_budget_mb = (int)obs_data_get_int(settings, "cache_budget_mb");
 	s->speed_percent = speed_percent;
 	s->is_local_file = is_local_file;
 	s->seekable = obs_data_get_bool(settings, "seekable");
@@ -544,6 +568,13 @@ static void get_nb_frames(void *data, calldata_t *cd)
 	calldata_set_int(cd, "num_frames", frames);
 }
 
+static void get_memory_usage(void *data, calldata_t *cd)
+{
+	struct ffmpeg_source *s = data;
+	int64_t mem_usage = media_playback_get_memory_usage(s->media);
+	calldata_set_int(cd, "memory_usage", mem_usage);
+}
+
 static bool ffmpeg_source_play_hotkey(void *data, obs_hotkey_pair_id id, obs_hotkey_t *hotkey, bool pressed)
 {
 	UNUSED_PARAMETER(id);
@@ -627,6 +658,7 @@ static void *ffmpeg_source_create(obs_data_t *settings, obs_source_t *source)
 	proc_handler_add(ph, "void preload_first_frame()", preload_first_frame_proc, s);
 	proc_handler_add(ph, "void get_duration(out int duration)", get_duration, s);
 	proc_handler_add(ph, "void get_nb_frames(out int num_frames)", get_nb_frames, s);
+	proc_handler_add(ph, "void get_memory_usage(out int memory_usage)", get_memory_usage, s);
 
 	ffmpeg_source_update(s, settings);
 	return s;
@@ -785,7 +817,7 @@ struct obs_source_info ffmpeg_source = {
 	.id = "ffmpeg_source",
 	.type = OBS_SOURCE_TYPE_INPUT,
 	.output_flags = OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_AUDIO | OBS_SOURCE_DO_NOT_DUPLICATE |
-			OBS_SOURCE_CONTROLLABLE_MEDIA,
+			OBS_SOURCE_CONTROLLABLE_MEDIA | OBS_SOURCE_CAP_PARALLEL_CREATE,
 	.get_name = ffmpeg_source_getname,
 	.create = ffmpeg_source_create,
 	.destroy = ffmpeg_source_destroy,
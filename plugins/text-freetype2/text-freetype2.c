@@ -17,6 +17,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <obs-module.h>
 #include <util/platform.h>
+#include <util/threading.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <sys/stat.h>
@@ -215,10 +216,20 @@ static obs_properties_t *ft2_source_properties(void *unused)
 	return props;
 }
 
+static void text_file_changed(void *data, const char *path)
+{
+	struct ft2_source *srcdata = data;
+	os_atomic_set_bool(&srcdata->update_file, true);
+
+	UNUSED_PARAMETER(path);
+}
+
 static void ft2_source_destroy(void *data)
 {
 	struct ft2_source *srcdata = data;
 
+	obs_unwatch_file(srcdata->watch);
+
 	if (srcdata->font_face != NULL) {
 		FT_Done_Face(srcdata->font_face);
 		srcdata->font_face = NULL;
@@ -292,24 +303,15 @@ static void ft2_video_tick(void *data, float seconds)
 	if (!srcdata->from_file || !srcdata->text_file)
 		return;
 
-	if (os_gettime_ns() - srcdata->last_checked >= 1000000000) {
-		time_t t = get_modified_timestamp(srcdata->text_file);
-		srcdata->last_checked = os_gettime_ns();
+	if (os_atomic_load_bool(&srcdata->update_file)) {
+		os_atomic_set_bool(&srcdata->update_file, false);
 
-		if (srcdata->update_file) {
-			if (srcdata->log_mode)
-				read_from_end(srcdata, srcdata->text_file);
-			else
-				load_text_from_file(srcdata, srcdata->text_file);
-			cache_glyphs(srcdata, srcdata->text);
-			set_up_vertex_buffer(srcdata);
-			srcdata->update_file = false;
-		}
-
-		if (srcdata->m_timestamp != t) {
-			srcdata->m_timestamp = t;
-			srcdata->update_file = true;
-		}
+		if (srcdata->log_mode)
+			read_from_end(srcdata, srcdata->text_file);
+		else
+			load_text_from_file(srcdata, srcdata->text_file);
+		cache_glyphs(srcdata, srcdata->text);
+		set_up_vertex_buffer(srcdata);
 	}
 
 	UNUSED_PARAMETER(seconds);
@@ -498,13 +500,20 @@ skip_font_load:
 				read_from_end(srcdata, tmp);
 			else
 				load_text_from_file(srcdata, tmp);
-			srcdata->last_checked = os_gettime_ns();
+
+			obs_unwatch_file(srcdata->watch);
+			srcdata->watch = obs_watch_file(tmp, text_file_changed, srcdata);
 		}
 	} else {
 		const char *tmp = obs_data_get_string(settings, "text");
 		if (!tmp)
 			goto error;
 
+		obs_unwatch_file(srcdata->watch);
+		srcdata->watch = NULL;
+		bfree(srcdata->text_file);
+		srcdata->text_file = NULL;
+
 		if (srcdata->text != NULL) {
 			bfree(srcdata->text);
 			srcdata->text = NULL;
@@ -40,9 +40,8 @@ struct ft2_source {
 	bool antialiasing;
 	char *text_file;
 	wchar_t *text;
-	time_t m_timestamp;
-	bool update_file;
-	uint64_t last_checked;
+	os_file_watch_t *watch;
+	volatile bool update_file;
 
 	uint32_t cx, cy, max_h, custom_width;
 	uint32_t outline_width;
@@ -75,7 +74,6 @@ void draw_drop_shadow(struct ft2_source *srcdata);
 
 uint32_t get_ft2_text_width(wchar_t *text, struct ft2_source *srcdata);
 
-time_t get_modified_timestamp(char *filename);
 void load_text_from_file(struct ft2_source *srcdata, const char *filename);
 void read_from_end(struct ft2_source *srcdata, const char *filename);
 
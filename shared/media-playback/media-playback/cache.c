@@ -15,6 +15,7 @@
  */
 
 #include <media-io/audio-io.h>
+#include <media-io/video-frame.h>
 #include <util/platform.h>
 
 #include "media-playback.h"
@@ -29,9 +30,34 @@ extern void mp_media_next_audio(mp_media_t *m);
 extern bool mp_media_reset(mp_media_t *m);
 
 static bool mp_cache_reset(mp_cache_t *c);
+static void fill_ring(void *data, struct obs_source_frame *frame);
 
 static int64_t base_sys_ts = 0;
 
+/* maximum time to wait for the decode thread when a frame isn't ready */
+#define MP_CACHE_RING_WAIT_MS 50
+
+static inline void add_mem_usage(mp_cache_t *c, int64_t size)
+{
+	pthread_mutex_lock(&c->mutex);
+	c->mem_usage += size;
+	pthread_mutex_unlock(&c->mutex);
+}
+
+static size_t get_frame_size(enum video_format format, uint32_t width, uint32_t height)
+{
+	uint32_t linesizes[MAX_AV_PLANES] = {0};
+	uint32_t heights[MAX_AV_PLANES] = {0};
+	size_t size = 0;
+
+	video_frame_get_linesizes(linesizes, format, width);
+	video_frame_get_plane_heights(heights, format, height);
+
+	for (size_t i = 0; i < MAX_AV_PLANES; i++)
+		size += (size_t)linesizes[i] * (size_t)heights[i];
+	return size;
+}
+
 #define v_eof(c) (c->cur_v_idx == c->video_frames.num)
 #define a_eof(c) (c->cur_a_idx == c->audio_segments.num)
 
@@ -110,6 +136,270 @@ static bool mp_cache_eof(mp_cache_t *c)
 	return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/* compressed mode */
+
+/* returns the index of the cached frame closest to the given timestamp */
+static size_t find_frame_idx(mp_cache_t *c, int64_t ts)
+{
+	size_t lo = 0;
+	size_t hi = c->video_frames.num - 1;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if ((int64_t)c->video_frames.array[mid].timestamp < ts)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo > 0 && ts - (int64_t)c->video_frames.array[lo - 1].timestamp <
+			      (int64_t)c->video_frames.array[lo].timestamp - ts)
+		lo--;
+	return lo;
+}
+
+static void index_keyframes(mp_cache_t *c)
+{
+	mp_media_t *m = &c->m;
+	AVRational time_base = m->v.stream->time_base;
+
+	for (size_t i = 0; i < m->packet_cache.num; i++) {
+		AVPacket *pkt = m->packet_cache.array[i];
+		struct mp_cache_keyframe keyframe = {.packet = i};
+
+		if ((pkt->flags & AV_PKT_FLAG_KEY) == 0 || pkt->pts == AV_NOPTS_VALUE)
+			continue;
+
+		keyframe.ts = av_rescale_q(pkt->pts, time_base, (AVRational){1, 1000000000});
+		if (m->speed != 100)
+			keyframe.ts = av_rescale_q(keyframe.ts, (AVRational){1, m->speed}, (AVRational){1, 100});
+
+		da_push_back(c->keyframes, &keyframe);
+	}
+}
+
+/* restarts decoding from the last keyframe at or before the given frame */
+static void replay_from(mp_cache_t *c, size_t idx)
+{
+	mp_media_t *m = &c->m;
+	int64_t ts = (int64_t)c->video_frames.array[idx].timestamp;
+	size_t packet = 0;
+
+	for (size_t i = 0; i < c->keyframes.num; i++) {
+		if (c->keyframes.array[i].ts > ts)
+			break;
+		packet = c->keyframes.array[i].packet;
+	}
+
+	mp_decode_flush(&m->v);
+	m->replay_idx = packet;
+	m->eof = false;
+}
+
+static void *mp_cache_decode_thread(void *opaque)
+{
+	mp_cache_t *c = opaque;
+	mp_media_t *m = &c->m;
+	int64_t offset = 0;
+	size_t skip_idx = 0;
+	bool decoded = false;
+
+	os_set_thread_name("mp_cache_decode_thread");
+
+	for (;;) {
+		bool kill, seek;
+		size_t seek_idx;
+		uint64_t play_pos;
+
+		pthread_mutex_lock(&c->ring_mutex);
+		kill = c->decode_kill;
+		seek = c->decode_seek;
+		seek_idx = c->decode_seek_idx;
+		if (seek)
+			offset = (int64_t)c->decode_seek_pos - (int64_t)seek_idx;
+		play_pos = c->play_pos;
+		c->decode_seek = false;
+		pthread_mutex_unlock(&c->ring_mutex);
+
+		if (kill)
+			break;
+
+		if (seek) {
+			replay_from(c, seek_idx);
+			skip_idx = seek_idx;
+		}
+
+		if (!m->v.frame_ready) {
+			if (!mp_media_prepare_frames(m)) {
+				blog(LOG_WARNING, "MP: Failed to decode cached video for '%s'", c->path);
+				break;
+			}
+
+			if (!m->v.frame_ready) {
+				if (!decoded) {
+					blog(LOG_WARNING, "MP: No frames decoded from cached video for '%s'", c->path);
+					break;
+				}
+
+				/* end of the clip, positions continue with the
+				 * next loop */
+				replay_from(c, 0);
+				offset += (int64_t)c->video_frames.num;
+				skip_idx = 0;
+				decoded = false;
+				continue;
+			}
+		}
+
+		size_t idx = find_frame_idx(c, m->v.frame_pts);
+		uint64_t pos = (uint64_t)((int64_t)idx + offset);
+
+		/* frames decoded before a seek target, or frames playback
+		 * has already moved past */
+		if (idx < skip_idx || pos < play_pos) {
+			m->v.frame_ready = false;
+			continue;
+		}
+
+		/* ring is full, wait for playback to catch up */
+		if (pos >= play_pos + MP_CACHE_RING_SIZE) {
+			os_sem_wait(c->decode_sem);
+			continue;
+		}
+
+		c->decode_pos = pos;
+		mp_media_next_video(m, false);
+		decoded = true;
+	}
+
+	pthread_mutex_lock(&c->ring_mutex);
+	c->decode_stopped = true;
+	pthread_mutex_unlock(&c->ring_mutex);
+	os_event_signal(c->ring_event);
+	return NULL;
+}
+
+static bool mp_cache_start_decode_thread(mp_cache_t *c)
+{
+	mp_media_t *m = &c->m;
+
+	index_keyframes(c);
+
+	m->record_packets = false;
+	m->replay_packets = true;
+	m->has_audio = false;
+	m->v_cb = fill_ring;
+	m->a_cb = NULL;
+	replay_from(c, 0);
+
+	add_mem_usage(c, (int64_t)m->packet_cache_size);
+
+	if (pthread_create(&c->decode_thread, NULL, mp_cache_decode_thread, c) != 0) {
+		blog(LOG_WARNING, "MP: Could not create cache decode thread");
+		return false;
+	}
+
+	c->decode_thread_valid = true;
+	return true;
+}
+
+static void mp_kill_decode_thread(mp_cache_t *c)
+{
+	if (c->decode_thread_valid) {
+		pthread_mutex_lock(&c->ring_mutex);
+		c->decode_kill = true;
+		pthread_mutex_unlock(&c->ring_mutex);
+		os_sem_post(c->decode_sem);
+
+		pthread_join(c->decode_thread, NULL);
+		c->decode_thread_valid = false;
+	}
+}
+
+/* playback jumped, so restart decoding at the new frame.  positions skip
+ * ahead by the ring size so nothing decoded for the old position can be
+ * mistaken for the new one */
+static void mp_cache_ring_seek(mp_cache_t *c)
+{
+	if (!c->compressed)
+		return;
+
+	pthread_mutex_lock(&c->ring_mutex);
+	c->play_pos += MP_CACHE_RING_SIZE;
+	c->decode_seek = true;
+	c->decode_seek_idx = c->next_v_idx;
+	c->decode_seek_pos = c->play_pos;
+	pthread_mutex_unlock(&c->ring_mutex);
+
+	os_sem_post(c->decode_sem);
+}
+
+static void mp_cache_ring_advance(mp_cache_t *c)
+{
+	if (!c->compressed)
+		return;
+
+	pthread_mutex_lock(&c->ring_mutex);
+	c->play_pos++;
+	pthread_mutex_unlock(&c->ring_mutex);
+
+	os_sem_post(c->decode_sem);
+}
+
+static bool mp_cache_get_ring_frame(mp_cache_t *c, struct obs_source_frame *dup)
+{
+	const uint64_t timeout = os_gettime_ns() + MP_CACHE_RING_WAIT_MS * 1000000ULL;
+	struct mp_cache_slot *slot;
+	bool ready;
+
+	pthread_mutex_lock(&c->ring_mutex);
+	slot = &c->ring[c->play_pos % MP_CACHE_RING_SIZE];
+
+	for (;;) {
+		ready = slot->valid && slot->pos == c->play_pos;
+		if (ready || c->decode_stopped || os_gettime_ns() >= timeout)
+			break;
+
+		pthread_mutex_unlock(&c->ring_mutex);
+		os_event_timedwait(c->ring_event, 5);
+		pthread_mutex_lock(&c->ring_mutex);
+	}
+	pthread_mutex_unlock(&c->ring_mutex);
+
+	if (!ready) {
+		c->ring_underruns++;
+		return false;
+	}
+
+	/* the decode thread never writes the slot of the current play
+	 * position, so it's safe to use outside of the lock */
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		dup->data[i] = slot->frame.data[i];
+		dup->linesize[i] = slot->frame.linesize[i];
+	}
+	return true;
+}
+
+static void mp_cache_compress(mp_cache_t *c)
+{
+	/* the first frame stays resident for preloading */
+	for (size_t i = 1; i < c->video_frames.num; i++) {
+		struct obs_source_frame *f = &c->video_frames.array[i];
+
+		add_mem_usage(c, -(int64_t)get_frame_size(f->format, f->width, f->height));
+		bfree(f->data[0]);
+		memset(f->data, 0, sizeof(f->data));
+	}
+
+	c->compressed = true;
+
+	blog(LOG_INFO, "MP: '%s' exceeds the cache memory budget of %lld MB, switching to compressed mode", c->path,
+	     (long long)(c->mem_budget / (1024 * 1024)));
+}
+
+/* ------------------------------------------------------------------------- */
+
 bool mp_cache_decode(mp_cache_t *c)
 {
 	mp_media_t *m = &c->m;
@@ -135,6 +425,17 @@ bool mp_cache_decode(mp_cache_t *c)
 	if (c->start_time == AV_NOPTS_VALUE)
 		c->start_time = 0;
 
+	blog(LOG_INFO, "MP: Cached %zu frames of '%s' (%s, %.1f MB)", c->video_frames.num, c->path,
+	     c->compressed ? "compressed" : "uncompressed", (double)c->mem_usage / (1024.0 * 1024.0));
+
+	/* the media object stays alive in compressed mode, it's used to
+	 * decode the recorded packets again during playback */
+	if (c->compressed) {
+		success = mp_cache_start_decode_thread(c);
+		if (success)
+			return true;
+	}
+
 fail:
 	mp_media_free(m);
 	return success;
@@ -249,14 +550,21 @@ static void mp_cache_next_video(mp_cache_t *c, bool preload)
 		if (!mp_media_can_play_video(c))
 			return;
 
-		if (c->v_cb)
+		/* in compressed mode a frame the decode thread couldn't
+		 * deliver in time is dropped rather than stalling playback */
+		if (c->v_cb && (frame->data[0] || mp_cache_get_ring_frame(c, &dup)))
 			c->v_cb(c->opaque, &dup);
 
+		mp_cache_ring_advance(c);
+
 		if (c->cur_v_idx < c->next_v_idx)
 			++c->cur_v_idx;
 		++c->next_v_idx;
 		calc_next_v_ts(c, frame);
 	} else {
+		if (!frame->data[0] && !mp_cache_get_ring_frame(c, &dup))
+			return;
+
 		if (c->seek_next_ts && c->v_seek_cb) {
 			c->v_seek_cb(c->opaque, &dup);
 		} else if (!c->request_preload) {
@@ -298,6 +606,7 @@ static bool mp_cache_reset(mp_cache_t *c)
 	int64_t next_ts = mp_cache_get_base_pts(c);
 	int64_t offset = next_ts - c->next_pts_ns;
 	int64_t start_time = c->start_time;
+	bool wrapped = c->next_v_idx == c->video_frames.num;
 
 	c->eof = false;
 	c->base_ts += next_ts;
@@ -315,6 +624,11 @@ static bool mp_cache_reset(mp_cache_t *c)
 		size_t next_idx = c->video_frames.num > 1 ? 1 : 0;
 		c->cur_v_idx = c->next_v_idx = 0;
 		c->next_v_ts = c->video_frames.array[next_idx].timestamp;
+
+		/* the decode thread already continues with the next loop
+		 * when playback reaches the end naturally */
+		if (!wrapped)
+			mp_cache_ring_seek(c);
 	}
 	if (c->has_audio) {
 		size_t next_idx = c->audio_segments.num > 1 ? 1 : 0;
@@ -421,6 +735,7 @@ static inline bool mp_cache_thread(mp_cache_t *c)
 		if (seek) {
 			c->seek_next_ts = true;
 			seek_to(c, seek_pos);
+			mp_cache_ring_seek(c);
 			continue;
 		}
 
@@ -469,17 +784,56 @@ static void fill_video(void *data, struct obs_source_frame *frame)
 {
 	mp_cache_t *c = data;
 	struct obs_source_frame dup;
+	size_t size = get_frame_size(frame->format, frame->width, frame->height);
 
-	obs_source_frame_init(&dup, frame->format, frame->width, frame->height);
-	obs_source_frame_copy(&dup, frame);
+	c->final_v_duration = c->m.v.last_duration;
 
-	dup.timestamp = frame->timestamp;
+	if (!c->compressed && c->mem_budget > 0 && c->video_frames.num &&
+	    c->mem_usage + (int64_t)size > c->mem_budget)
+		mp_cache_compress(c);
 
-	c->final_v_duration = c->m.v.last_duration;
+	if (c->compressed) {
+		/* only the metadata is kept, the frame is decoded again from
+		 * the recorded packets during playback */
+		dup = *frame;
+		memset(dup.data, 0, sizeof(dup.data));
+	} else {
+		obs_source_frame_init(&dup, frame->format, frame->width, frame->height);
+		obs_source_frame_copy(&dup, frame);
+
+		dup.timestamp = frame->timestamp;
+		add_mem_usage(c, (int64_t)size);
+	}
 
 	da_push_back(c->video_frames, &dup);
 }
 
+static void fill_ring(void *data, struct obs_source_frame *frame)
+{
+	mp_cache_t *c = data;
+	struct mp_cache_slot *slot = &c->ring[c->decode_pos % MP_CACHE_RING_SIZE];
+	struct obs_source_frame *dst = &slot->frame;
+
+	if (!dst->data[0] || dst->format != frame->format || dst->width != frame->width ||
+	    dst->height != frame->height) {
+		if (dst->data[0])
+			add_mem_usage(c, -(int64_t)get_frame_size(dst->format, dst->width, dst->height));
+
+		obs_source_frame_free(dst);
+		obs_source_frame_init(dst, frame->format, frame->width, frame->height);
+		add_mem_usage(c, (int64_t)get_frame_size(frame->format, frame->width, frame->height));
+	}
+
+	obs_source_frame_copy(dst, frame);
+
+	pthread_mutex_lock(&c->ring_mutex);
+	slot->pos = c->decode_pos;
+	slot->valid = true;
+	pthread_mutex_unlock(&c->ring_mutex);
+
+	os_event_signal(c->ring_event);
+}
+
 static void fill_audio(void *data, struct obs_source_audio *audio)
 {
 	mp_cache_t *c = data;
@@ -505,6 +859,7 @@ static void fill_audio(void *data, struct obs_source_audio *audio)
 	}
 
 	c->final_a_duration = c->m.a.last_duration;
+	add_mem_usage(c, (int64_t)get_total_audio_size(dup.format, dup.speakers, dup.frames));
 
 	da_push_back(c->audio_segments, &dup);
 }
@@ -519,6 +874,18 @@ static inline bool mp_cache_init_internal(mp_cache_t *c, const struct mp_media_i
 		blog(LOG_WARNING, "MP: Failed to init semaphore");
 		return false;
 	}
+	if (pthread_mutex_init(&c->ring_mutex, NULL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init mutex");
+		return false;
+	}
+	if (os_event_init(&c->ring_event, OS_EVENT_TYPE_AUTO) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init event");
+		return false;
+	}
+	if (os_sem_init(&c->decode_sem, 0) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init semaphore");
+		return false;
+	}
 
 	c->path = info->path ? bstrdup(info->path) : NULL;
 	c->format_name = info->format ? bstrdup(info->format) : NULL;
@@ -547,6 +914,7 @@ bool mp_cache_init(mp_cache_t *c, const struct mp_media_info *info)
 	mp_media_t *m = &c->m;
 
 	pthread_mutex_init_value(&c->mutex);
+	pthread_mutex_init_value(&c->ring_mutex);
 
 	if (!mp_media_init(m, &info2)) {
 		mp_cache_free(c);
@@ -571,6 +939,11 @@ bool mp_cache_init(mp_cache_t *c, const struct mp_media_info *info)
 	c->has_video = m->has_video;
 	c->has_audio = m->has_audio;
 
+	/* packets are only worth recording if there's a budget that the video
+	 * might exceed */
+	c->mem_budget = info->cache_budget;
+	m->record_packets = c->mem_budget > 0 && c->has_video;
+
 	if (!base_sys_ts)
 		base_sys_ts = (int64_t)os_gettime_ns();
 
@@ -601,10 +974,19 @@ void mp_cache_free(mp_cache_t *c)
 
 	mp_cache_stop(c);
 	mp_kill_thread(c);
+	mp_kill_decode_thread(c);
 
 	if (c->m.fmt)
 		mp_media_free(&c->m);
 
+	if (c->ring_underruns)
+		blog(LOG_DEBUG, "MP: %llu cached frames of '%s' were not decoded in time",
+		     (unsigned long long)c->ring_underruns, c->path);
+
+	for (size_t i = 0; i < MP_CACHE_RING_SIZE; i++)
+		obs_source_frame_free(&c->ring[i].frame);
+	da_free(c->keyframes);
+
 	for (size_t i = 0; i < c->video_frames.num; i++) {
 		struct obs_source_frame *f = &c->video_frames.array[i];
 		obs_source_frame_free(f);
@@ -619,7 +1001,10 @@ void mp_cache_free(mp_cache_t *c)
 	bfree(c->path);
 	bfree(c->format_name);
 	pthread_mutex_destroy(&c->mutex);
+	pthread_mutex_destroy(&c->ring_mutex);
 	os_sem_destroy(c->sem);
+	os_sem_destroy(c->decode_sem);
+	os_event_destroy(c->ring_event);
 	memset(c, 0, sizeof(*c));
 }
 
@@ -699,3 +1084,14 @@ int64_t mp_cache_get_duration(mp_cache_t *c)
 {
 	return c->media_duration;
 }
+
+int64_t mp_cache_get_memory_usage(mp_cache_t *c)
+{
+	int64_t mem_usage;
+
+	pthread_mutex_lock(&c->mutex);
+	mem_usage = c->mem_usage;
+	pthread_mutex_unlock(&c->mutex);
+
+	return mem_usage;
+}
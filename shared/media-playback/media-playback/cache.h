@@ -22,6 +22,20 @@
 
 #include "media.h"
 
+/* number of frames decoded ahead of playback in compressed mode */
+#define MP_CACHE_RING_SIZE 8
+
+struct mp_cache_slot {
+	struct obs_source_frame frame;
+	uint64_t pos;
+	bool valid;
+};
+
+struct mp_cache_keyframe {
+	size_t packet;
+	int64_t ts;
+};
+
 struct mp_cache {
 	mp_video_cb v_preload_cb;
 	mp_video_cb v_seek_cb;
@@ -79,6 +93,32 @@ struct mp_cache {
 	int64_t start_time;
 	int64_t media_duration;
 
+	/* memory budget for the cache, 0 if unlimited.  if the decoded clip
+	 * does not fit, the cache switches to compressed mode: the demuxed
+	 * video packets stay in memory along with the metadata of every frame
+	 * (and the pixels of the first frame), and the decode thread decodes
+	 * ahead of playback into a small ring of frames. */
+	int64_t mem_budget;
+	int64_t mem_usage;
+	bool compressed;
+
+	DARRAY(struct mp_cache_keyframe) keyframes;
+	struct mp_cache_slot ring[MP_CACHE_RING_SIZE];
+	pthread_mutex_t ring_mutex;
+	os_event_t *ring_event;
+	os_sem_t *decode_sem;
+	uint64_t play_pos;
+	uint64_t decode_pos;
+	uint64_t decode_seek_pos;
+	size_t decode_seek_idx;
+	bool decode_seek;
+	bool decode_kill;
+	bool decode_stopped;
+	uint64_t ring_underruns;
+
+	bool decode_thread_valid;
+	pthread_t decode_thread;
+
 	mp_media_t m;
 };
 
@@ -95,3 +135,4 @@ extern int64_t mp_cache_get_current_time(mp_cache_t *c);
 extern void mp_cache_seek(mp_cache_t *c, int64_t pos);
 extern int64_t mp_cache_get_frames(mp_cache_t *c);
 extern int64_t mp_cache_get_duration(mp_cache_t *c);
+extern int64_t mp_cache_get_memory_usage(mp_cache_t *c);
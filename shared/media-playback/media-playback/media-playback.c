@@ -17,22 +17,36 @@
 #include "media-playback.h"
 #include "media.h"
 #include "cache.h"
+#include "shared.h"
 
 struct media_playback {
 	bool is_cached;
+	bool is_shared;
 	union {
 		mp_media_t media;
 		mp_cache_t cache;
+		struct mp_shared_sub shared;
 	};
+
+	/* owned copy of the options once detached from shared decoding */
+	char *ffmpeg_options;
 };
 
 media_playback_t *media_playback_create(const struct mp_media_info *info)
 {
 	media_playback_t *mp = bzalloc(sizeof(*mp));
-	mp->is_cached = info->is_local_file && info->full_decode;
+
+	/* only media decoded on its own can keep up with offline rendering
+	 * in lockstep, see mp_media_advance */
+	bool offline = obs_offline_rendering_active();
+
+	mp->is_cached = info->is_local_file && info->full_decode && !offline;
+	mp->is_shared = !mp->is_cached && !offline && info->is_local_file && info->shared_decode &&
+			!info->request_preload;
 
 	if ((mp->is_cached && !mp_cache_init(&mp->cache, info)) ||
-	    (!mp->is_cached && !mp_media_init(&mp->media, info))) {
+	    (mp->is_shared && !mp_shared_init(&mp->shared, info)) ||
+	    (!mp->is_cached && !mp->is_shared && !mp_media_init(&mp->media, info))) {
 		bfree(mp);
 		return NULL;
 	}
@@ -47,18 +61,67 @@ void media_playback_destroy(media_playback_t *mp)
 
 	if (mp->is_cached)
 		mp_cache_free(&mp->cache);
+	else if (mp->is_shared)
+		mp_shared_free(&mp->shared);
 	else
 		mp_media_free(&mp->media);
+	bfree(mp->ffmpeg_options);
 	bfree(mp);
 }
 
+/* switches from shared decoding to a media object of its own, continuing
+ * from the current position if playing.  if the file can't be opened again,
+ * the media is subscribed to shared decoding again and false is returned */
+static bool media_playback_unshare(media_playback_t *mp, bool looping)
+{
+	struct mp_media_info info;
+	bool active = mp->shared.active;
+	int64_t time = mp_media_get_current_time(mp_shared_get_media(&mp->shared));
+	bool success;
+
+	mp_shared_detach(&mp->shared, &info);
+	mp->is_shared = false;
+
+	success = mp_media_init(&mp->media, &info);
+	if (success) {
+		mp->ffmpeg_options = info.ffmpeg_options;
+		info.ffmpeg_options = NULL;
+
+		if (active) {
+			mp_media_play(&mp->media, looping, false);
+			if (time > 0)
+				mp_media_seek(&mp->media, time);
+		}
+
+	} else {
+		blog(LOG_WARNING, "MP: Failed to detach '%s' from shared decoding, staying shared", info.path);
+
+		mp->is_shared = mp_shared_init(&mp->shared, &info);
+		if (!mp->is_shared)
+			blog(LOG_ERROR, "MP: Failed to subscribe '%s' to shared decoding again", info.path);
+		else if (active)
+			mp_shared_play(&mp->shared);
+	}
+
+	bfree((void *)info.path);
+	bfree((void *)info.format);
+	bfree(info.ffmpeg_options);
+	return success;
+}
+
 void media_playback_play(media_playback_t *mp, bool looping, bool reconnecting)
 {
 	if (!mp)
 		return;
 
+	/* shared media always loops */
+	if (mp->is_shared && !looping)
+		media_playback_unshare(mp, looping);
+
 	if (mp->is_cached)
 		mp_cache_play(&mp->cache, looping);
+	else if (mp->is_shared)
+		mp_shared_play(&mp->shared);
 	else
 		mp_media_play(&mp->media, looping, reconnecting);
 }
@@ -68,9 +131,14 @@ void media_playback_play_pause(media_playback_t *mp, bool pause)
 	if (!mp)
 		return;
 
+	/* pausing takes the position away from the other subscribers, and
+	 * shared media is never paused to begin with */
+	if (mp->is_shared && pause && !media_playback_unshare(mp, true))
+		return;
+
 	if (mp->is_cached)
 		mp_cache_play_pause(&mp->cache, pause);
-	else
+	else if (!mp->is_shared)
 		mp_media_play_pause(&mp->media, pause);
 }
 
@@ -81,23 +149,32 @@ void media_playback_stop(media_playback_t *mp)
 
 	if (mp->is_cached)
 		mp_cache_stop(&mp->cache);
+	else if (mp->is_shared)
+		mp_shared_stop(&mp->shared);
 	else
 		mp_media_stop(&mp->media);
 }
 
 void media_playback_set_looping(media_playback_t *mp, bool looping)
 {
+	if (mp->is_shared && !looping && !media_playback_unshare(mp, looping))
+		return;
+
 	if (mp->is_cached)
 		mp->cache.looping = looping;
-	else
+	else if (!mp->is_shared)
 		mp->media.looping = looping;
 }
 
 void media_playback_set_is_linear_alpha(media_playback_t *mp, bool is_linear_alpha)
 {
+	if (mp->is_shared && mp->shared.info.is_linear_alpha != is_linear_alpha &&
+	    !media_playback_unshare(mp, true))
+		return;
+
 	if (mp->is_cached)
 		mp->cache.m.is_linear_alpha = is_linear_alpha;
-	else
+	else if (!mp->is_shared)
 		mp->media.is_linear_alpha = is_linear_alpha;
 }
 
@@ -108,7 +185,7 @@ void media_playback_preload_frame(media_playback_t *mp)
 
 	if (mp->is_cached)
 		mp_cache_preload_frame(&mp->cache);
-	else
+	else if (!mp->is_shared)
 		mp_media_preload_frame(&mp->media);
 }
 
@@ -119,18 +196,34 @@ int64_t media_playback_get_current_time(media_playback_t *mp)
 
 	if (mp->is_cached)
 		return mp_cache_get_current_time(&mp->cache);
+	else if (mp->is_shared)
+		return mp_media_get_current_time(mp_shared_get_media(&mp->shared));
 	else
 		return mp_media_get_current_time(&mp->media);
 }
 
 void media_playback_seek(media_playback_t *mp, int64_t pos)
 {
+	if (mp->is_shared && !media_playback_unshare(mp, true))
+		return;
+
 	if (mp->is_cached)
 		mp_cache_seek(&mp->cache, pos);
 	else
 		mp_media_seek(&mp->media, pos);
 }
 
+void media_playback_advance(media_playback_t *mp, uint64_t ts)
+{
+	if (!mp || mp->is_cached)
+		return;
+
+	if (mp->is_shared)
+		mp_media_advance(mp_shared_get_media(&mp->shared), ts);
+	else
+		mp_media_advance(&mp->media, ts);
+}
+
 int64_t media_playback_get_frames(media_playback_t *mp)
 {
 	if (!mp)
@@ -138,6 +231,8 @@ int64_t media_playback_get_frames(media_playback_t *mp)
 
 	if (mp->is_cached)
 		return mp_cache_get_frames(&mp->cache);
+	else if (mp->is_shared)
+		return mp_media_get_frames(mp_shared_get_media(&mp->shared));
 	else
 		return mp_media_get_frames(&mp->media);
 }
@@ -149,6 +244,8 @@ int64_t media_playback_get_duration(media_playback_t *mp)
 
 	if (mp->is_cached)
 		return mp_cache_get_duration(&mp->cache);
+	else if (mp->is_shared)
+		return mp_media_get_duration(mp_shared_get_media(&mp->shared));
 	else
 		return mp_media_get_duration(&mp->media);
 }
@@ -160,6 +257,8 @@ bool media_playback_has_video(media_playback_t *mp)
 
 	if (mp->is_cached)
 		return mp->cache.has_video;
+	else if (mp->is_shared)
+		return mp_shared_get_media(&mp->shared)->has_video;
 	else
 		return mp->media.has_video;
 }
@@ -171,6 +270,17 @@ bool media_playback_has_audio(media_playback_t *mp)
 
 	if (mp->is_cached)
 		return mp->cache.has_audio;
+	else if (mp->is_shared)
+		return mp_shared_get_media(&mp->shared)->has_audio;
 	else
 		return mp->media.has_audio;
 }
+
+int64_t media_playback_get_memory_usage(media_playback_t *mp)
+{
+	if (!mp)
+		return 0;
+
+	/* streamed media only holds a handful of frames at a time */
+	return mp->is_cached ? mp_cache_get_memory_usage(&mp->cache) : 0;
+}
@@ -46,6 +46,13 @@ struct mp_media_info {
 	bool reconnecting;
 	bool request_preload;
 	bool full_decode;
+
+	/* local files played in a loop with the same options share a single
+	 * decoder */
+	bool shared_decode;
+
+	/* memory budget in bytes for fully decoded media, 0 if unlimited */
+	int64_t cache_budget;
 };
 
 extern media_playback_t *media_playback_create(const struct mp_media_info *info);
@@ -59,7 +66,9 @@ extern void media_playback_set_is_linear_alpha(media_playback_t *mp, bool is_lin
 extern void media_playback_preload_frame(media_playback_t *mp);
 extern int64_t media_playback_get_current_time(media_playback_t *mp);
 extern void media_playback_seek(media_playback_t *mp, int64_t pos);
+extern void media_playback_advance(media_playback_t *mp, uint64_t ts);
 extern int64_t media_playback_get_frames(media_playback_t *mp);
 extern int64_t media_playback_get_duration(media_playback_t *mp);
 extern bool media_playback_has_video(media_playback_t *mp);
 extern bool media_playback_has_audio(media_playback_t *mp);
+extern int64_t media_playback_get_memory_usage(media_playback_t *mp);
@@ -164,6 +164,26 @@ void mp_media_free_packet(struct mp_media *media, AVPacket *pkt)
 	da_push_back(media->packet_pool, &pkt);
 }
 
+static int mp_media_replay_packet(mp_media_t *media, AVPacket *pkt)
+{
+	if (media->replay_idx == media->packet_cache.num) {
+		mp_media_free_packet(media, pkt);
+		return AVERROR_EOF;
+	}
+
+	return av_packet_ref(pkt, media->packet_cache.array[media->replay_idx++]);
+}
+
+static void mp_media_record_packet(mp_media_t *media, const AVPacket *pkt)
+{
+	AVPacket *copy = av_packet_clone(pkt);
+	if (!copy)
+		return;
+
+	media->packet_cache_size += copy->size;
+	da_push_back(media->packet_cache, &copy);
+}
+
 static int mp_media_next_packet(mp_media_t *media)
 {
 	AVPacket *pkt;
@@ -175,8 +195,11 @@ static int mp_media_next_packet(mp_media_t *media)
 		pkt = av_packet_alloc();
 	}
 
-	int ret = av_read_frame(media->fmt, pkt);
+	int ret = media->replay_packets ? mp_media_replay_packet(media, pkt) : av_read_frame(media->fmt, pkt);
 	if (ret < 0) {
+		/* only a single pass over the file is recorded */
+		if (ret == AVERROR_EOF)
+			media->record_packets = false;
 		if (ret != AVERROR_EOF && ret != AVERROR_EXIT)
 			blog(LOG_WARNING, "MP: av_read_frame failed: %s (%d)", av_err2str(ret), ret);
 		return ret;
@@ -184,6 +207,8 @@ static int mp_media_next_packet(mp_media_t *media)
 
 	struct mp_decode *d = get_packet_decoder(media, pkt);
 	if (d && pkt->size) {
+		if (media->record_packets && d == &media->v)
+			mp_media_record_packet(media, pkt);
 		mp_decode_push_packet(d, pkt);
 	} else {
 		mp_media_free_packet(media, pkt);
@@ -571,13 +596,13 @@ bool mp_media_reset(mp_media_t *m)
 
 	if (active) {
 		if (!m->play_sys_ts)
-			m->play_sys_ts = (int64_t)os_gettime_ns();
+			m->play_sys_ts = (int64_t)obs_get_time_ns();
 		m->start_ts = m->next_pts_ns = mp_media_get_next_min_pts(m);
 		if (m->next_ns)
 			m->next_ns += offset;
 	} else {
 		m->start_ts = m->next_pts_ns = mp_media_get_next_min_pts(m);
-		m->play_sys_ts = (int64_t)os_gettime_ns();
+		m->play_sys_ts = (int64_t)obs_get_time_ns();
 		m->next_ns = 0;
 	}
 
@@ -590,14 +615,36 @@ bool mp_media_reset(mp_media_t *m)
 	return true;
 }
 
+/* the virtual clock of offline rendering only moves on once everything up to
+ * it has been output (see mp_media_advance), so there's nothing to sleep for.
+ * returns true if the frames aren't due yet */
+static bool mp_media_wait_offline(mp_media_t *m)
+{
+	bool ready;
+
+	pthread_mutex_lock(&m->mutex);
+	ready = m->next_ns <= m->offline_ts;
+	if (!ready)
+		os_event_signal(m->caught_up_event);
+	pthread_mutex_unlock(&m->mutex);
+
+	/* also wakes up now and then to notice offline rendering being turned
+	 * off, or any other request */
+	if (!ready)
+		os_event_timedwait(m->advance_event, 200);
+	return !ready;
+}
+
 static inline bool mp_media_sleep(mp_media_t *m)
 {
 	bool timeout = false;
 
 	if (!m->next_ns) {
-		m->next_ns = os_gettime_ns();
+		m->next_ns = obs_get_time_ns();
+	} else if (m->is_local_file && obs_offline_rendering_active()) {
+		timeout = mp_media_wait_offline(m);
 	} else {
-		const uint64_t t = os_gettime_ns();
+		const uint64_t t = obs_get_time_ns();
 		if (m->next_ns > t) {
 			const uint32_t delta_ms = (uint32_t)((m->next_ns - t + 500000) / 1000000);
 			if (delta_ms > 0) {
@@ -719,7 +766,7 @@ static bool init_avformat(mp_media_t *m)
 static void reset_ts(mp_media_t *m)
 {
 	m->base_ts += mp_media_get_base_pts(m);
-	m->play_sys_ts = (int64_t)os_gettime_ns();
+	m->play_sys_ts = (int64_t)obs_get_time_ns();
 	m->start_ts = m->next_pts_ns = mp_media_get_next_min_pts(m);
 	m->next_ns = 0;
 }
@@ -754,6 +801,7 @@ static inline bool mp_media_thread(mp_media_t *m)
 		pthread_mutex_unlock(&m->mutex);
 
 		if (!is_active || pause) {
+			os_event_signal(m->caught_up_event);
 			if (os_sem_wait(m->sem) < 0)
 				return false;
 			if (pause)
@@ -837,6 +885,7 @@ static void *mp_media_thread_start(void *opaque)
 		}
 	}
 
+	os_event_signal(m->caught_up_event);
 	return NULL;
 }
 
@@ -850,6 +899,11 @@ static inline bool mp_media_init_internal(mp_media_t *m, const struct mp_media_i
 		blog(LOG_WARNING, "MP: Failed to init semaphore");
 		return false;
 	}
+	if (os_event_init(&m->advance_event, OS_EVENT_TYPE_AUTO) != 0 ||
+	    os_event_init(&m->caught_up_event, OS_EVENT_TYPE_MANUAL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init events");
+		return false;
+	}
 
 	m->path = info->path ? bstrdup(info->path) : NULL;
 	m->format_name = info->format ? bstrdup(info->format) : NULL;
@@ -897,7 +951,7 @@ bool mp_media_init(mp_media_t *media, const struct mp_media_info *info)
 	}
 
 	if (!base_sys_ts)
-		base_sys_ts = (int64_t)os_gettime_ns();
+		base_sys_ts = (int64_t)obs_get_time_ns();
 
 	if (!mp_media_init_internal(media, info)) {
 		mp_media_free(media);
@@ -914,6 +968,7 @@ static void mp_kill_thread(mp_media_t *m)
 		m->kill = true;
 		pthread_mutex_unlock(&m->mutex);
 		os_sem_post(m->sem);
+		os_event_signal(m->advance_event);
 
 		pthread_join(m->thread, NULL);
 	}
@@ -931,9 +986,14 @@ void mp_media_free(mp_media_t *media)
 	for (size_t i = 0; i < media->packet_pool.num; i++)
 		av_packet_free(&media->packet_pool.array[i]);
 	da_free(media->packet_pool);
+	for (size_t i = 0; i < media->packet_cache.num; i++)
+		av_packet_free(&media->packet_cache.array[i]);
+	da_free(media->packet_cache);
 	avformat_close_input(&media->fmt);
 	pthread_mutex_destroy(&media->mutex);
 	os_sem_destroy(media->sem);
+	os_event_destroy(media->advance_event);
+	os_event_destroy(media->caught_up_event);
 	sws_freeContext(media->swscale);
 	av_freep(&media->scale_pic[0]);
 	bfree(media->path);
@@ -958,6 +1018,29 @@ void mp_media_play(mp_media_t *m, bool loop, bool reconnecting)
 	os_sem_post(m->sem);
 }
 
+/* waits until the media thread has output everything up to the given time
+ * of the virtual clock when rendering offline, so that every frame rendered
+ * gets the same media frames on every run.  streams aren't waited for. */
+void mp_media_advance(mp_media_t *m, uint64_t ts)
+{
+	bool wait;
+
+	if (!m->thread_valid || !m->is_local_file)
+		return;
+
+	pthread_mutex_lock(&m->mutex);
+	wait = m->active && !m->pause;
+	m->offline_ts = ts;
+	if (wait)
+		os_event_reset(m->caught_up_event);
+	pthread_mutex_unlock(&m->mutex);
+
+	if (wait) {
+		os_event_signal(m->advance_event);
+		os_event_wait(m->caught_up_event);
+	}
+}
+
 void mp_media_play_pause(mp_media_t *m, bool pause)
 {
 	pthread_mutex_lock(&m->mutex);
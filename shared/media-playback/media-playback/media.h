@@ -60,6 +60,15 @@ struct mp_media {
 	uint8_t *scale_pic[4];
 
 	DARRAY(AVPacket *) packet_pool;
+
+	/* used by the compressed playback cache: video packets are recorded
+	 * while decoding, and later replayed instead of reading the file */
+	DARRAY(AVPacket *) packet_cache;
+	size_t packet_cache_size;
+	size_t replay_idx;
+	bool record_packets;
+	bool replay_packets;
+
 	struct mp_decode v;
 	struct mp_decode a;
 	bool request_preload;
@@ -103,6 +112,12 @@ struct mp_media {
 	bool seek;
 	bool seek_next_ts;
 	int64_t seek_pos;
+
+	/* offline rendering: frames are only output up to this time, see
+	 * mp_media_advance */
+	uint64_t offline_ts;
+	os_event_t *advance_event;
+	os_event_t *caught_up_event;
 };
 
 typedef struct mp_media mp_media_t;
@@ -118,6 +133,7 @@ extern int64_t mp_media_get_current_time(mp_media_t *m);
 extern int64_t mp_media_get_frames(mp_media_t *m);
 extern int64_t mp_media_get_duration(mp_media_t *m);
 extern void mp_media_seek(mp_media_t *m, int64_t pos);
+extern void mp_media_advance(mp_media_t *m, uint64_t ts);
 
 /* #define DETAILED_DEBUG_INFO */
 
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2026 OBS Studio contributors
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <util/dstr.h>
+
+#include "media-playback.h"
+#include "shared.h"
+
+struct mp_shared {
+	char *key;
+	char *ffmpeg_options;
+	long refs;
+
+	pthread_mutex_t mutex;
+	DARRAY(struct mp_shared_sub *) subs;
+	size_t active;
+	bool playing;
+
+	mp_media_t media;
+};
+
+static pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+static DARRAY(struct mp_shared *) shared_media;
+
+static char *get_key(const struct mp_media_info *info)
+{
+	struct dstr key = {0};
+
+	dstr_printf(&key, "%s|%s|%s|%d|%d|%d|%d", info->path, info->format ? info->format : "",
+		    info->ffmpeg_options ? info->ffmpeg_options : "", info->speed, (int)info->force_range,
+		    (int)info->is_linear_alpha, (int)info->hardware_decoding);
+	return key.array;
+}
+
+/* ------------------------------------------------------------------------- */
+/* callbacks, called from the media thread */
+
+static void shared_video(void *opaque, struct obs_source_frame *frame)
+{
+	struct mp_shared *shared = opaque;
+
+	pthread_mutex_lock(&shared->mutex);
+	for (size_t i = 0; i < shared->subs.num; i++) {
+		struct mp_shared_sub *sub = shared->subs.array[i];
+		if (sub->active && sub->info.v_cb)
+			sub->info.v_cb(sub->info.opaque, frame);
+	}
+	pthread_mutex_unlock(&shared->mutex);
+}
+
+static void shared_preload_video(void *opaque, struct obs_source_frame *frame)
+{
+	struct mp_shared *shared = opaque;
+
+	/* the media only preloads while stopped, so this goes to everyone */
+	pthread_mutex_lock(&shared->mutex);
+	for (size_t i = 0; i < shared->subs.num; i++) {
+		struct mp_shared_sub *sub = shared->subs.array[i];
+		if (sub->info.v_preload_cb)
+			sub->info.v_preload_cb(sub->info.opaque, frame);
+	}
+	pthread_mutex_unlock(&shared->mutex);
+}
+
+static void shared_audio(void *opaque, struct obs_source_audio *audio)
+{
+	struct mp_shared *shared = opaque;
+
+	pthread_mutex_lock(&shared->mutex);
+	for (size_t i = 0; i < shared->subs.num; i++) {
+		struct mp_shared_sub *sub = shared->subs.array[i];
+		if (sub->active && sub->info.a_cb)
+			sub->info.a_cb(sub->info.opaque, audio);
+	}
+	pthread_mutex_unlock(&shared->mutex);
+}
+
+static void shared_stopped(void *opaque)
+{
+	struct mp_shared *shared = opaque;
+
+	pthread_mutex_lock(&shared->mutex);
+	for (size_t i = 0; i < shared->subs.num; i++) {
+		struct mp_shared_sub *sub = shared->subs.array[i];
+		if (sub->active && sub->info.stop_cb)
+			sub->info.stop_cb(sub->info.opaque);
+	}
+	pthread_mutex_unlock(&shared->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void mp_shared_destroy(struct mp_shared *shared)
+{
+	mp_media_free(&shared->media);
+	pthread_mutex_destroy(&shared->mutex);
+	da_free(shared->subs);
+	bfree(shared->ffmpeg_options);
+	bfree(shared->key);
+	bfree(shared);
+}
+
+/* the subscriber is added before the media is created so that it receives
+ * the frame preloaded when the media thread starts */
+static struct mp_shared *mp_shared_create(char *key, struct mp_shared_sub *sub)
+{
+	struct mp_shared *shared = bzalloc(sizeof(*shared));
+	struct mp_media_info info = sub->info;
+
+	shared->key = key;
+	shared->refs = 1;
+	pthread_mutex_init_value(&shared->mutex);
+	pthread_mutex_init_value(&shared->media.mutex);
+
+	if (pthread_mutex_init(&shared->mutex, NULL) != 0) {
+		blog(LOG_WARNING, "MP: Failed to init mutex");
+		goto fail;
+	}
+
+	shared->ffmpeg_options = info.ffmpeg_options ? bstrdup(info.ffmpeg_options) : NULL;
+	da_push_back(shared->subs, &sub);
+
+	info.opaque = shared;
+	info.v_cb = shared_video;
+	info.v_preload_cb = shared_preload_video;
+	info.v_seek_cb = NULL;
+	info.a_cb = shared_audio;
+	info.stop_cb = shared_stopped;
+	info.ffmpeg_options = shared->ffmpeg_options;
+
+	if (!mp_media_init(&shared->media, &info))
+		goto fail;
+
+	return shared;
+
+fail:
+	mp_shared_destroy(shared);
+	return NULL;
+}
+
+bool mp_shared_init(struct mp_shared_sub *sub, const struct mp_media_info *info)
+{
+	struct mp_shared *shared = NULL;
+	char *key = get_key(info);
+
+	memset(sub, 0, sizeof(*sub));
+	sub->info = *info;
+	sub->info.path = bstrdup(info->path);
+	sub->info.format = info->format ? bstrdup(info->format) : NULL;
+	sub->info.ffmpeg_options = info->ffmpeg_options ? bstrdup(info->ffmpeg_options) : NULL;
+
+	pthread_mutex_lock(&shared_mutex);
+
+	for (size_t i = 0; i < shared_media.num; i++) {
+		if (strcmp(shared_media.array[i]->key, key) == 0) {
+			shared = shared_media.array[i];
+			break;
+		}
+	}
+
+	if (shared) {
+		shared->refs++;
+		bfree(key);
+
+		pthread_mutex_lock(&shared->mutex);
+		da_push_back(shared->subs, &sub);
+		pthread_mutex_unlock(&shared->mutex);
+
+	} else {
+		shared = mp_shared_create(key, sub);
+		if (shared)
+			da_push_back(shared_media, &shared);
+	}
+
+	pthread_mutex_unlock(&shared_mutex);
+
+	if (!shared) {
+		bfree((void *)sub->info.path);
+		bfree((void *)sub->info.format);
+		bfree(sub->info.ffmpeg_options);
+		memset(sub, 0, sizeof(*sub));
+		return false;
+	}
+
+	sub->shared = shared;
+	return true;
+}
+
+static void mp_shared_unsubscribe(struct mp_shared_sub *sub)
+{
+	struct mp_shared *shared = sub->shared;
+	bool destroy;
+
+	mp_shared_stop(sub);
+
+	/* once removed, no callbacks can reach the subscriber anymore */
+	pthread_mutex_lock(&shared->mutex);
+	da_erase_item(shared->subs, &sub);
+	pthread_mutex_unlock(&shared->mutex);
+
+	pthread_mutex_lock(&shared_mutex);
+	destroy = --shared->refs == 0;
+	if (destroy)
+		da_erase_item(shared_media, &shared);
+	pthread_mutex_unlock(&shared_mutex);
+
+	if (destroy)
+		mp_shared_destroy(shared);
+
+	sub->shared = NULL;
+}
+
+void mp_shared_free(struct mp_shared_sub *sub)
+{
+	if (!sub->shared)
+		return;
+
+	mp_shared_unsubscribe(sub);
+	bfree((void *)sub->info.path);
+	bfree((void *)sub->info.format);
+	bfree(sub->info.ffmpeg_options);
+	memset(sub, 0, sizeof(*sub));
+}
+
+void mp_shared_detach(struct mp_shared_sub *sub, struct mp_media_info *info)
+{
+	mp_shared_unsubscribe(sub);
+	*info = sub->info;
+	memset(sub, 0, sizeof(*sub));
+}
+
+void mp_shared_play(struct mp_shared_sub *sub)
+{
+	struct mp_shared *shared = sub->shared;
+	bool restart;
+
+	pthread_mutex_lock(&shared->mutex);
+
+	/* subscribers join playback wherever it currently is, a restart only
+	 * rewinds the media if nobody else is watching it */
+	restart = !shared->playing || (sub->active && shared->active == 1);
+
+	if (!sub->active) {
+		sub->active = true;
+		shared->active++;
+	}
+	shared->playing = true;
+
+	pthread_mutex_unlock(&shared->mutex);
+
+	if (restart)
+		mp_media_play(&shared->media, true, false);
+}
+
+void mp_shared_stop(struct mp_shared_sub *sub)
+{
+	struct mp_shared *shared = sub->shared;
+	bool stop = false;
+
+	pthread_mutex_lock(&shared->mutex);
+	if (sub->active) {
+		sub->active = false;
+		stop = --shared->active == 0;
+		if (stop)
+			shared->playing = false;
+	}
+	pthread_mutex_unlock(&shared->mutex);
+
+	if (stop)
+		mp_media_stop(&shared->media);
+}
+
+mp_media_t *mp_shared_get_media(struct mp_shared_sub *sub)
+{
+	return &sub->shared->media;
+}
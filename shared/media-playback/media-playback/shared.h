@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026 OBS Studio contributors
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#pragma once
+
+#include "media.h"
+
+/*
+ * Shared decoding: local files that are played in a loop with identical
+ * decoding options are decoded by a single media object, and every decoded
+ * frame is handed to all subscribers that are currently playing.
+ */
+
+struct mp_shared;
+
+struct mp_shared_sub {
+	struct mp_shared *shared;
+	struct mp_media_info info;
+	bool active;
+};
+
+extern bool mp_shared_init(struct mp_shared_sub *sub, const struct mp_media_info *info);
+extern void mp_shared_free(struct mp_shared_sub *sub);
+
+/* unsubscribes from the shared media, and transfers the media info (and
+ * ownership of its strings) to the caller so it can play on its own */
+extern void mp_shared_detach(struct mp_shared_sub *sub, struct mp_media_info *info);
+
+extern void mp_shared_play(struct mp_shared_sub *sub);
+extern void mp_shared_stop(struct mp_shared_sub *sub);
+extern mp_media_t *mp_shared_get_media(struct mp_shared_sub *sub);
@@ -0,0 +1,375 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+
+#include <obs.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <media-io/audio-io.h>
+#include <media-io/audio-resampler.h>
+#include <media-io/clock-follower.h>
+
+#define MAX_TEST_INPUTS 8
+#define BENCH_TICKS 16
+#define LATENCY_EVENTS 32
+#define LATENCY_SLACK_NS 20000000ULL
+#define CLOCK_TEST_SECONDS 20
+
+/* only touched by the audio thread while inputs are connected */
+static uint64_t tick_start = 0;
+static size_t tick_calls = 0;
+static const uint8_t *tick_data = NULL;
+static size_t num_inputs = 0;
+static uint64_t total_ns = 0;
+static long measured_ticks = 0;
+static float phase = 0.0f;
+
+static volatile long mismatches = 0;
+static os_event_t *done_event = NULL;
+
+static audio_t *audio = NULL;
+
+/* block size latency test state */
+static volatile bool impulse_pending = false;
+static uint64_t impulse_ts = 0;
+static uint64_t latency_ns = 0;
+static uint32_t block_frames = 0;
+static volatile long block_mismatches = 0;
+static os_event_t *impulse_event = NULL;
+
+/* clock drift test state */
+static int64_t clock_ppm = 0;
+static const uint64_t clock_base = 1000000000ULL;
+static uint32_t jitter_seed = 1;
+
+static const struct audio_convert_info conversion = {
+	.samples_per_sec = 44100,
+	.format = AUDIO_FORMAT_FLOAT,
+	.speakers = SPEAKERS_STEREO,
+};
+
+static bool input_callback(void *param, uint64_t start_ts, uint64_t end_ts, uint64_t *new_ts, uint32_t active_mixers,
+			   struct audio_output_data *mixes)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(end_ts);
+	UNUSED_PARAMETER(active_mixers);
+
+	tick_start = os_gettime_ns();
+	tick_calls = 0;
+	tick_data = NULL;
+
+	for (size_t i = 0; i < AUDIO_OUTPUT_FRAMES; i++) {
+		float val = sinf(phase);
+		mixes[0].data[0][i] = val;
+		mixes[0].data[1][i] = val;
+		phase += 440.0f * 2.0f * 3.14159265f / 48000.0f;
+		if (phase > 2.0f * 3.14159265f)
+			phase -= 2.0f * 3.14159265f;
+	}
+
+	*new_ts = start_ts;
+	return true;
+}
+
+static void output_callback(void *param, size_t mix_idx, struct audio_data *data)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(mix_idx);
+
+	/* inputs with the same conversion must get the same resampled data */
+	if (!tick_data)
+		tick_data = data->data[0];
+	else if (tick_data != data->data[0])
+		os_atomic_inc_long(&mismatches);
+
+	if (++tick_calls == num_inputs && measured_ticks < BENCH_TICKS) {
+		total_ns += os_gettime_ns() - tick_start;
+		if (++measured_ticks == BENCH_TICKS)
+			os_event_signal(done_event);
+	}
+}
+
+static bool impulse_input_callback(void *param, uint64_t start_ts, uint64_t end_ts, uint64_t *new_ts,
+				   uint32_t active_mixers, struct audio_output_data *mixes)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(end_ts);
+	UNUSED_PARAMETER(active_mixers);
+
+	/* mix buffers are cleared before every tick */
+	if (os_atomic_exchange_bool(&impulse_pending, false))
+		mixes[0].data[0][0] = 1.0f;
+
+	*new_ts = start_ts;
+	return true;
+}
+
+static void impulse_output_callback(void *param, size_t mix_idx, struct audio_data *data)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(mix_idx);
+
+	if (data->frames != block_frames)
+		os_atomic_inc_long(&block_mismatches);
+
+	if (((const float *)data->data[0])[0] != 0.0f) {
+		latency_ns += os_gettime_ns() - impulse_ts;
+		os_event_signal(impulse_event);
+	}
+}
+
+/* a device clock that runs fast or slow by clock_ppm, at the given system
+ * time */
+static uint64_t synthetic_clock_at(uint64_t ts)
+{
+	int64_t elapsed = (int64_t)(ts - clock_base);
+	return clock_base + (uint64_t)(elapsed + elapsed * clock_ppm / 1000000);
+}
+
+/* the audio thread wakes up to 2 ms late */
+static uint64_t wake_jitter(void)
+{
+	jitter_seed = jitter_seed * 1103515245 + 12345;
+	return (jitter_seed >> 16) % 2000000;
+}
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!obs_startup("en-US", NULL, NULL))
+		return -1;
+	if (os_event_init(&done_event, OS_EVENT_TYPE_AUTO) != 0)
+		return -1;
+	if (os_event_init(&impulse_event, OS_EVENT_TYPE_AUTO) != 0)
+		return -1;
+
+	struct audio_output_info info = {
+		.name = "test",
+		.samples_per_sec = 48000,
+		.format = AUDIO_FORMAT_FLOAT_PLANAR,
+		.speakers = SPEAKERS_STEREO,
+		.input_callback = input_callback,
+	};
+
+	return audio_output_open(&audio, &info) == AUDIO_OUTPUT_SUCCESS ? 0 : -1;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+	audio_output_close(audio);
+	os_event_destroy(done_event);
+	os_event_destroy(impulse_event);
+	obs_shutdown();
+	return 0;
+}
+
+/* average time from the start of a tick until the last input has been
+ * called, with the given number of inputs all resampling to 44.1khz */
+static uint64_t bench_inputs(size_t count)
+{
+	total_ns = 0;
+	measured_ticks = 0;
+	num_inputs = count;
+	os_event_reset(done_event);
+
+	for (size_t i = 0; i < count; i++)
+		assert_true(audio_output_connect(audio, 0, &conversion, output_callback, (void *)(uintptr_t)(i + 1)));
+
+	assert_int_equal(os_event_timedwait(done_event, 10000), 0);
+
+	for (size_t i = 0; i < count; i++)
+		audio_output_disconnect(audio, 0, output_callback, (void *)(uintptr_t)(i + 1));
+
+	return total_ns / BENCH_TICKS;
+}
+
+static void shared_resampler_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	os_atomic_set_long(&mismatches, 0);
+	bench_inputs(MAX_TEST_INPUTS);
+
+	assert_int_equal(os_atomic_load_long(&mismatches), 0);
+}
+
+static void inputs_benchmark(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	/* resampling happens once per tick no matter how many inputs there
+	 * are, so this should barely grow with the input count */
+	for (size_t count = 1; count <= MAX_TEST_INPUTS; count *= 2) {
+		uint64_t ns = bench_inputs(count);
+		print_message("audio tick, %zu inputs: %8llu us\n", count, (unsigned long long)(ns / 1000));
+	}
+}
+
+/* average time from an event arriving at the audio pipeline until it
+ * reaches an output, for the given block size */
+static uint64_t measure_latency(uint32_t frames)
+{
+	struct audio_output_info info = {
+		.name = "latency test",
+		.samples_per_sec = 48000,
+		.format = AUDIO_FORMAT_FLOAT_PLANAR,
+		.speakers = SPEAKERS_STEREO,
+		.input_callback = impulse_input_callback,
+		.output_frames = frames,
+	};
+	audio_t *latency_audio;
+
+	latency_ns = 0;
+	block_frames = frames;
+	os_atomic_set_long(&block_mismatches, 0);
+
+	assert_int_equal(audio_output_open(&latency_audio, &info), AUDIO_OUTPUT_SUCCESS);
+	assert_int_equal(audio_output_get_output_frames(latency_audio), frames);
+	assert_true(audio_output_connect(latency_audio, 0, NULL, impulse_output_callback, NULL));
+
+	for (size_t i = 0; i < LATENCY_EVENTS; i++) {
+		/* spread the events out so they don't line up with ticks */
+		os_sleep_ms(3 + (uint32_t)i);
+
+		impulse_ts = os_gettime_ns();
+		os_atomic_set_bool(&impulse_pending, true);
+		assert_int_equal(os_event_timedwait(impulse_event, 1000), 0);
+	}
+
+	audio_output_disconnect(latency_audio, 0, impulse_output_callback, NULL);
+	audio_output_close(latency_audio);
+
+	assert_int_equal(os_atomic_load_long(&block_mismatches), 0);
+	return latency_ns / LATENCY_EVENTS;
+}
+
+static void block_size_latency_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	static const uint32_t sizes[] = {AUDIO_OUTPUT_FRAMES, 256, 128};
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		uint64_t ns = measure_latency(sizes[i]);
+		uint64_t block_ns = audio_frames_to_ns(48000, sizes[i]);
+
+		print_message("block size %4u: %6llu us input to output latency\n", sizes[i],
+			      (unsigned long long)(ns / 1000));
+
+		/* events wait half a block for the next tick on average, and
+		 * are output within it.  the slack covers scheduling delays on
+		 * a loaded machine, the sizes are only compared by eye */
+		assert_true(ns < 2 * block_ns + LATENCY_SLACK_NS);
+	}
+}
+
+/* how far the produced audio drifts from a device clock that is off by the
+ * given ppm.  the follower runs on simulated time, so no real time passes
+ * and the result doesn't depend on how busy the machine is */
+static int64_t measure_clock_drift(int64_t ppm, double *ratio)
+{
+	const uint64_t ticks_per_sec = 48000 / AUDIO_OUTPUT_FRAMES;
+	struct clock_follower follower = {0};
+	uint64_t prev_time = clock_base;
+	uint64_t clock0 = 0;
+
+	clock_ppm = ppm;
+
+	for (uint64_t tick = 1; tick <= ticks_per_sec * CLOCK_TEST_SECONDS * 2; tick++) {
+		/* the clock is read when the thread wakes up, and wound back
+		 * to the end of the last tick */
+		uint64_t now = prev_time + wake_jitter();
+		uint64_t clock_time = synthetic_clock_at(now) - (now - prev_time);
+
+		prev_time = clock_follower_tick(&follower, clock_time, prev_time, AUDIO_OUTPUT_FRAMES, 48000);
+		assert_false(follower.resynced);
+
+		/* let the clock follower lock on first */
+		if (tick == ticks_per_sec * CLOCK_TEST_SECONDS)
+			clock0 = synthetic_clock_at(prev_time);
+	}
+
+	*ratio = clock_follower_ratio(&follower, AUDIO_OUTPUT_FRAMES, 48000);
+
+	int64_t clock_elapsed = (int64_t)(synthetic_clock_at(prev_time) - clock0);
+	int64_t audio_elapsed =
+		(int64_t)audio_frames_to_ns(48000, ticks_per_sec * CLOCK_TEST_SECONDS * AUDIO_OUTPUT_FRAMES);
+	return audio_elapsed - clock_elapsed;
+}
+
+static void clock_drift_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	static const int64_t ppms[] = {5000, -5000};
+
+	for (size_t i = 0; i < sizeof(ppms) / sizeof(ppms[0]); i++) {
+		double ratio;
+		int64_t drift = measure_clock_drift(ppms[i], &ratio);
+
+		print_message("clock %+5lld ppm: ratio %.6f, %+.3f ms drift over %d s (%+.3f ms free running)\n",
+			      (long long)ppms[i], ratio, (double)drift / 1000000.0, CLOCK_TEST_SECONDS,
+			      -(double)ppms[i] * CLOCK_TEST_SECONDS / 1000.0);
+
+		/* free running, the audio would be off by 100 ms */
+		assert_true(llabs(drift) < 100000);
+		assert_true(fabs(ratio - (1.0 + (double)ppms[i] / 1000000.0)) < 0.00001);
+	}
+}
+
+/* compensation stretches the output of a resampler that doesn't otherwise
+ * change the sample rate */
+static void resampler_compensation_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	struct resample_info info = {
+		.samples_per_sec = 48000,
+		.format = AUDIO_FORMAT_FLOAT_PLANAR,
+		.speakers = SPEAKERS_STEREO,
+	};
+	static float input_data[2][AUDIO_OUTPUT_FRAMES];
+	const uint8_t *input[MAX_AV_PLANES] = {(const uint8_t *)input_data[0], (const uint8_t *)input_data[1]};
+	uint64_t in_frames = 0;
+	uint64_t out_frames = 0;
+
+	audio_resampler_t *resampler = audio_resampler_create(&info, &info);
+	assert_non_null(resampler);
+
+	/* ten seconds of audio */
+	for (size_t i = 0; i < 480; i++) {
+		uint8_t *output[MAX_AV_PLANES];
+		uint32_t frames;
+		uint64_t offset;
+
+		assert_true(audio_resampler_set_compensation(resampler, 1.001));
+		assert_true(audio_resampler_resample(resampler, output, &frames, &offset, input, AUDIO_OUTPUT_FRAMES));
+
+		in_frames += AUDIO_OUTPUT_FRAMES;
+		out_frames += frames;
+	}
+
+	audio_resampler_destroy(resampler);
+
+	double ratio = (double)out_frames / (double)in_frames;
+	assert_true(fabs(ratio - 1.001) < 0.0001);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(shared_resampler_test),
+		cmocka_unit_test(inputs_benchmark),
+		cmocka_unit_test(block_size_latency_test),
+		cmocka_unit_test(clock_drift_test),
+		cmocka_unit_test(resampler_compensation_test),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
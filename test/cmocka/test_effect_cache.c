@@ -0,0 +1,131 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <util/platform.h>
+#include <graphics/effect-parser.h>
+
+#define BENCH_ITERATIONS 50
+
+static char *effect_string = NULL;
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+	effect_string = os_quick_read_utf8_file(TEST_EFFECT_PATH);
+	return effect_string ? 0 : -1;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+	gs_effect_set_cache_path(NULL);
+	bfree(effect_string);
+	return 0;
+}
+
+static void build_effect(struct effect_parser *ep)
+{
+	ep_init(ep);
+	assert_true(ep_build(ep, effect_string, TEST_EFFECT_PATH, "_OPENGL"));
+}
+
+static uint64_t bench_build(void)
+{
+	uint64_t start = os_gettime_ns();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++) {
+		struct effect_parser ep;
+		build_effect(&ep);
+		ep_free(&ep);
+	}
+
+	return (os_gettime_ns() - start) / BENCH_ITERATIONS;
+}
+
+static void assert_passes_equal(struct ep_pass *a, struct ep_pass *b)
+{
+	assert_string_equal(a->name ? a->name : "", b->name ? b->name : "");
+	assert_int_equal(a->vertex_shader.len, b->vertex_shader.len);
+	assert_int_equal(a->pixel_shader.len, b->pixel_shader.len);
+	if (a->vertex_shader.len)
+		assert_string_equal(a->vertex_shader.array, b->vertex_shader.array);
+	if (a->pixel_shader.len)
+		assert_string_equal(a->pixel_shader.array, b->pixel_shader.array);
+
+	assert_int_equal(a->vertex_params.num, b->vertex_params.num);
+	for (size_t i = 0; i < a->vertex_params.num; i++)
+		assert_string_equal(a->vertex_params.array[i].array, b->vertex_params.array[i].array);
+
+	assert_int_equal(a->pixel_params.num, b->pixel_params.num);
+	for (size_t i = 0; i < a->pixel_params.num; i++)
+		assert_string_equal(a->pixel_params.array[i].array, b->pixel_params.array[i].array);
+}
+
+static void cached_matches_parsed_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+	struct effect_parser parsed;
+	struct effect_parser cached;
+
+	gs_effect_set_cache_path(NULL);
+	build_effect(&parsed);
+
+	/* first build populates the cache, second one must come from it */
+	gs_effect_set_cache_path(TEST_EFFECT_CACHE_DIR);
+	build_effect(&cached);
+	ep_free(&cached);
+	build_effect(&cached);
+
+	assert_null(cached.cfp.cur_token);
+	assert_int_equal(parsed.params.num, cached.params.num);
+	for (size_t i = 0; i < parsed.params.num; i++) {
+		struct ep_param *a = parsed.params.array + i;
+		struct ep_param *b = cached.params.array + i;
+
+		assert_string_equal(a->name, b->name);
+		assert_string_equal(a->type, b->type);
+		assert_int_equal(a->default_val.num, b->default_val.num);
+		assert_int_equal(a->annotations.num, b->annotations.num);
+	}
+
+	assert_int_equal(parsed.techniques.num, cached.techniques.num);
+	for (size_t i = 0; i < parsed.techniques.num; i++) {
+		struct ep_technique *a = parsed.techniques.array + i;
+		struct ep_technique *b = cached.techniques.array + i;
+
+		assert_string_equal(a->name, b->name);
+		assert_int_equal(a->passes.num, b->passes.num);
+		for (size_t j = 0; j < a->passes.num; j++)
+			assert_passes_equal(a->passes.array + j, b->passes.array + j);
+	}
+
+	ep_free(&parsed);
+	ep_free(&cached);
+}
+
+static void cold_vs_cached_benchmark(void **state)
+{
+	UNUSED_PARAMETER(state);
+	uint64_t cold_ns, cached_ns;
+
+	gs_effect_set_cache_path(NULL);
+	cold_ns = bench_build();
+
+	gs_effect_set_cache_path(TEST_EFFECT_CACHE_DIR);
+	cached_ns = bench_build();
+
+	print_message("effect build, cold:   %8llu us\n", (unsigned long long)(cold_ns / 1000));
+	print_message("effect build, cached: %8llu us\n", (unsigned long long)(cached_ns / 1000));
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(cached_matches_parsed_test),
+		cmocka_unit_test(cold_vs_cached_benchmark),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}
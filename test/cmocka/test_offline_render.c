@@ -0,0 +1,187 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <obs.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#define BENCH_FRAMES 600
+#define FPS 60
+
+static bool have_video = false;
+static os_event_t *done_event = NULL;
+
+/* only touched by the video-io and audio-io threads while connected */
+static long frames_received = 0;
+static long frame_gaps = 0;
+static uint64_t last_video_ts = 0;
+static uint64_t last_audio_ts = 0;
+static long audio_gaps = 0;
+static uint64_t audio_frames = 0;
+
+static void raw_video_callback(void *param, struct video_data *frame)
+{
+	UNUSED_PARAMETER(param);
+
+	if (frames_received == BENCH_FRAMES)
+		return;
+
+	/* nothing may be dropped or repeated on the virtual clock */
+	if (last_video_ts && frame->timestamp - last_video_ts != obs_get_frame_interval_ns())
+		frame_gaps++;
+	last_video_ts = frame->timestamp;
+
+	if (++frames_received == BENCH_FRAMES)
+		os_event_signal(done_event);
+}
+
+static void raw_audio_callback(void *param, size_t mix_idx, struct audio_data *data)
+{
+	UNUSED_PARAMETER(param);
+	UNUSED_PARAMETER(mix_idx);
+
+	if (last_audio_ts && data->timestamp <= last_audio_ts)
+		audio_gaps++;
+	last_audio_ts = data->timestamp;
+	audio_frames += data->frames;
+}
+
+static int setup(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!obs_startup("en-US", NULL, NULL))
+		return -1;
+	if (os_event_init(&done_event, OS_EVENT_TYPE_AUTO) != 0)
+		return -1;
+
+	struct obs_audio_info2 oai = {
+		.samples_per_sec = 48000,
+		.speakers = SPEAKERS_STEREO,
+	};
+	if (!obs_reset_audio2(&oai))
+		return -1;
+	if (!obs_set_offline_rendering(true))
+		return -1;
+
+	struct obs_video_info ovi = {
+		.graphics_module = "libobs-opengl",
+		.fps_num = FPS,
+		.fps_den = 1,
+		.base_width = 1280,
+		.base_height = 720,
+		.output_width = 1280,
+		.output_height = 720,
+		.output_format = VIDEO_FORMAT_NV12,
+		.gpu_conversion = true,
+		.colorspace = VIDEO_CS_709,
+		.range = VIDEO_RANGE_PARTIAL,
+		.scale_type = OBS_SCALE_BICUBIC,
+	};
+
+	/* there may not be a graphics device to render with, in which case
+	 * the tests are skipped */
+	have_video = obs_reset_video(&ovi) == OBS_VIDEO_SUCCESS;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	UNUSED_PARAMETER(state);
+	obs_shutdown();
+	os_event_destroy(done_event);
+	return 0;
+}
+
+static void offline_render_benchmark(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!have_video)
+		skip();
+
+	struct video_scale_info conversion = {
+		.format = VIDEO_FORMAT_NV12,
+		.width = 1280,
+		.height = 720,
+	};
+
+	uint64_t start = os_gettime_ns();
+
+	obs_add_raw_video_callback(&conversion, raw_video_callback, NULL);
+	obs_add_raw_audio_callback(0, NULL, raw_audio_callback, NULL);
+
+	assert_int_equal(os_event_timedwait(done_event, 60000), 0);
+	uint64_t elapsed = os_gettime_ns() - start;
+
+	obs_remove_raw_video_callback(raw_video_callback, NULL);
+	obs_remove_raw_audio_callback(0, raw_audio_callback, NULL);
+
+	assert_int_equal(frame_gaps, 0);
+	assert_int_equal(audio_gaps, 0);
+	assert_true(audio_frames > 0);
+
+	double fps = (double)BENCH_FRAMES / ((double)elapsed / 1000000000.0);
+	print_message("offline rendering: %d frames at %.1f fps (%.1fx real time), %.2f s of audio\n", BENCH_FRAMES,
+		      fps, fps / FPS, (double)audio_frames / 48000.0);
+}
+
+/* a 25 fps view next to the 60 fps main video only renders on its own
+ * ticks, which on the virtual clock never lag */
+static void multi_rate_view_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	if (!have_video)
+		skip();
+
+	struct obs_video_info ovi;
+	assert_true(obs_get_video_info(&ovi));
+	ovi.fps_num = 25;
+	ovi.fps_den = 1;
+	ovi.base_width = 720;
+	ovi.base_height = 1280;
+	ovi.output_width = 720;
+	ovi.output_height = 1280;
+
+	obs_view_t *view = obs_view_create();
+	assert_non_null(obs_view_add2(view, &ovi));
+
+	/* wait for the view to render its first frame */
+	uint64_t timeout = os_gettime_ns() + 10000000000ULL;
+	while (!obs_view_get_total_frames(view) && os_gettime_ns() < timeout)
+		os_sleep_ms(1);
+
+	uint32_t main_start = obs_get_total_frames();
+	uint32_t view_start = obs_view_get_total_frames(view);
+
+	while (obs_get_total_frames() - main_start < BENCH_FRAMES && os_gettime_ns() < timeout)
+		os_sleep_ms(1);
+
+	uint32_t main_frames = obs_get_total_frames() - main_start;
+	uint32_t view_frames = obs_view_get_total_frames(view) - view_start;
+	uint32_t view_lagged = obs_view_get_lagged_frames(view);
+	uint32_t expected = main_frames * 25 / FPS;
+
+	obs_view_remove(view);
+	obs_view_destroy(view);
+
+	assert_true(main_frames >= BENCH_FRAMES);
+	assert_in_range(view_frames, expected - 2, expected + 2);
+	assert_int_equal(view_lagged, 0);
+
+	print_message("multi rate: %u main frames at %d fps, %u view frames at 25 fps\n", main_frames, FPS,
+		      view_frames);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(offline_render_benchmark),
+		cmocka_unit_test(multi_rate_view_test),
+	};
+
+	return cmocka_run_group_tests(tests, setup, teardown);
+}